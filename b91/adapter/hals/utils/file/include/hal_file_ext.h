@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HAL_FILE_EXT_H
+#define HAL_FILE_EXT_H
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
+/**
+ * Reads len bytes at offset of the file, the file position set by HalFileSeek is not changed.
+ * Returns the number of bytes read, or -1 if fd is invalid or offset is beyond the end of file.
+ */
+int HalFilePread(int fd, char *buf, unsigned int len, unsigned int offset);
+
+/**
+ * Writes len bytes at offset of the file, the file position set by HalFileSeek is not changed.
+ * Files opened with O_APPEND_FS are always written at the end.
+ * Returns the number of bytes written, or -1 if fd is invalid or offset is beyond the end of file.
+ */
+int HalFilePwrite(int fd, const char *buf, unsigned int len, unsigned int offset);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+#endif /* HAL_FILE_EXT_H */
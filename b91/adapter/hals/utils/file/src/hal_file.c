@@ -20,6 +20,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -31,6 +32,7 @@
 #include <hiview_log.h>
 
 #include <hal_file.h>
+#include <hal_file_ext.h>
 #include <utils_file.h>
 
 #define RD_WR_FIELD_MASK      0x000f
@@ -43,30 +45,154 @@
 #define ROOT_PATH         "/data"
 #define DIR_SEPARATOR     "/"
 
-#define SLOT_AVAILABLE -1
+#define SLOT_AVAILABLE 0
+#define SLOT_RESERVED  1
+#define SLOT_OPEN      2
 
 #define HAL_ERROR -1
 
-static int FileHandlerArray[MAX_OPEN_FILE_NUM] = {
-    SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE,
-    SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE,
-    SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE,
-    SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE,
-    SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE, SLOT_AVAILABLE,
+/* per handle cache, pos is the HAL position, os_pos the position of the underlying fd.
+ * They only differ after a seek or positional access, lseek is issued lazily on the next read/write.
+ * size is what this handle last saw; another handle may grow the file, so the size is re-read
+ * with fstat for SEEK_END, append writes and whenever an offset lies past the cached size.
+ * state is claimed with CAS (SLOT_AVAILABLE -> SLOT_RESERVED -> SLOT_OPEN), the other fields are
+ * protected by the per slot lock so that different handles are accessed in parallel. */
+typedef struct {
+    int state;
+    int fd;
+    pthread_mutex_t lock;
+    int pos;
+    int os_pos;
+    int size;
+    bool append;
+} FileHandler;
+
+static FileHandler FileHandlerArray[MAX_OPEN_FILE_NUM] = {
+    [0 ... MAX_OPEN_FILE_NUM - 1] = { .state = SLOT_AVAILABLE, .lock = PTHREAD_MUTEX_INITIALIZER },
 };
 
-static int GetAvailableFileHandlerIndex(void)
+static int ReserveFileHandlerIndex(void)
 {
     int i = MAX_OPEN_FILE_NUM;
+    int expected;
 
     for (; i > 0; i--) {
-        if (FileHandlerArray[i - 1] == SLOT_AVAILABLE) {
+        expected = SLOT_AVAILABLE;
+        if (__atomic_compare_exchange_n(&FileHandlerArray[i - 1].state, &expected, SLOT_RESERVED, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
             break;
         }
     }
 
     return i;
 }
+
+static FileHandler *LockFileHandler(int fd)
+{
+    FileHandler *handler;
+
+    /* make sure fd is within the allowed range, which is 1 to MAX_OPEN_FILE_NUM */
+    if ((fd > MAX_OPEN_FILE_NUM) || (fd <= 0)) {
+        return NULL;
+    }
+
+    handler = &FileHandlerArray[fd - 1];
+    if (__atomic_load_n(&handler->state, __ATOMIC_ACQUIRE) != SLOT_OPEN) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&handler->lock);
+    /* closed while waiting for the lock, the slot may already be reserved again */
+    if (__atomic_load_n(&handler->state, __ATOMIC_RELAXED) != SLOT_OPEN) {
+        pthread_mutex_unlock(&handler->lock);
+        return NULL;
+    }
+
+    return handler;
+}
+
+static void UnlockFileHandler(FileHandler *handler)
+{
+    pthread_mutex_unlock(&handler->lock);
+}
+
+static int SyncPosition(FileHandler *handler, int pos)
+{
+    if (handler->os_pos != pos) {
+        if (lseek(handler->fd, pos, SEEK_SET) != pos) {
+            handler->os_pos = -1;
+            return HAL_ERROR;
+        }
+        handler->os_pos = pos;
+    }
+
+    return 0;
+}
+
+static int RefreshSize(FileHandler *handler)
+{
+    struct stat f_info;
+
+    if (fstat(handler->fd, &f_info) != 0) {
+        return HAL_ERROR;
+    }
+    handler->size = f_info.st_size;
+
+    return 0;
+}
+
+/* true when offset is within the file, the cached size is refreshed before rejecting it */
+static bool OffsetInFile(FileHandler *handler, unsigned int offset)
+{
+    if (offset <= (unsigned int)handler->size) {
+        return true;
+    }
+
+    return (RefreshSize(handler) == 0) && (offset <= (unsigned int)handler->size);
+}
+
+static int ReadAt(FileHandler *handler, char *buf, unsigned int len, int pos)
+{
+    int ret;
+
+    if (SyncPosition(handler, pos) != 0) {
+        return HAL_ERROR;
+    }
+
+    ret = read(handler->fd, buf, len);
+    if (ret > 0) {
+        handler->os_pos += ret;
+    }
+
+    return ret;
+}
+
+static int WriteAt(FileHandler *handler, const char *buf, unsigned int len, int pos)
+{
+    int ret;
+
+    if (handler->append) {
+        if (RefreshSize(handler) != 0) {
+            return HAL_ERROR;
+        }
+        pos = handler->size;
+    } else if (SyncPosition(handler, pos) != 0) {
+        return HAL_ERROR;
+    }
+
+    ret = write(handler->fd, buf, len);
+    if (ret > 0) {
+        handler->os_pos = pos + ret;
+        if (handler->os_pos > handler->size) {
+            handler->size = handler->os_pos;
+        }
+    } else if (handler->append) {
+        handler->os_pos = -1;
+    }
+
+    return ret;
+}
+
 static int ConvertFlags(int oflag)
 {
     int ret = 0;
@@ -131,9 +257,11 @@ int HalFileOpen(const char *path, int oflag, int mode)
 {
     int index;
     int fd;
+    int flags;
     char *file_path;
+    struct stat f_info;
 
-    index = GetAvailableFileHandlerIndex();
+    index = ReserveFileHandlerIndex();
     if (index == 0) {
         HILOG_ERROR(HILOG_MODULE_HIVIEW, "no space available!");
         return HAL_ERROR;
@@ -141,59 +269,132 @@ int HalFileOpen(const char *path, int oflag, int mode)
 
     file_path = GetActualFilePath(path);
     if (file_path == NULL) {
+        __atomic_store_n(&FileHandlerArray[index - 1].state, SLOT_AVAILABLE, __ATOMIC_RELEASE);
         return HAL_ERROR;
     }
 
-    fd = open(file_path, ConvertFlags(oflag));
+    flags = ConvertFlags(oflag);
+    fd = open(file_path, flags);
     if (fd < 0) {
         HILOG_ERROR(HILOG_MODULE_HIVIEW, "failed to open file : %d", errno);
         free(file_path);
+        __atomic_store_n(&FileHandlerArray[index - 1].state, SLOT_AVAILABLE, __ATOMIC_RELEASE);
         return HAL_ERROR;
     }
-
-    FileHandlerArray[index - 1] = fd;
     free(file_path);
 
+    /* seeks are checked against the cached size, see RefreshSize for when it is re-read */
+    if (fstat(fd, &f_info) != 0) {
+        close(fd);
+        __atomic_store_n(&FileHandlerArray[index - 1].state, SLOT_AVAILABLE, __ATOMIC_RELEASE);
+        return HAL_ERROR;
+    }
+
+    pthread_mutex_lock(&FileHandlerArray[index - 1].lock);
+    FileHandlerArray[index - 1].pos = 0;
+    FileHandlerArray[index - 1].os_pos = 0;
+    FileHandlerArray[index - 1].size = f_info.st_size;
+    FileHandlerArray[index - 1].append = ((flags & O_APPEND) != 0);
+    FileHandlerArray[index - 1].fd = fd;
+    __atomic_store_n(&FileHandlerArray[index - 1].state, SLOT_OPEN, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&FileHandlerArray[index - 1].lock);
+
     return index;
 }
 
 int HalFileClose(int fd)
 {
     int ret;
+    FileHandler *handler = LockFileHandler(fd);
 
-    /* make sure fd is within the allowed range, which is 1 to MAX_OPEN_FILE_NUM */
-    if ((fd > MAX_OPEN_FILE_NUM) || (fd <= 0)) {
+    if (handler == NULL) {
         return HAL_ERROR;
     }
 
-    ret = close(FileHandlerArray[fd - 1]);
+    ret = close(handler->fd);
     if (ret != 0) {
+        UnlockFileHandler(handler);
         return HAL_ERROR;
     }
 
-    FileHandlerArray[fd - 1] = SLOT_AVAILABLE;
+    __atomic_store_n(&handler->state, SLOT_AVAILABLE, __ATOMIC_RELEASE);
+    UnlockFileHandler(handler);
 
     return ret;
 }
 
 int HalFileRead(int fd, char *buf, unsigned int len)
 {
-    /* make sure fd is within the allowed range, which is 1 to MAX_OPEN_FILE_NUM */
-    if ((fd > MAX_OPEN_FILE_NUM) || (fd <= 0)) {
+    int ret;
+    FileHandler *handler = LockFileHandler(fd);
+
+    if (handler == NULL) {
         return HAL_ERROR;
     }
 
-    return read(FileHandlerArray[fd - 1], buf, len);
+    ret = ReadAt(handler, buf, len, handler->pos);
+    if (ret > 0) {
+        handler->pos += ret;
+    }
+    UnlockFileHandler(handler);
+
+    return ret;
 }
 
 int HalFileWrite(int fd, const char *buf, unsigned int len)
 {
-    /* make sure fd is within the allowed range, which is 1 to MAX_OPEN_FILE_NUM */
-    if ((fd > MAX_OPEN_FILE_NUM) || (fd <= 0)) {
+    int ret;
+    FileHandler *handler = LockFileHandler(fd);
+
+    if (handler == NULL) {
         return HAL_ERROR;
     }
 
-    return write(FileHandlerArray[fd - 1], buf, len);
+    ret = WriteAt(handler, buf, len, handler->pos);
+    if (ret > 0) {
+        handler->pos = handler->os_pos;
+    }
+    UnlockFileHandler(handler);
+
+    return ret;
+}
+
+int HalFilePread(int fd, char *buf, unsigned int len, unsigned int offset)
+{
+    int ret;
+    FileHandler *handler = LockFileHandler(fd);
+
+    if (handler == NULL) {
+        return HAL_ERROR;
+    }
+
+    if (!OffsetInFile(handler, offset)) {
+        ret = HAL_ERROR;
+    } else {
+        ret = ReadAt(handler, buf, len, offset);
+    }
+    UnlockFileHandler(handler);
+
+    return ret;
+}
+
+int HalFilePwrite(int fd, const char *buf, unsigned int len, unsigned int offset)
+{
+    int ret;
+    FileHandler *handler = LockFileHandler(fd);
+
+    if (handler == NULL) {
+        return HAL_ERROR;
+    }
+
+    if (!OffsetInFile(handler, offset)) {
+        ret = HAL_ERROR;
+    } else {
+        ret = WriteAt(handler, buf, len, offset);
+    }
+    UnlockFileHandler(handler);
+
+    return ret;
 }
 
 int HalFileDelete(const char *path)
@@ -232,29 +433,30 @@ int HalFileStat(const char *path, unsigned int *fileSize)
 
 int HalFileSeek(int fd, int offset, unsigned int whence)
 {
-    int ret = 0;
-    struct stat f_info;
-
-    /* make sure fd is within the allowed range, which is 1 to MAX_OPEN_FILE_NUM */
-    if ((fd > MAX_OPEN_FILE_NUM) || (fd <= 0)) {
-        return HAL_ERROR;
-    }
+    int pos;
+    FileHandler *handler = LockFileHandler(fd);
 
-    ret = fstat(FileHandlerArray[fd - 1], &f_info);
-    if (ret != 0) {
+    if (handler == NULL) {
         return HAL_ERROR;
     }
 
     if (whence == SEEK_SET_FS) {
-        if (offset > f_info.st_size) {
-            ret = HAL_ERROR;
-        }
+        pos = offset;
+    } else if (whence == SEEK_CUR_FS) {
+        pos = handler->pos + offset;
+    } else if (whence == SEEK_END_FS) {
+        pos = (RefreshSize(handler) == 0) ? (handler->size + offset) : HAL_ERROR;
+    } else {
+        pos = HAL_ERROR;
     }
 
-    ret = lseek(FileHandlerArray[fd - 1], offset, whence);
-    if ((ret > f_info.st_size) || (ret < 0)) {
-        return HAL_ERROR;
+    if ((pos < 0) || !OffsetInFile(handler, (unsigned int)pos)) {
+        pos = HAL_ERROR;
+    } else {
+        /* the underlying fd is moved by the next read or write */
+        handler->pos = pos;
     }
+    UnlockFileHandler(handler);
 
-    return ret;
+    return pos;
 }
@@ -34,7 +34,7 @@
  *                                              global variable                                                       *
  *********************************************************************************************************************/
 _attribute_aes_data_sec_ unsigned int aes_data_buff[8];
-unsigned int aes_base_addr = 0xc0000000;
+_attribute_data_retention_sec_ unsigned int aes_base_addr = 0xc0000000;
 /**********************************************************************************************************************
  *                                              local variable                                                     *
  *********************************************************************************************************************/
@@ -22,6 +22,13 @@
 #include "ext_misc.h"
 #include "ext_pm.h"
 #include "ext_rf.h"
+#include "flash_sfdp.h"
+#include "lpc_monitor.h"
+#include "pin_mux.h"
+#include "pm_retention.h"
+#include "pm_wakeup.h"
+#include "rc_32k_track.h"
 #include "software_pa.h"
+#include "xtal_32k_start.h"
 
 #endif /* DRIVERS_B91_EXT_DRIVER_DRIVER_EXT_H_ */
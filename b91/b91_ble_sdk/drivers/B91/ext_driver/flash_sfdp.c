@@ -0,0 +1,224 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+#include "flash_sfdp.h"
+#include "../flash.h"
+#include "compiler.h"
+#include <string.h>
+
+/**********************************************************************************************************************
+ *                                              local constants                                                       *
+ *********************************************************************************************************************/
+#define SFDP_BFPT_ID_LSB   0x00
+#define SFDP_BFPT_ID_MSB   0xFF
+#define SFDP_BFPT_MIN_DW   9   // JESD216: erase types are in dword 8/9
+#define SFDP_BFPT_TIME_DW  11  // JESD216A and later: erase/program times in dword 10/11
+#define SFDP_HDR_SIZE      8
+#define SFDP_PARAM_HDR_MAX 8
+
+static const unsigned int sfdp_erase_unit_us[4] = {1000, 16000, 128000, 1000000};
+static const unsigned int sfdp_chip_unit_us[4] = {16000, 256000, 4000000, 64000000};
+
+/**********************************************************************************************************************
+ *                                         local function implementation                                              *
+ *********************************************************************************************************************/
+static unsigned int sfdp_dword(const unsigned char *bfpt, unsigned int n)
+{
+    const unsigned char *p = bfpt + (n - 1) * 4;  // dwords are numbered from 1 in JESD216
+
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned int sfdp_field(unsigned int dw, unsigned int lsb, unsigned int bits)
+{
+    return (dw >> lsb) & ((1 << bits) - 1);
+}
+
+/* max = typ * 2 * (multiplier + 1), limited to 32 bits */
+static unsigned int sfdp_max_time(unsigned int typ, unsigned int mult)
+{
+    unsigned long long max = (unsigned long long)typ * 2 * (mult + 1);
+
+    return max > 0xffffffff ? 0xffffffff : (unsigned int)max;
+}
+
+static unsigned int sfdp_timeout(unsigned int max_us)
+{
+    return max_us > 0x7fffffff ? 0xffffffff : max_us * 2;
+}
+
+/**********************************************************************************************************************
+ *                                         global function implementation                                             *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to parse a Basic Flash Parameter Table.
+ * @param[in]  bfpt      - the table, little endian dwords as read from flash.
+ * @param[in]  dword_num - dwords in bfpt, at least 9.
+ * @param[out] info      - parameters, fields not in the table are 0.
+ * @return     0: success, -1: table too short or capacity invalid.
+ */
+int flash_sfdp_parse_bfpt(const unsigned char *bfpt, unsigned int dword_num, flash_sfdp_info_t *info)
+{
+    memset(info, 0, sizeof(flash_sfdp_info_t));
+
+    if (dword_num < SFDP_BFPT_MIN_DW) {
+        return -1;
+    }
+
+    unsigned int dw = sfdp_dword(bfpt, 1);
+    info->fast_read |= (dw & BIT(16)) ? FLASH_SFDP_READ_1_1_2 : 0;
+    info->fast_read |= (dw & BIT(20)) ? FLASH_SFDP_READ_1_2_2 : 0;
+    info->fast_read |= (dw & BIT(21)) ? FLASH_SFDP_READ_1_4_4 : 0;
+    info->fast_read |= (dw & BIT(22)) ? FLASH_SFDP_READ_1_1_4 : 0;
+
+    // density in bits: N + 1, or 2^N when bit 31 is set
+    dw = sfdp_dword(bfpt, 2);
+    if (dw & 0x80000000) {
+        unsigned int n = dw & 0x7fffffff;
+        if (n < 3 || n > 34) {
+            return -1;
+        }
+        info->capacity = 1u << (n - 3);
+    } else {
+        info->capacity = (dw + 1) / 8;
+    }
+    if (!info->capacity) {
+        return -1;
+    }
+
+    // erase types 1~4: size exponent and opcode
+    for (unsigned int i = 0; i < FLASH_SFDP_ERASE_TYPE_NUM; i++) {
+        dw = sfdp_dword(bfpt, 8 + i / 2);
+        unsigned int n = sfdp_field(dw, (i & 1) * 16, 8);
+        if (n && n < 32) {
+            info->erase[i].size = 1u << n;
+            info->erase[i].cmd = sfdp_field(dw, (i & 1) * 16 + 8, 8);
+        }
+    }
+
+    info->page_size = PAGE_SIZE;
+    if (dword_num < SFDP_BFPT_TIME_DW) {
+        return 0;  // JESD216 rev 0 has no timing
+    }
+
+    // dword 10: erase multiplier and typical erase times (5 bits count, 2 bits unit per type)
+    dw = sfdp_dword(bfpt, 10);
+    unsigned int erase_mult = sfdp_field(dw, 0, 4);
+    for (unsigned int i = 0; i < FLASH_SFDP_ERASE_TYPE_NUM; i++) {
+        if (info->erase[i].size) {
+            unsigned int count = sfdp_field(dw, 4 + i * 7, 5);
+            unsigned int unit = sfdp_field(dw, 9 + i * 7, 2);
+            info->erase[i].typ_us = (count + 1) * sfdp_erase_unit_us[unit];
+            info->erase[i].max_us = sfdp_max_time(info->erase[i].typ_us, erase_mult);
+        }
+    }
+
+    // dword 11: program multiplier, page size, page program and chip erase typical times
+    dw = sfdp_dword(bfpt, 11);
+    info->page_size = 1u << sfdp_field(dw, 4, 4);
+    info->program_typ_us = (sfdp_field(dw, 8, 5) + 1) * (sfdp_field(dw, 13, 1) ? 64 : 8);
+    info->program_max_us = sfdp_max_time(info->program_typ_us, sfdp_field(dw, 0, 4));
+    info->chip_erase_typ_us = (sfdp_field(dw, 24, 5) + 1) * sfdp_chip_unit_us[sfdp_field(dw, 29, 2)];
+    info->chip_erase_max_us = sfdp_max_time(info->chip_erase_typ_us, erase_mult);
+
+    return 0;
+}
+
+/**
+ * @brief      This function serves to read the SFDP header and Basic Flash Parameter Table of the flash,
+ *             parse it and set the flash busy timeouts to twice the max times found.
+ * @param[out] info - parameters.
+ * @return     0: success, -1: no SFDP or no valid Basic Flash Parameter Table.
+ */
+int flash_sfdp_init(flash_sfdp_info_t *info)
+{
+    unsigned char hdr[SFDP_HDR_SIZE];
+    unsigned char bfpt[FLASH_SFDP_BFPT_DWORD_MAX * 4];
+    unsigned int ptr = 0;
+    unsigned int dword_num = 0;
+    unsigned char rev_major = 0;
+    unsigned char rev_minor = 0;
+
+    flash_read_sfdp(0, SFDP_HDR_SIZE, hdr);
+    if ((hdr[0] | (hdr[1] << 8) | (hdr[2] << 16) | ((unsigned int)hdr[3] << 24)) != FLASH_SFDP_SIGNATURE) {
+        return -1;
+    }
+
+    // take the newest Basic Flash Parameter Table, parameter headers follow the SFDP header
+    unsigned int nph = hdr[6] + 1;
+    if (nph > SFDP_PARAM_HDR_MAX) {
+        nph = SFDP_PARAM_HDR_MAX;
+    }
+    for (unsigned int i = 0; i < nph; i++) {
+        unsigned char ph[SFDP_HDR_SIZE];
+        flash_read_sfdp(SFDP_HDR_SIZE * (i + 1), SFDP_HDR_SIZE, ph);
+        if (ph[0] != SFDP_BFPT_ID_LSB || ph[7] != SFDP_BFPT_ID_MSB) {
+            continue;
+        }
+        if (dword_num && (ph[2] < rev_major || (ph[2] == rev_major && ph[1] <= rev_minor))) {
+            continue;
+        }
+        rev_major = ph[2];
+        rev_minor = ph[1];
+        dword_num = ph[3];
+        ptr = ph[4] | (ph[5] << 8) | (ph[6] << 16);
+    }
+    if (!dword_num) {
+        return -1;
+    }
+
+    if (dword_num > FLASH_SFDP_BFPT_DWORD_MAX) {
+        dword_num = FLASH_SFDP_BFPT_DWORD_MAX;
+    }
+    flash_read_sfdp(ptr, dword_num * 4, bfpt);
+    if (flash_sfdp_parse_bfpt(bfpt, dword_num, info)) {
+        return -1;
+    }
+    info->rev_major = rev_major;
+    info->rev_minor = rev_minor;
+
+    flash_timeout_t timeout = {0};
+    for (unsigned int i = 0; i < FLASH_SFDP_ERASE_TYPE_NUM; i++) {
+        if (info->erase[i].size == FLASH_SECTOR_SIZE) {
+            timeout.sector_erase = sfdp_timeout(info->erase[i].max_us);
+        } else if (info->erase[i].size == FLASH_32KBLK_SIZE) {
+            timeout.block32k_erase = sfdp_timeout(info->erase[i].max_us);
+        } else if (info->erase[i].size == FLASH_64KBLK_SIZE) {
+            timeout.block64k_erase = sfdp_timeout(info->erase[i].max_us);
+        }
+    }
+    timeout.page_program = sfdp_timeout(info->program_max_us);
+    timeout.chip_erase = sfdp_timeout(info->chip_erase_max_us);
+    flash_set_timeout(&timeout);
+
+    return 0;
+}
+
+/**
+ * @brief      This function serves to convert a capacity in bytes to the code used by flash_set_capacity.
+ * @param[in]  capacity - bytes.
+ * @return     flash_capacity_e value, 0 if capacity is not a power of 2 in 64K ~ 8M.
+ */
+unsigned char flash_sfdp_capacity_code(unsigned int capacity)
+{
+    for (unsigned char code = FLASH_SIZE_64K; code <= FLASH_SIZE_8M; code++) {
+        if (capacity == (1u << code)) {
+            return code;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+/**	@page FLASH_SFDP
+ *
+ *	Introduction
+ *	===============
+ *	Most SPI NOR flashes describe themselves in the SFDP area (JESD216) which is read with
+ *	command 0x5A. The Basic Flash Parameter Table gives the capacity, the erase types with
+ *	their opcodes and sizes, the typical and max erase/program times and the fast read modes.
+ *	flash_sfdp_init parses it at boot and sets the flash busy timeouts from the max times,
+ *	so the driver does not depend on a table of known flash models for them.
+ *
+ *	API Reference
+ *	===============
+ *	Header File: flash_sfdp.h
+ */
+#ifndef DRIVERS_B91_EXT_DRIVER_FLASH_SFDP_H_
+#define DRIVERS_B91_EXT_DRIVER_FLASH_SFDP_H_
+
+#define FLASH_SFDP_SIGNATURE      0x50444653  // "SFDP"
+#define FLASH_SFDP_BFPT_DWORD_MAX 16          // JESD216 rev B/C/D use 16 dwords, the rest is not needed here
+#define FLASH_SFDP_ERASE_TYPE_NUM 4
+
+/**
+ * @brief	fast read modes, (command-address-data) lines
+ */
+#define FLASH_SFDP_READ_1_1_2 BIT(0)
+#define FLASH_SFDP_READ_1_2_2 BIT(1)
+#define FLASH_SFDP_READ_1_1_4 BIT(2)
+#define FLASH_SFDP_READ_1_4_4 BIT(3)
+
+/**
+ * @brief	erase type of the Basic Flash Parameter Table
+ */
+typedef struct {
+    unsigned int size;    // bytes, 0: not supported
+    unsigned int typ_us;  // 0: unknown
+    unsigned int max_us;  // 0: unknown
+    unsigned char cmd;
+} flash_sfdp_erase_t;
+
+/**
+ * @brief	parameters from the Basic Flash Parameter Table
+ */
+typedef struct {
+    unsigned int capacity;  // bytes
+    unsigned int page_size;
+    unsigned int program_typ_us;  // page program, 0: unknown
+    unsigned int program_max_us;
+    unsigned int chip_erase_typ_us;
+    unsigned int chip_erase_max_us;
+    flash_sfdp_erase_t erase[FLASH_SFDP_ERASE_TYPE_NUM];
+    unsigned char fast_read;  // FLASH_SFDP_READ_xxx
+    unsigned char rev_major;
+    unsigned char rev_minor;
+} flash_sfdp_info_t;
+
+/**
+ * @brief      This function serves to parse a Basic Flash Parameter Table.
+ * @param[in]  bfpt      - the table, little endian dwords as read from flash.
+ * @param[in]  dword_num - dwords in bfpt, at least 9.
+ * @param[out] info      - parameters, fields not in the table are 0.
+ * @return     0: success, -1: table too short or capacity invalid.
+ */
+int flash_sfdp_parse_bfpt(const unsigned char *bfpt, unsigned int dword_num, flash_sfdp_info_t *info);
+
+/**
+ * @brief      This function serves to read the SFDP header and Basic Flash Parameter Table of the flash,
+ *             parse it and set the flash busy timeouts to twice the max times found.
+ * @param[out] info - parameters.
+ * @return     0: success, -1: no SFDP or no valid Basic Flash Parameter Table.
+ */
+int flash_sfdp_init(flash_sfdp_info_t *info);
+
+/**
+ * @brief      This function serves to convert a capacity in bytes to the code used by flash_set_capacity.
+ * @param[in]  capacity - bytes.
+ * @return     flash_capacity_e value, 0 if capacity is not a power of 2 in 64K ~ 8M.
+ */
+unsigned char flash_sfdp_capacity_code(unsigned int capacity);
+
+#endif /* DRIVERS_B91_EXT_DRIVER_FLASH_SFDP_H_ */
@@ -0,0 +1,196 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+#include "lpc_monitor.h"
+#include "../pm.h"
+#include "pm_wakeup.h"
+#include "../stimer.h"
+
+/**********************************************************************************************************************
+ *                                              local data type                                                     *
+ *********************************************************************************************************************/
+typedef struct {
+    unsigned short mv;  // input level at which Vin * scaling = Vref
+    unsigned char ref;
+    unsigned char scaling;
+} lpc_level_t;
+
+typedef struct {
+    lpc_monitor_cb_t cb;
+    unsigned char low;    // level index of the low threshold
+    unsigned char high;   // level index of the high threshold
+    unsigned char below;  // 1: input below the low threshold, the high threshold is armed
+    unsigned char active;
+} lpc_monitor_t;
+
+/**********************************************************************************************************************
+ *                                              local variable                                                     *
+ *********************************************************************************************************************/
+/* reference / scaling, ascending */
+static const lpc_level_t lpc_level[LPC_MONITOR_LEVEL_NUM] = {
+    {820, LPC_REF_820MV, LPC_SCALING_PER100},  {872, LPC_REF_872MV, LPC_SCALING_PER100},
+    {923, LPC_REF_923MV, LPC_SCALING_PER100},  {974, LPC_REF_974MV, LPC_SCALING_PER100},
+    {1093, LPC_REF_820MV, LPC_SCALING_PER75},  {1162, LPC_REF_872MV, LPC_SCALING_PER75},
+    {1230, LPC_REF_923MV, LPC_SCALING_PER75},  {1298, LPC_REF_974MV, LPC_SCALING_PER75},
+    {1640, LPC_REF_820MV, LPC_SCALING_PER50},  {1744, LPC_REF_872MV, LPC_SCALING_PER50},
+    {1846, LPC_REF_923MV, LPC_SCALING_PER50},  {1948, LPC_REF_974MV, LPC_SCALING_PER50},
+    {3280, LPC_REF_820MV, LPC_SCALING_PER25},  {3488, LPC_REF_872MV, LPC_SCALING_PER25},
+    {3692, LPC_REF_923MV, LPC_SCALING_PER25},  {3896, LPC_REF_974MV, LPC_SCALING_PER25},
+};
+
+_attribute_data_retention_sec_ static lpc_monitor_t lpc_monitor;
+
+/**********************************************************************************************************************
+ *                                         local function implementation                                              *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to compare the input with one level.
+ * @param[in]  idx - level index.
+ * @return     1: input below the level, 0: input above.
+ */
+static unsigned char lpc_monitor_below(unsigned char idx)
+{
+    lpc_set_scaling_coeff((lpc_scaling_e)lpc_level[idx].scaling);
+    lpc_set_input_ref(LPC_LOWPOWER, (lpc_reference_e)lpc_level[idx].ref);
+    delay_us(LPC_MONITOR_SETTLE_US);
+
+    return lpc_get_result();
+}
+
+/**
+ * @brief      This function serves to arm the threshold for the current side, without settling delay.
+ * @return     none.
+ */
+static void lpc_monitor_arm(void)
+{
+    unsigned char idx = lpc_monitor.below ? lpc_monitor.high : lpc_monitor.low;
+
+    lpc_set_scaling_coeff((lpc_scaling_e)lpc_level[idx].scaling);
+    lpc_set_input_ref(LPC_LOWPOWER, (lpc_reference_e)lpc_level[idx].ref);
+    // the comparator only wakes on input below the reference, it stays claimed while the high threshold is armed
+    pm_wakeup_enable(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, !lpc_monitor.below);
+}
+
+/**********************************************************************************************************************
+ *                                         global function implementation                                             *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to start monitoring an input with hysteresis.
+ *             The low threshold is the highest level <= low_mv, the high threshold the lowest level >= high_mv.
+ * @param[in]  pin     - input channel.
+ * @param[in]  low_mv  - low threshold.
+ * @param[in]  high_mv - high threshold.
+ * @param[in]  cb      - crossing callback.
+ * @return     0: success, -1: no two distinct levels for the thresholds, or the comparator wakeup is
+ *             claimed by another driver.
+ */
+int lpc_monitor_start(lpc_input_channel_e pin, unsigned short low_mv, unsigned short high_mv, lpc_monitor_cb_t cb)
+{
+    int low = -1;
+    int high = -1;
+
+    for (int i = 0; i < LPC_MONITOR_LEVEL_NUM; i++) {
+        if (lpc_level[i].mv <= low_mv) {
+            low = i;
+        }
+        if (high < 0 && lpc_level[i].mv >= high_mv) {
+            high = i;
+        }
+    }
+    if (low < 0 || high <= low) {
+        return -1;
+    }
+    if (pm_wakeup_claim(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, 0, 0)) {
+        return -1;
+    }
+
+    lpc_monitor.cb = cb;
+    lpc_monitor.low = low;
+    lpc_monitor.high = high;
+
+    lpc_power_on();
+    lpc_set_input_chn(pin);
+    // start on the side the input is on now, no callback for the initial state
+    lpc_monitor.below = lpc_monitor_below(low);
+    lpc_monitor_arm();
+    lpc_monitor.active = 1;
+
+    return 0;
+}
+
+/**
+ * @brief      This function serves to stop monitoring and power down the comparator.
+ * @return     none.
+ */
+void lpc_monitor_stop(void)
+{
+    lpc_monitor.active = 0;
+    pm_wakeup_release(PM_WAKEUP_ID_LPC);
+    lpc_power_down();
+}
+
+/**
+ * @brief      This function serves to check the armed threshold, call it after each wakeup.
+ *             The callback is called on a crossing, then the other threshold is armed.
+ * @return     none.
+ */
+void lpc_monitor_poll(void)
+{
+    if (!lpc_monitor.active) {
+        return;
+    }
+
+    unsigned char result = lpc_get_result();
+    if (result == lpc_monitor.below) {
+        return;  // below the low threshold is still below the high one, and vice versa
+    }
+
+    // above the high threshold: result 0 while below, below the low threshold: result 1 while above
+    lpc_monitor.below = result;
+    lpc_monitor_arm();
+    if (lpc_monitor.cb) {
+        lpc_monitor.cb(result);
+    }
+}
+
+/**
+ * @brief      This function serves to bracket the level of an input by stepping the reference (binary search).
+ *             The monitor must be stopped, the comparator is left powered on.
+ * @param[in]  pin    - input channel.
+ * @param[out] hi_mv  - lowest level above the input, 0xffff if the input is above all levels.
+ * @return     highest level below the input in mV, 0 if the input is below all levels.
+ */
+unsigned short lpc_monitor_bracket(lpc_input_channel_e pin, unsigned short *hi_mv)
+{
+    unsigned char lo = 0;
+    unsigned char hi = LPC_MONITOR_LEVEL_NUM;  // input is below level hi, above level lo - 1
+
+    lpc_power_on();
+    lpc_set_input_chn(pin);
+
+    while (lo < hi) {
+        unsigned char mid = (lo + hi) / 2;
+        if (lpc_monitor_below(mid)) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    *hi_mv = (hi < LPC_MONITOR_LEVEL_NUM) ? lpc_level[hi].mv : 0xffff;
+    return hi ? lpc_level[hi - 1].mv : 0;
+}
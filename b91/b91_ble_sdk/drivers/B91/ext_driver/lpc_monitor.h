@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+/**	@page LPC_MONITOR
+ *
+ *	Introduction
+ *	===============
+ *	Threshold monitor on the low power comparator, e.g. for battery low detection without
+ *	waking up to sample the SAR ADC. The comparator compares the scaled input with one of the
+ *	internal references, which gives 16 threshold levels from 820mV to 3896mV
+ *	(reference / scaling). The monitor arms the low threshold while the input is above it,
+ *	and the high threshold while it is below, the callback is only called on a crossing.
+ *	lpc_monitor_bracket finds the levels around the input by stepping the reference.
+ *
+ *	The comparator output is high while Vin < Vref, which is also the level that wakes up with
+ *	PM_WAKEUP_COMPARATOR. The comparator is claimed through pm_wakeup for the whole monitoring,
+ *	but wakes only while the low threshold is armed, the rising crossing is found by
+ *	lpc_monitor_poll at the next wakeup of another source. lpc_monitor_poll is not called from
+ *	the sleep path, call it from the main loop after each wakeup.
+ *
+ *	API Reference
+ *	===============
+ *	Header File: lpc_monitor.h
+ */
+#ifndef DRIVERS_B91_EXT_DRIVER_LPC_MONITOR_H_
+#define DRIVERS_B91_EXT_DRIVER_LPC_MONITOR_H_
+
+#include "../lpc.h"
+
+#define LPC_MONITOR_LEVEL_NUM 16
+
+#ifndef LPC_MONITOR_SETTLE_US
+#define LPC_MONITOR_SETTLE_US 20  // comparator settling after a reference or scaling change
+#endif
+
+/**
+ * @brief	crossing callback, below - 1: input fell below the low threshold, 0: input rose above the high threshold
+ */
+typedef void (*lpc_monitor_cb_t)(unsigned char below);
+
+/**
+ * @brief      This function serves to start monitoring an input with hysteresis.
+ *             The low threshold is the highest level <= low_mv, the high threshold the lowest level >= high_mv.
+ * @param[in]  pin     - input channel.
+ * @param[in]  low_mv  - low threshold.
+ * @param[in]  high_mv - high threshold.
+ * @param[in]  cb      - crossing callback.
+ * @return     0: success, -1: no two distinct levels for the thresholds, or the comparator wakeup is
+ *             claimed by another driver.
+ */
+int lpc_monitor_start(lpc_input_channel_e pin, unsigned short low_mv, unsigned short high_mv, lpc_monitor_cb_t cb);
+
+/**
+ * @brief      This function serves to stop monitoring and power down the comparator.
+ * @return     none.
+ */
+void lpc_monitor_stop(void);
+
+/**
+ * @brief      This function serves to check the armed threshold, call it after each wakeup.
+ *             The callback is called on a crossing, then the other threshold is armed.
+ * @return     none.
+ */
+void lpc_monitor_poll(void);
+
+/**
+ * @brief      This function serves to bracket the level of an input by stepping the reference (binary search).
+ *             The monitor must be stopped, the comparator is left powered on.
+ * @param[in]  pin    - input channel.
+ * @param[out] hi_mv  - lowest level above the input, 0xffff if the input is above all levels.
+ * @return     highest level below the input in mV, 0 if the input is below all levels.
+ */
+unsigned short lpc_monitor_bracket(lpc_input_channel_e pin, unsigned short *hi_mv);
+
+#endif /* DRIVERS_B91_EXT_DRIVER_LPC_MONITOR_H_ */
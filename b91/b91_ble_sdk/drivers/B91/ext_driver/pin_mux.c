@@ -0,0 +1,205 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+#include "pin_mux.h"
+
+/**********************************************************************************************************************
+ *                                              local data type                                                     *
+ *********************************************************************************************************************/
+typedef struct {
+    unsigned short fs_mask;
+    unsigned short fs_val;
+    unsigned char gpio_set;
+    unsigned char gpio_clr;
+} pin_mux_port_t;
+
+/**********************************************************************************************************************
+ *                                              local variable                                                     *
+ *********************************************************************************************************************/
+#define PIN_MUX_PAD_IDX(pin) ((((pin) >> 8) << 3) + BIT_LOW_BIT((pin) & 0xff))
+
+_attribute_data_retention_sec_ static unsigned char pin_mux_owner[PIN_MUX_PAD_NUM] = {
+    [PIN_MUX_PAD_IDX(GPIO_PF0)] = PIN_MUX_OWNER_MSPI,
+    [PIN_MUX_PAD_IDX(GPIO_PF1)] = PIN_MUX_OWNER_MSPI,
+    [PIN_MUX_PAD_IDX(GPIO_PF2)] = PIN_MUX_OWNER_MSPI,
+    [PIN_MUX_PAD_IDX(GPIO_PF3)] = PIN_MUX_OWNER_MSPI,
+};
+static gpio_pin_e pin_mux_conflict_pin;
+static unsigned char pin_mux_conflict_owner;
+
+/* function mux register of each port */
+static volatile unsigned short *const pin_mux_fs_reg[PIN_MUX_PORT_NUM] = {
+    &reg_gpio_pa_fs, &reg_gpio_pb_fs, &reg_gpio_pc_fs, &reg_gpio_pd_fs, &reg_gpio_pe_fs, &reg_gpio_pf_fs,
+};
+
+/**********************************************************************************************************************
+ *                                         local function implementation                                              *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to write the staged changes, one function mux and one GPIO enable write per port.
+ * @param[in]  port - staged changes of all ports.
+ * @return     none.
+ */
+static void pin_mux_apply(const pin_mux_port_t *port)
+{
+    for (unsigned int i = 0; i < PIN_MUX_PORT_NUM; i++) {
+        if (port[i].fs_mask) {
+            *pin_mux_fs_reg[i] = (*pin_mux_fs_reg[i] & ~port[i].fs_mask) | port[i].fs_val;
+        }
+        // like the drivers, the mux is set before the GPIO function is disabled
+        if (port[i].gpio_set | port[i].gpio_clr) {
+            reg_gpio_func(i << 8) = (reg_gpio_func(i << 8) & ~port[i].gpio_clr) | port[i].gpio_set;
+        }
+    }
+}
+
+/**
+ * @brief      This function serves to release the pads of an owner selected by a pad mask per port.
+ * @param[in]  owner - owner id.
+ * @param[in]  mask  - pad mask of each port.
+ * @return     none.
+ */
+static void pin_mux_release_mask(pin_mux_owner_e owner, const unsigned char *mask)
+{
+    pin_mux_port_t port[PIN_MUX_PORT_NUM] = {0};
+
+    for (unsigned int idx = 0; idx < PIN_MUX_PAD_NUM; idx++) {
+        if ((mask[idx >> 3] & BIT(idx & 7)) && pin_mux_owner[idx] == owner) {
+            pin_mux_owner[idx] = PIN_MUX_OWNER_NONE;
+            port[idx >> 3].gpio_set |= BIT(idx & 7);
+        }
+    }
+    pin_mux_apply(port);
+}
+
+/**********************************************************************************************************************
+ *                                         global function implementation                                             *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to claim pads and apply their functions, all or nothing.
+ *             Claiming a pad the owner already has changes its function.
+ * @param[in]  owner       - owner id.
+ * @param[in]  cfg         - pads and functions.
+ * @param[in]  num         - number of pads.
+ * @param[in]  pad_mul_sel - bits to set in reg_gpio_pad_mul_sel, needed by some function 2 pads.
+ * @return     0: success, -1: invalid owner or pad, or a pad belongs to another owner (see pin_mux_get_conflict).
+ */
+int pin_mux_claim(pin_mux_owner_e owner, const pin_mux_cfg_t *cfg, unsigned int num, unsigned char pad_mul_sel)
+{
+    pin_mux_port_t port[PIN_MUX_PORT_NUM] = {0};
+
+    if (owner == PIN_MUX_OWNER_NONE || owner >= PIN_MUX_OWNER_MAX) {
+        return -1;
+    }
+
+    // check every pad before anything is written
+    for (unsigned int i = 0; i < num; i++) {
+        unsigned int group = cfg[i].pin >> 8;
+        unsigned char bits = cfg[i].pin & 0xff;
+
+        if (group >= PIN_MUX_PORT_NUM || !bits || (bits & (bits - 1))) {
+            return -1;
+        }
+        if (cfg[i].func > 3 && cfg[i].func != PIN_MUX_FUNC_GPIO && cfg[i].func != PIN_MUX_FUNC_KEEP) {
+            return -1;
+        }
+        unsigned char cur = pin_mux_owner[PIN_MUX_PAD_IDX(cfg[i].pin)];
+        if (cur != PIN_MUX_OWNER_NONE && cur != owner) {
+            pin_mux_conflict_pin = cfg[i].pin;
+            pin_mux_conflict_owner = cur;
+            return -1;
+        }
+    }
+
+    for (unsigned int i = 0; i < num; i++) {
+        unsigned int group = cfg[i].pin >> 8;
+        unsigned char bit = cfg[i].pin & 0xff;
+        unsigned int shift = BIT_LOW_BIT(bit) << 1;
+
+        pin_mux_owner[PIN_MUX_PAD_IDX(cfg[i].pin)] = owner;
+        if (cfg[i].func == PIN_MUX_FUNC_GPIO) {
+            port[group].gpio_set |= bit;
+            port[group].gpio_clr &= ~bit;
+        } else if (cfg[i].func != PIN_MUX_FUNC_KEEP) {
+            port[group].fs_mask |= 3 << shift;
+            port[group].fs_val = (port[group].fs_val & ~(3 << shift)) | (cfg[i].func << shift);
+            port[group].gpio_clr |= bit;
+            port[group].gpio_set &= ~bit;
+        }
+    }
+
+    pin_mux_apply(port);
+    if (pad_mul_sel) {
+        reg_gpio_pad_mul_sel |= pad_mul_sel;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief      This function serves to release pads of an owner, they go back to GPIO function.
+ * @param[in]  owner - owner id.
+ * @param[in]  pin   - pads of one port, e.g. GPIO_PB2 | GPIO_PB3.
+ * @return     none.
+ */
+void pin_mux_release(pin_mux_owner_e owner, gpio_pin_e pin)
+{
+    unsigned char mask[PIN_MUX_PORT_NUM] = {0};
+
+    if ((pin >> 8) < PIN_MUX_PORT_NUM) {
+        mask[pin >> 8] = pin & 0xff;
+        pin_mux_release_mask(owner, mask);
+    }
+}
+
+/**
+ * @brief      This function serves to release all pads of an owner, they go back to GPIO function.
+ * @param[in]  owner - owner id.
+ * @return     none.
+ */
+void pin_mux_release_all(pin_mux_owner_e owner)
+{
+    unsigned char mask[PIN_MUX_PORT_NUM] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+    pin_mux_release_mask(owner, mask);
+}
+
+/**
+ * @brief      This function serves to get the owner of a pad.
+ * @param[in]  pin - a single pad.
+ * @return     owner id, PIN_MUX_OWNER_NONE for a free or invalid pad.
+ */
+pin_mux_owner_e pin_mux_get_owner(gpio_pin_e pin)
+{
+    if ((pin >> 8) >= PIN_MUX_PORT_NUM || !(pin & 0xff)) {
+        return PIN_MUX_OWNER_NONE;
+    }
+    return (pin_mux_owner_e)pin_mux_owner[PIN_MUX_PAD_IDX(pin)];
+}
+
+/**
+ * @brief      This function serves to get the pad which made the last claim fail.
+ * @param[out] owner - owner of that pad, may be 0.
+ * @return     the pad.
+ */
+gpio_pin_e pin_mux_get_conflict(pin_mux_owner_e *owner)
+{
+    if (owner) {
+        *owner = (pin_mux_owner_e)pin_mux_conflict_owner;
+    }
+    return pin_mux_conflict_pin;
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+/**	@page PIN_MUX
+ *
+ *	Introduction
+ *	===============
+ *	The pad function mux is written by every driver on its own (uart_set_pin, i2c_set_pin,
+ *	hspi_set_pin, pwm_set_pin, audio_i2s_set_pin ...), nothing stops two drivers from taking the
+ *	same pad. This module keeps the owner of every pad. A claim names all pads of a driver with
+ *	their function, it is refused as a whole if any pad belongs to another owner, otherwise the
+ *	function mux and GPIO function enable of each touched port are written once.
+ *	Pads claimed with PIN_MUX_FUNC_KEEP are only reserved, the driver's own set_pin configures them.
+ *	PF0 ~ PF3 (flash) start owned by PIN_MUX_OWNER_MSPI.
+ *
+ *	API Reference
+ *	===============
+ *	Header File: pin_mux.h
+ */
+#ifndef DRIVERS_B91_EXT_DRIVER_PIN_MUX_H_
+#define DRIVERS_B91_EXT_DRIVER_PIN_MUX_H_
+
+#include "../gpio.h"
+
+#define PIN_MUX_PORT_NUM 6
+#define PIN_MUX_PAD_NUM  (PIN_MUX_PORT_NUM * 8)
+
+#define PIN_MUX_FUNC_GPIO 0xff  // pad as GPIO
+#define PIN_MUX_FUNC_KEEP 0xfe  // reserve only, registers are not touched
+                                // 0 ~ 3: pad function mux, see the pin enum of the driver
+
+/**
+ * @brief	pad owner
+ */
+typedef enum {
+    PIN_MUX_OWNER_NONE = 0,
+    PIN_MUX_OWNER_MSPI,
+    PIN_MUX_OWNER_SWS,
+    PIN_MUX_OWNER_GPIO,
+    PIN_MUX_OWNER_UART0,
+    PIN_MUX_OWNER_UART1,
+    PIN_MUX_OWNER_I2C,
+    PIN_MUX_OWNER_HSPI,
+    PIN_MUX_OWNER_PSPI,
+    PIN_MUX_OWNER_PWM,
+    PIN_MUX_OWNER_I2S,
+    PIN_MUX_OWNER_USB,
+    PIN_MUX_OWNER_USER0,  // application drivers start here
+    PIN_MUX_OWNER_MAX = 32,
+} pin_mux_owner_e;
+
+/**
+ * @brief	one pad of a claim
+ */
+typedef struct {
+    gpio_pin_e pin;      // a single pad
+    unsigned char func;  // 0 ~ 3, PIN_MUX_FUNC_GPIO or PIN_MUX_FUNC_KEEP
+} pin_mux_cfg_t;
+
+/**
+ * @brief      This function serves to claim pads and apply their functions, all or nothing.
+ *             Claiming a pad the owner already has changes its function.
+ * @param[in]  owner       - owner id.
+ * @param[in]  cfg         - pads and functions.
+ * @param[in]  num         - number of pads.
+ * @param[in]  pad_mul_sel - bits to set in reg_gpio_pad_mul_sel, needed by some function 2 pads.
+ * @return     0: success, -1: invalid owner or pad, or a pad belongs to another owner (see pin_mux_get_conflict).
+ */
+int pin_mux_claim(pin_mux_owner_e owner, const pin_mux_cfg_t *cfg, unsigned int num, unsigned char pad_mul_sel);
+
+/**
+ * @brief      This function serves to release pads of an owner, they go back to GPIO function.
+ * @param[in]  owner - owner id.
+ * @param[in]  pin   - pads of one port, e.g. GPIO_PB2 | GPIO_PB3.
+ * @return     none.
+ */
+void pin_mux_release(pin_mux_owner_e owner, gpio_pin_e pin);
+
+/**
+ * @brief      This function serves to release all pads of an owner, they go back to GPIO function.
+ * @param[in]  owner - owner id.
+ * @return     none.
+ */
+void pin_mux_release_all(pin_mux_owner_e owner);
+
+/**
+ * @brief      This function serves to get the owner of a pad.
+ * @param[in]  pin - a single pad.
+ * @return     owner id, PIN_MUX_OWNER_NONE for a free or invalid pad.
+ */
+pin_mux_owner_e pin_mux_get_owner(gpio_pin_e pin);
+
+/**
+ * @brief      This function serves to get the pad which made the last claim fail.
+ * @param[out] owner - owner of that pad, may be 0.
+ * @return     the pad.
+ */
+gpio_pin_e pin_mux_get_conflict(pin_mux_owner_e *owner);
+
+#endif /* DRIVERS_B91_EXT_DRIVER_PIN_MUX_H_ */
@@ -0,0 +1,138 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+#include "pm_retention.h"
+#include "../stimer.h"
+
+/**********************************************************************************************************************
+ *                                              local variable                                                     *
+ *********************************************************************************************************************/
+_attribute_data_retention_sec_ static pm_ret_node_t pm_ret_node[PM_RET_ID_MAX];
+_attribute_data_retention_sec_ static unsigned short pm_ret_used_mask;
+static unsigned int pm_ret_restore_tick[PM_RET_ID_MAX];
+static unsigned int pm_ret_total_tick;
+
+/**********************************************************************************************************************
+ *                                         global function implementation                                             *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to register a driver for save/restore across deep retention.
+ * @param[in]  id   - node id, registering an id again replaces the old node.
+ * @param[in]  node - callbacks, context and dependency of the driver.
+ * @return     0: success, -1: invalid id.
+ */
+int pm_retention_register(pm_ret_id_e id, const pm_ret_node_t *node)
+{
+    if (id >= PM_RET_ID_MAX || node->restore == 0) {
+        return -1;
+    }
+
+    pm_ret_node[id] = *node;
+    pm_ret_used_mask |= BIT(id);
+
+    return 0;
+}
+
+/**
+ * @brief      This function serves to unregister a driver.
+ * @param[in]  id - node id.
+ * @return     none.
+ */
+void pm_retention_unregister(pm_ret_id_e id)
+{
+    if (id < PM_RET_ID_MAX) {
+        pm_ret_used_mask &= ~BIT(id);
+    }
+}
+
+/**
+ * @brief      This function serves to save the state of all registered drivers, call it just before
+ *             entering deepsleep with SRAM retention mode.
+ * @return     none.
+ */
+void pm_retention_save_all(void)
+{
+    for (unsigned int id = 0; id < PM_RET_ID_MAX; id++) {
+        if ((pm_ret_used_mask & BIT(id)) && pm_ret_node[id].save) {
+            pm_ret_node[id].save(pm_ret_node[id].ctx);
+        }
+    }
+}
+
+/**
+ * @brief      This function serves to restore all registered drivers in dependency order, call it
+ *             after waking up from deep retention (pm_is_MCU_deepRetentionWakeup) instead of driver init.
+ * @return     0: success, -1: dependency loop or missing dependency, the remaining nodes are restored in id order.
+ */
+int pm_retention_restore_all(void)
+{
+    unsigned int start = stimer_get_tick();
+    unsigned short done = 0;
+    unsigned char progress = 1;
+    int ret = 0;
+
+    // every pass restores the nodes whose dependencies are done, at most PM_RET_ID_MAX passes
+    while (progress && done != pm_ret_used_mask) {
+        progress = 0;
+        for (unsigned int id = 0; id < PM_RET_ID_MAX; id++) {
+            if (!(pm_ret_used_mask & BIT(id)) || (done & BIT(id)) || (pm_ret_node[id].dep_mask & ~done)) {
+                continue;
+            }
+
+            unsigned int t = stimer_get_tick();
+            pm_ret_node[id].restore(pm_ret_node[id].ctx);
+            pm_ret_restore_tick[id] = stimer_get_tick() - t;
+
+            done |= BIT(id);
+            progress = 1;
+        }
+    }
+
+    if (done != pm_ret_used_mask) {
+        ret = -1;
+        for (unsigned int id = 0; id < PM_RET_ID_MAX; id++) {
+            if ((pm_ret_used_mask & BIT(id)) && !(done & BIT(id))) {
+                unsigned int t = stimer_get_tick();
+                pm_ret_node[id].restore(pm_ret_node[id].ctx);
+                pm_ret_restore_tick[id] = stimer_get_tick() - t;
+            }
+        }
+    }
+
+    pm_ret_total_tick = stimer_get_tick() - start;
+
+    return ret;
+}
+
+/**
+ * @brief      This function serves to get the time used by the last restore of a node.
+ * @param[in]  id - node id.
+ * @return     system timer tick.
+ */
+unsigned int pm_retention_get_restore_tick(pm_ret_id_e id)
+{
+    return id < PM_RET_ID_MAX ? pm_ret_restore_tick[id] : 0;
+}
+
+/**
+ * @brief      This function serves to get the time used by the last pm_retention_restore_all.
+ * @return     system timer tick.
+ */
+unsigned int pm_retention_get_total_restore_tick(void)
+{
+    return pm_ret_total_tick;
+}
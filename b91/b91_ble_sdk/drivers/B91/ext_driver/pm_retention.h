@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+/**	@page PM_RETENTION
+ *
+ *	Introduction
+ *	===============
+ *	Digital registers are lost in deepsleep with SRAM retention mode, only the retention
+ *	SRAM and analog registers keep their value. Drivers register a save callback which copies
+ *	their register state into a context blob in retention SRAM before sleep, and a restore
+ *	callback which writes it back after wakeup, so that full driver initialization is not
+ *	needed. Restore runs in dependency order, e.g. GPIO pin mux before UART.
+ *
+ *	API Reference
+ *	===============
+ *	Header File: pm_retention.h
+ */
+#ifndef DRIVERS_B91_EXT_DRIVER_PM_RETENTION_H_
+#define DRIVERS_B91_EXT_DRIVER_PM_RETENTION_H_
+
+#include "compiler.h"
+
+/**
+ * @brief	retention node id, also restore dependency bit
+ */
+typedef enum {
+    PM_RET_ID_GPIO = 0,
+    PM_RET_ID_UART0,
+    PM_RET_ID_UART1,
+    PM_RET_ID_I2C,
+    PM_RET_ID_USER0,  // application drivers start here
+    PM_RET_ID_MAX = 16,
+} pm_ret_id_e;
+
+/**
+ * @brief	save/restore callback, ctx is the context blob of the node
+ */
+typedef void (*pm_ret_save_cb_t)(void *ctx);
+typedef void (*pm_ret_restore_cb_t)(const void *ctx);
+
+/**
+ * @brief	retention node, copied into retention SRAM at registration
+ */
+typedef struct {
+    pm_ret_save_cb_t save;
+    pm_ret_restore_cb_t restore;
+    void *ctx;                // context blob, must be placed in retention SRAM
+    unsigned short dep_mask;  // BIT(id) of the nodes which must be restored first
+} pm_ret_node_t;
+
+/**
+ * @brief      This function serves to register a driver for save/restore across deep retention.
+ * @param[in]  id   - node id, registering an id again replaces the old node.
+ * @param[in]  node - callbacks, context and dependency of the driver.
+ * @return     0: success, -1: invalid id.
+ */
+int pm_retention_register(pm_ret_id_e id, const pm_ret_node_t *node);
+
+/**
+ * @brief      This function serves to unregister a driver.
+ * @param[in]  id - node id.
+ * @return     none.
+ */
+void pm_retention_unregister(pm_ret_id_e id);
+
+/**
+ * @brief      This function serves to save the state of all registered drivers, call it just before
+ *             entering deepsleep with SRAM retention mode.
+ * @return     none.
+ */
+void pm_retention_save_all(void);
+
+/**
+ * @brief      This function serves to restore all registered drivers in dependency order, call it
+ *             after waking up from deep retention (pm_is_MCU_deepRetentionWakeup) instead of driver init.
+ * @return     0: success, -1: dependency loop or missing dependency, the remaining nodes are restored in id order.
+ */
+int pm_retention_restore_all(void);
+
+/**
+ * @brief      This function serves to get the time used by the last restore of a node.
+ * @param[in]  id - node id.
+ * @return     system timer tick.
+ */
+unsigned int pm_retention_get_restore_tick(pm_ret_id_e id);
+
+/**
+ * @brief      This function serves to get the time used by the last pm_retention_restore_all.
+ * @return     system timer tick.
+ */
+unsigned int pm_retention_get_total_restore_tick(void);
+
+#endif /* DRIVERS_B91_EXT_DRIVER_PM_RETENTION_H_ */
@@ -0,0 +1,282 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+#include "pm_wakeup.h"
+
+/**********************************************************************************************************************
+ *                                              local data type                                                     *
+ *********************************************************************************************************************/
+typedef struct {
+    pm_wakeup_cb_t cb;
+    void *ctx;
+    unsigned char src;  // PM_WAKEUP_xxx
+    unsigned char off;  // claimed sources which do not wake, see pm_wakeup_enable
+} pm_wakeup_owner_t;
+
+typedef struct {
+    gpio_pin_e pin;
+    unsigned char level;
+    unsigned char id;  // PM_WAKEUP_ID_MAX: free
+} pm_wakeup_pin_t;
+
+/**********************************************************************************************************************
+ *                                              local variable                                                     *
+ *********************************************************************************************************************/
+_attribute_data_retention_sec_ static pm_wakeup_owner_t pm_wakeup_owner[PM_WAKEUP_ID_MAX];
+_attribute_data_retention_sec_ static pm_wakeup_pin_t pm_wakeup_pin[PM_WAKEUP_PIN_MAX];
+_attribute_data_retention_sec_ static unsigned char pm_wakeup_pin_num;
+_attribute_data_retention_sec_ static cpu_pm_handler_t pm_wakeup_sleep_handler;
+_attribute_data_retention_sec_ static pm_wakeup_sleep_hook_t pm_wakeup_hook[PM_WAKEUP_HOOK_MAX];
+
+/* exclusive sources, one owner each */
+#define PM_WAKEUP_EXCLUSIVE (PM_WAKEUP_COMPARATOR | PM_WAKEUP_MDEC)
+
+/**********************************************************************************************************************
+ *                                         local function implementation                                              *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to convert wakeup sources to the wakeup status bits they set.
+ * @param[in]  src - PM_WAKEUP_xxx mask.
+ * @return     WAKEUP_STATUS_xxx mask.
+ */
+static unsigned int pm_wakeup_src_to_status(unsigned int src)
+{
+    unsigned int status = 0;
+
+    status |= (src & PM_WAKEUP_PAD) ? WAKEUP_STATUS_PAD : 0;
+    status |= (src & PM_WAKEUP_CORE) ? WAKEUP_STATUS_CORE : 0;
+    status |= (src & PM_WAKEUP_TIMER) ? WAKEUP_STATUS_TIMER : 0;
+    status |= (src & PM_WAKEUP_COMPARATOR) ? WAKEUP_STATUS_COMPARATOR : 0;
+    status |= (src & PM_WAKEUP_MDEC) ? WAKEUP_STATUS_MDEC : 0;
+    return status;
+}
+
+/**
+ * @brief      This function serves to sleep with the claimed sources added, and dispatch the wakeup.
+ */
+static int pm_wakeup_sleep_wakeup(SleepMode_TypeDef sleep_mode, SleepWakeupSrc_TypeDef wakeup_src,
+                                  unsigned int wakeup_tick)
+{
+    wakeup_src = (SleepWakeupSrc_TypeDef)(wakeup_src | pm_wakeup_get_mask());
+    for (unsigned int i = 0; i < PM_WAKEUP_HOOK_MAX && pm_wakeup_hook[i]; i++) {
+        wakeup_tick = pm_wakeup_hook[i](sleep_mode, wakeup_src, wakeup_tick);
+    }
+
+    int ret = pm_wakeup_sleep_handler(sleep_mode, wakeup_src, wakeup_tick);
+
+    // only suspend comes back here, deep sleep reboots
+    pm_wakeup_dispatch(pm_get_wakeup_src());
+
+    return ret;
+}
+
+/**********************************************************************************************************************
+ *                                         global function implementation                                             *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to hook cpu_sleep_wakeup, call it after the pm handlers are selected
+ *             (blc_pm_select_internal_32k_crystal / blc_pm_select_external_32k_crystal).
+ * @return     none.
+ */
+void pm_wakeup_init(void)
+{
+    if (cpu_sleep_wakeup != pm_wakeup_sleep_wakeup) {
+        pm_wakeup_set_sleep_handler(cpu_sleep_wakeup);
+    }
+}
+
+/**
+ * @brief      This function serves to set the handler which puts the chip to sleep and hook cpu_sleep_wakeup again,
+ *             call it after blc_pm_select_xxx_32k_crystal when the pm handlers change at run time.
+ * @param[in]  handler - cpu_sleep_wakeup_32k_rc or cpu_sleep_wakeup_32k_xtal.
+ * @return     none.
+ */
+void pm_wakeup_set_sleep_handler(cpu_pm_handler_t handler)
+{
+    if (handler == pm_wakeup_sleep_wakeup) {
+        return;
+    }
+
+    pm_wakeup_sleep_handler = handler;
+    cpu_sleep_wakeup = pm_wakeup_sleep_wakeup;
+}
+
+/**
+ * @brief      This function serves to add a hook called before every sleep, hooks run in the order they were added.
+ *             cpu_sleep_wakeup is hooked if it is not yet.
+ * @param[in]  hook - the hook.
+ * @return     0: success, -1: table full.
+ */
+int pm_wakeup_add_sleep_hook(pm_wakeup_sleep_hook_t hook)
+{
+    for (unsigned int i = 0; i < PM_WAKEUP_HOOK_MAX; i++) {
+        if (pm_wakeup_hook[i] == hook) {
+            return 0;
+        }
+        if (!pm_wakeup_hook[i]) {
+            pm_wakeup_hook[i] = hook;
+            pm_wakeup_init();
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief      This function serves to claim wakeup sources.
+ * @param[in]  id  - owner id.
+ * @param[in]  src - PM_WAKEUP_xxx, PM_WAKEUP_PAD is added by pm_wakeup_claim_pin.
+ * @param[in]  cb  - called when one of the sources woke the chip, 0 for none.
+ * @param[in]  ctx - callback context.
+ * @return     0: success, -1: invalid id, or comparator/MDEC owned by another id.
+ */
+int pm_wakeup_claim(pm_wakeup_id_e id, unsigned int src, pm_wakeup_cb_t cb, void *ctx)
+{
+    if (id >= PM_WAKEUP_ID_MAX) {
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < PM_WAKEUP_ID_MAX; i++) {
+        if (i != id && (pm_wakeup_owner[i].src & src & PM_WAKEUP_EXCLUSIVE)) {
+            return -1;
+        }
+    }
+
+    pm_wakeup_owner[id].cb = cb;
+    pm_wakeup_owner[id].ctx = ctx;
+    pm_wakeup_owner[id].src = (pm_wakeup_owner[id].src & PM_WAKEUP_PAD) | (src & ~PM_WAKEUP_PAD);
+    pm_wakeup_owner[id].off &= ~src;
+
+    return 0;
+}
+
+/**
+ * @brief      This function serves to stop or resume waking on claimed sources, they stay owned meanwhile,
+ *             e.g. to keep the comparator while its current level would wake the chip at once.
+ *             Sources claimed again by pm_wakeup_claim wake again.
+ * @param[in]  id  - owner id.
+ * @param[in]  src - PM_WAKEUP_xxx, sources not claimed by id are ignored.
+ * @param[in]  en  - 1: wake on the sources, 0: do not.
+ * @return     none.
+ */
+void pm_wakeup_enable(pm_wakeup_id_e id, unsigned int src, int en)
+{
+    if (id >= PM_WAKEUP_ID_MAX) {
+        return;
+    }
+
+    if (en) {
+        pm_wakeup_owner[id].off &= ~src;
+    } else {
+        pm_wakeup_owner[id].off |= src & pm_wakeup_owner[id].src;
+    }
+}
+
+/**
+ * @brief      This function serves to claim a pad pin as wakeup source of an owner, see pm_set_gpio_wakeup.
+ * @param[in]  id    - owner id, claimed before by pm_wakeup_claim.
+ * @param[in]  pin   - the pin.
+ * @param[in]  level - wakeup level.
+ * @return     0: success, -1: invalid id, pin owned by another id or table full.
+ */
+int pm_wakeup_claim_pin(pm_wakeup_id_e id, gpio_pin_e pin, pm_gpio_wakeup_level_e level)
+{
+    pm_wakeup_pin_t *slot = 0;
+
+    if (id >= PM_WAKEUP_ID_MAX) {
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < pm_wakeup_pin_num; i++) {
+        if (pm_wakeup_pin[i].id != PM_WAKEUP_ID_MAX && pm_wakeup_pin[i].pin == pin) {
+            if (pm_wakeup_pin[i].id != id) {
+                return -1;
+            }
+            slot = &pm_wakeup_pin[i];
+            break;
+        }
+        if (!slot && pm_wakeup_pin[i].id == PM_WAKEUP_ID_MAX) {
+            slot = &pm_wakeup_pin[i];  // reuse a released entry, keep looking for the pin
+        }
+    }
+    if (!slot) {
+        if (pm_wakeup_pin_num >= PM_WAKEUP_PIN_MAX) {
+            return -1;
+        }
+        slot = &pm_wakeup_pin[pm_wakeup_pin_num++];
+    }
+
+    slot->pin = pin;
+    slot->level = level;
+    slot->id = id;
+    pm_wakeup_owner[id].src |= PM_WAKEUP_PAD;
+    pm_set_gpio_wakeup(pin, level, 1);
+
+    return 0;
+}
+
+/**
+ * @brief      This function serves to release all wakeup sources and pins of an owner.
+ * @param[in]  id - owner id.
+ * @return     none.
+ */
+void pm_wakeup_release(pm_wakeup_id_e id)
+{
+    if (id >= PM_WAKEUP_ID_MAX) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < pm_wakeup_pin_num; i++) {
+        if (pm_wakeup_pin[i].id == id) {
+            pm_set_gpio_wakeup(pm_wakeup_pin[i].pin, pm_wakeup_pin[i].level, 0);
+            pm_wakeup_pin[i].id = PM_WAKEUP_ID_MAX;
+        }
+    }
+    pm_wakeup_owner[id].src = 0;
+    pm_wakeup_owner[id].off = 0;
+    pm_wakeup_owner[id].cb = 0;
+}
+
+/**
+ * @brief      This function serves to get the wakeup sources of all owners.
+ * @return     PM_WAKEUP_xxx mask.
+ */
+unsigned int pm_wakeup_get_mask(void)
+{
+    unsigned int mask = 0;
+
+    for (unsigned int i = 0; i < PM_WAKEUP_ID_MAX; i++) {
+        mask |= pm_wakeup_owner[i].src & ~pm_wakeup_owner[i].off;
+    }
+    return mask;
+}
+
+/**
+ * @brief      This function serves to call the owners of the sources in a wakeup status.
+ * @param[in]  status - pm_wakeup_status_e.
+ * @return     none.
+ */
+void pm_wakeup_dispatch(unsigned int status)
+{
+    for (unsigned int i = 0; i < PM_WAKEUP_ID_MAX; i++) {
+        unsigned int src = pm_wakeup_owner[i].src & ~pm_wakeup_owner[i].off;
+        if (pm_wakeup_owner[i].cb && (pm_wakeup_src_to_status(src) & status)) {
+            pm_wakeup_owner[i].cb(status, pm_wakeup_owner[i].ctx);
+        }
+    }
+}
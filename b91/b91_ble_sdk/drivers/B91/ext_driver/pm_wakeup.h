@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+/**	@page PM_WAKEUP
+ *
+ *	Introduction
+ *	===============
+ *	Registry of wakeup sources. Drivers claim the sources they need (pad pins with their level,
+ *	comparator, MDEC, timer, core) under their own id with a callback, instead of each one setting
+ *	pm_set_gpio_wakeup and the wakeup source mask on its own. Pad pins and the comparator/MDEC
+ *	have one owner each, a conflicting claim is refused. pm_wakeup_init hooks cpu_sleep_wakeup:
+ *	the mask of all claims is added to the wakeup sources of every sleep, and after suspend the
+ *	wakeup status is read once and passed to every owner of a source that woke the chip.
+ *	For deep sleep the chip reboots, claim again at boot and call pm_wakeup_dispatch with
+ *	pm_get_wakeup_src().
+ *
+ *	cpu_sleep_wakeup belongs to this module once it is hooked, nothing else writes it. The handler
+ *	that really sleeps (cpu_sleep_wakeup_32k_rc/xtal) is set by pm_wakeup_set_sleep_handler, e.g.
+ *	after blc_pm_select_external_32k_crystal, which overwrites cpu_sleep_wakeup. Drivers which
+ *	adjust the sleep register a sleep hook instead of replacing the pointer.
+ *
+ *	Sleep hooks and wakeup callbacks run inside cpu_sleep_wakeup, i.e. in the sleep path of the
+ *	BLE stack or the idle task, possibly with interrupts disabled. They must be short: no delays,
+ *	no timers, no stack calls. Set a flag and do the work from the main loop.
+ *
+ *	API Reference
+ *	===============
+ *	Header File: pm_wakeup.h
+ */
+#ifndef DRIVERS_B91_EXT_DRIVER_PM_WAKEUP_H_
+#define DRIVERS_B91_EXT_DRIVER_PM_WAKEUP_H_
+
+#include "../gpio.h"
+#include "../pm.h"
+#include "ext_pm.h"
+
+#ifndef PM_WAKEUP_PIN_MAX
+#define PM_WAKEUP_PIN_MAX 16
+#endif
+
+#ifndef PM_WAKEUP_HOOK_MAX
+#define PM_WAKEUP_HOOK_MAX 4
+#endif
+
+/**
+ * @brief	owner id
+ */
+typedef enum {
+    PM_WAKEUP_ID_KEYSCAN = 0,
+    PM_WAKEUP_ID_LPC,
+    PM_WAKEUP_ID_MDEC,
+    PM_WAKEUP_ID_USER0,  // application drivers start here
+    PM_WAKEUP_ID_MAX = 8,
+} pm_wakeup_id_e;
+
+/**
+ * @brief	wakeup callback, status is the pm_wakeup_status_e read after wakeup
+ */
+typedef void (*pm_wakeup_cb_t)(unsigned int status, void *ctx);
+
+/**
+ * @brief	sleep hook, called before every sleep with the final wakeup sources, returns the wakeup tick to use
+ */
+typedef unsigned int (*pm_wakeup_sleep_hook_t)(SleepMode_TypeDef sleep_mode, SleepWakeupSrc_TypeDef wakeup_src,
+                                               unsigned int wakeup_tick);
+
+/**
+ * @brief      This function serves to hook cpu_sleep_wakeup, call it after the pm handlers are selected
+ *             (blc_pm_select_internal_32k_crystal / blc_pm_select_external_32k_crystal).
+ *             The current cpu_sleep_wakeup becomes the sleep handler, calling it again has no effect.
+ * @return     none.
+ */
+void pm_wakeup_init(void);
+
+/**
+ * @brief      This function serves to set the handler which puts the chip to sleep and hook cpu_sleep_wakeup again,
+ *             call it after blc_pm_select_xxx_32k_crystal when the pm handlers change at run time.
+ * @param[in]  handler - cpu_sleep_wakeup_32k_rc or cpu_sleep_wakeup_32k_xtal.
+ * @return     none.
+ */
+void pm_wakeup_set_sleep_handler(cpu_pm_handler_t handler);
+
+/**
+ * @brief      This function serves to add a hook called before every sleep, hooks run in the order they were added.
+ *             cpu_sleep_wakeup is hooked if it is not yet.
+ * @param[in]  hook - the hook.
+ * @return     0: success, -1: table full.
+ */
+int pm_wakeup_add_sleep_hook(pm_wakeup_sleep_hook_t hook);
+
+/**
+ * @brief      This function serves to claim wakeup sources.
+ * @param[in]  id  - owner id.
+ * @param[in]  src - PM_WAKEUP_xxx, PM_WAKEUP_PAD is added by pm_wakeup_claim_pin.
+ * @param[in]  cb  - called when one of the sources woke the chip, 0 for none.
+ * @param[in]  ctx - callback context.
+ * @return     0: success, -1: invalid id, or comparator/MDEC owned by another id.
+ */
+int pm_wakeup_claim(pm_wakeup_id_e id, unsigned int src, pm_wakeup_cb_t cb, void *ctx);
+
+/**
+ * @brief      This function serves to stop or resume waking on claimed sources, they stay owned meanwhile,
+ *             e.g. to keep the comparator while its current level would wake the chip at once.
+ *             Sources claimed again by pm_wakeup_claim wake again.
+ * @param[in]  id  - owner id.
+ * @param[in]  src - PM_WAKEUP_xxx, sources not claimed by id are ignored.
+ * @param[in]  en  - 1: wake on the sources, 0: do not.
+ * @return     none.
+ */
+void pm_wakeup_enable(pm_wakeup_id_e id, unsigned int src, int en);
+
+/**
+ * @brief      This function serves to claim a pad pin as wakeup source of an owner, see pm_set_gpio_wakeup.
+ * @param[in]  id    - owner id, claimed before by pm_wakeup_claim.
+ * @param[in]  pin   - the pin.
+ * @param[in]  level - wakeup level.
+ * @return     0: success, -1: invalid id, pin owned by another id or table full.
+ */
+int pm_wakeup_claim_pin(pm_wakeup_id_e id, gpio_pin_e pin, pm_gpio_wakeup_level_e level);
+
+/**
+ * @brief      This function serves to release all wakeup sources and pins of an owner.
+ * @param[in]  id - owner id.
+ * @return     none.
+ */
+void pm_wakeup_release(pm_wakeup_id_e id);
+
+/**
+ * @brief      This function serves to get the wakeup sources of all owners.
+ * @return     PM_WAKEUP_xxx mask.
+ */
+unsigned int pm_wakeup_get_mask(void);
+
+/**
+ * @brief      This function serves to call the owners of the sources in a wakeup status.
+ * @param[in]  status - pm_wakeup_status_e.
+ * @return     none.
+ */
+void pm_wakeup_dispatch(unsigned int status);
+
+#endif /* DRIVERS_B91_EXT_DRIVER_PM_WAKEUP_H_ */
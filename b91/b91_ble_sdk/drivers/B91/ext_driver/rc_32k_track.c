@@ -0,0 +1,201 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+#include "rc_32k_track.h"
+#include "../clock.h"
+#include "../core.h"
+#include "../stimer.h"
+#include "pm_wakeup.h"
+
+/**********************************************************************************************************************
+ *                                              local variable                                                     *
+ *********************************************************************************************************************/
+_attribute_data_retention_sec_ static rc_32k_track_t rc_32k_track;
+
+/**********************************************************************************************************************
+ *                                         local function implementation                                              *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to wait for the next 32k edge.
+ * @param[out] tick     - system timer tick at the edge.
+ * @param[out] tick_32k - 32k tick after the edge.
+ * @return     none.
+ */
+static void rc_32k_track_edge(unsigned int *tick, unsigned int *tick_32k)
+{
+    unsigned int r = core_interrupt_disable();
+    unsigned int last = clock_get_32k_tick();
+    unsigned int cur;
+
+    while ((cur = clock_get_32k_tick()) == last) {
+    }
+    *tick = stimer_get_tick();
+    *tick_32k = cur;
+
+    core_restore_interrupt(r);
+}
+
+/**
+ * @brief      This function serves to close the open window at a 32k edge and take its sample.
+ * @param[in]  chain - 1: the closing edge opens the next window.
+ * @return     none.
+ */
+static void rc_32k_track_close(unsigned char chain)
+{
+    unsigned int tick, tick_32k;
+
+    rc_32k_track_edge(&tick, &tick_32k);
+    unsigned int dt = tick - rc_32k_track.ref_tick;
+    unsigned int dn = tick_32k - rc_32k_track.ref_tick_32k;
+    rc_32k_track.ref_tick = tick;
+    rc_32k_track.ref_tick_32k = tick_32k;
+    rc_32k_track.ref_valid = chain;
+    if (!dn) {
+        return;
+    }
+
+    unsigned int ratio = (unsigned int)(((unsigned long long)dt << 16) / dn);
+    if (!rc_32k_track.base_ratio) {
+        rc_32k_track.base_ratio = ratio;
+        return;
+    }
+
+    // frequency drift in 1/16 ppm: base_ratio / ratio - 1
+    int sample = (int)(((long long)rc_32k_track.base_ratio - ratio) * 16 * 1000000 / ratio);
+    if (sample > RC_32K_TRACK_MAX_PPM * 16 || sample < -RC_32K_TRACK_MAX_PPM * 16) {
+        return;
+    }
+
+    if (!rc_32k_track.sample_cnt) {
+        rc_32k_track.drift = sample;
+    } else {
+        int err = sample - rc_32k_track.drift;
+        rc_32k_track.drift += err >> RC_32K_TRACK_FILTER_SHIFT;
+        rc_32k_track.dev += ((err < 0 ? -err : err) - rc_32k_track.dev) >> RC_32K_TRACK_FILTER_SHIFT;
+    }
+    rc_32k_track.sample_cnt++;
+}
+
+/**
+ * @brief      This function serves to correct the timer wakeup by the drift estimate, a pm_wakeup sleep hook.
+ *             The RC runs at (1 + drift) of the rate the pm driver assumes, so the sleep in 32k ticks
+ *             ends after duration / (1 + drift), the requested duration is scaled by (1 + drift).
+ *             A window opened by rc_32k_track_sample in this wake period is closed here, the system timer is
+ *             recovered from the 32k timer after sleep. The hook never opens a window, only a long enough open
+ *             window costs the wait for its closing 32k edge, the sleep entry of the pm driver waits for one
+ *             as well.
+ */
+static unsigned int rc_32k_track_sleep_hook(SleepMode_TypeDef sleep_mode, SleepWakeupSrc_TypeDef wakeup_src,
+                                            unsigned int wakeup_tick)
+{
+    (void)sleep_mode;
+
+    if (rc_32k_track.ref_valid && (unsigned int)(stimer_get_tick() - rc_32k_track.ref_tick) >=
+                                      RC_32K_TRACK_MIN_WINDOW_US * SYSTEM_TIMER_TICK_1US) {
+        rc_32k_track_close(0);
+    }
+    rc_32k_track.ref_valid = 0;
+
+    // the estimate is for the RC, not for a crystal selected later
+    if (g_clk_32k_src == CLK_32K_RC && rc_32k_track.sample_cnt && (wakeup_src & PM_WAKEUP_TIMER)) {
+        unsigned int now = stimer_get_tick();
+        int duration = (int)(wakeup_tick - now);
+        if (duration > 0) {
+            wakeup_tick += (int)((long long)duration * rc_32k_track.drift / (16 * 1000000));
+        }
+    }
+
+    return wakeup_tick;
+}
+
+/**********************************************************************************************************************
+ *                                         global function implementation                                             *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to start tracking, the first window after it is the drift reference.
+ * @param[in]  correct_sleep - 1: correct the timer wakeup by the drift estimate, through pm_wakeup_add_sleep_hook.
+ * @return     none.
+ */
+void rc_32k_track_init(unsigned char correct_sleep)
+{
+    rc_32k_track.ref_valid = 0;
+    rc_32k_track.base_ratio = 0;
+    rc_32k_track.drift = 0;
+    rc_32k_track.dev = 0;
+    rc_32k_track.sample_cnt = 0;
+
+    if (correct_sleep) {
+        (void)pm_wakeup_add_sleep_hook(rc_32k_track_sleep_hook);
+    }
+}
+
+/**
+ * @brief      This function serves to measure the 32k RC opportunistically. It opens a window if none is open,
+ *             and closes it if it is at least RC_32K_TRACK_MIN_WINDOW_US long, a new window is chained at the close.
+ *             Opening and closing wait for a 32k edge (up to 30.5us), other calls only read the system timer.
+ * @return     none.
+ */
+void rc_32k_track_sample(void)
+{
+    if (!rc_32k_track.ref_valid) {
+        rc_32k_track_edge(&rc_32k_track.ref_tick, &rc_32k_track.ref_tick_32k);
+        rc_32k_track.ref_valid = 1;
+        return;
+    }
+
+    if ((unsigned int)(stimer_get_tick() - rc_32k_track.ref_tick) <
+        RC_32K_TRACK_MIN_WINDOW_US * SYSTEM_TIMER_TICK_1US) {
+        return;
+    }
+
+    rc_32k_track_close(1);
+}
+
+/**
+ * @brief      This function serves to get the drift estimate against the first window.
+ * @return     drift in ppm, + means the 32k RC runs faster.
+ */
+int rc_32k_track_get_ppm(void)
+{
+    return rc_32k_track.drift / 16;
+}
+
+/**
+ * @brief      This function serves to get the early-wake guard band for a sleep,
+ *             from the sample deviation plus RC_32K_TRACK_GUARD_PPM.
+ * @param[in]  sleep_us - sleep duration.
+ * @return     guard band in us.
+ */
+unsigned int rc_32k_track_get_guard_us(unsigned int sleep_us)
+{
+    // about 3 sigma, the mean absolute deviation of a normal distribution is 0.8 sigma
+    unsigned int ppm = (unsigned int)rc_32k_track.dev * 4 / 16 + RC_32K_TRACK_GUARD_PPM;
+
+    if (!rc_32k_track.sample_cnt) {
+        ppm = RC_32K_TRACK_MAX_PPM;
+    }
+    return (unsigned int)((unsigned long long)sleep_us * ppm / 1000000) + 1;
+}
+
+/**
+ * @brief      This function serves to get the number of samples taken into the estimate.
+ * @return     sample count.
+ */
+unsigned int rc_32k_track_get_sample_cnt(void)
+{
+    return rc_32k_track.sample_cnt;
+}
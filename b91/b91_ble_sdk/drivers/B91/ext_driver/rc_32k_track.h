@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+/**	@page RC_32K_TRACK
+ *
+ *	Introduction
+ *	===============
+ *	clock_cal_32k_rc runs once at init, then the 32k RC drifts with temperature and voltage.
+ *	The tracker measures the 32k timer against the 16M system timer in windows which lie inside
+ *	one wake period (the system timer is recovered from the 32k timer after suspend, so a window
+ *	across sleep says nothing). Each window starts and ends on a 32k edge, the drift against the
+ *	first window after init is filtered into a ppm estimate and a deviation.
+ *	If enabled, a pm_wakeup sleep hook stretches or shrinks the timer wakeup by the estimate so that
+ *	the wakeup is on time, and rc_32k_track_get_guard_us gives an early-wake guard band derived
+ *	from the deviation instead of the worst case drift.
+ *
+ *	Usage: call rc_32k_track_init after clock_cal_32k_rc and blc_pm_select_internal_32k_crystal,
+ *	call rc_32k_track_sample whenever the MCU has woken up, e.g. at the start of the main loop.
+ *	The sleep hook only closes a window opened by rc_32k_track_sample, it never opens one.
+ *
+ *	API Reference
+ *	===============
+ *	Header File: rc_32k_track.h
+ */
+#ifndef DRIVERS_B91_EXT_DRIVER_RC_32K_TRACK_H_
+#define DRIVERS_B91_EXT_DRIVER_RC_32K_TRACK_H_
+
+#ifndef RC_32K_TRACK_MIN_WINDOW_US
+#define RC_32K_TRACK_MIN_WINDOW_US 2000  // shorter windows are left open until the next sample
+#endif
+
+#ifndef RC_32K_TRACK_MAX_PPM
+#define RC_32K_TRACK_MAX_PPM 5000  // samples beyond this are dropped as outliers
+#endif
+
+#ifndef RC_32K_TRACK_GUARD_PPM
+#define RC_32K_TRACK_GUARD_PPM 50  // fixed part of the guard band
+#endif
+
+#define RC_32K_TRACK_FILTER_SHIFT 3  // estimate += (sample - estimate) / 8
+
+/**
+ * @brief	tracker state, ppm values are in 1/16 ppm
+ */
+typedef struct {
+    unsigned int ref_tick;      // system timer tick at the 32k edge which opened the window
+    unsigned int ref_tick_32k;  // 32k tick of that edge
+    unsigned int base_ratio;    // system timer ticks per 32k tick of the first window, Q16
+    int drift;                  // filtered frequency drift against base_ratio, + is faster
+    int dev;                    // filtered absolute deviation of the samples from drift
+    unsigned int sample_cnt;
+    unsigned char ref_valid;
+} rc_32k_track_t;
+
+/**
+ * @brief      This function serves to start tracking, the first window after it is the drift reference.
+ * @param[in]  correct_sleep - 1: correct the timer wakeup by the drift estimate, through pm_wakeup_add_sleep_hook.
+ * @return     none.
+ */
+void rc_32k_track_init(unsigned char correct_sleep);
+
+/**
+ * @brief      This function serves to measure the 32k RC opportunistically. It opens a window if none is open,
+ *             and closes it if it is at least RC_32K_TRACK_MIN_WINDOW_US long, a new window is chained at the close.
+ *             Opening and closing wait for a 32k edge (up to 30.5us), other calls only read the system timer.
+ * @return     none.
+ */
+void rc_32k_track_sample(void);
+
+/**
+ * @brief      This function serves to get the drift estimate against the first window.
+ * @return     drift in ppm, + means the 32k RC runs faster.
+ */
+int rc_32k_track_get_ppm(void);
+
+/**
+ * @brief      This function serves to get the early-wake guard band for a sleep,
+ *             from the sample deviation plus RC_32K_TRACK_GUARD_PPM.
+ * @param[in]  sleep_us - sleep duration.
+ * @return     guard band in us.
+ */
+unsigned int rc_32k_track_get_guard_us(unsigned int sleep_us);
+
+/**
+ * @brief      This function serves to get the number of samples taken into the estimate.
+ * @return     sample count.
+ */
+unsigned int rc_32k_track_get_sample_cnt(void);
+
+#endif /* DRIVERS_B91_EXT_DRIVER_RC_32K_TRACK_H_ */
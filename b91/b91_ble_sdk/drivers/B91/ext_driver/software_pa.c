@@ -18,27 +18,49 @@
 #include "software_pa.h"
 #include "../gpio.h"
 #include "compiler.h"
+#include <string.h>
 
 _attribute_data_retention_ rf_pa_callback_t blc_rf_pa_cb = 0;
 
+#if (PA_ENABLE && PA_CTRL_MODE == PA_CTRL_SOFTWARE)
+_attribute_data_retention_ pa_switch_t pa_switch[PA_TYPE_NUM];
+
+/**
+ * @brief      This function serves to add one pin to the register writes of a PA state.
+ * @param[in]  sw  - register writes of the PA state.
+ * @param[in]  pin - PA_TXEN_PIN or PA_RXEN_PIN.
+ * @param[in]  on  - 1: output enable and drive high, 0: output disable and drive low.
+ * @return     none.
+ */
+static void rf_pa_switch_add_pin(pa_switch_t *sw, gpio_pin_e pin, unsigned char on)
+{
+    // oen at offset 2 and out at offset 3 of the port, one halfword covers both
+    volatile unsigned short *reg = &REG_ADDR16(0x140302 + ((pin >> 8) << 3));
+    unsigned short oen_bit = pin & 0xff;
+    unsigned short out_bit = (pin & 0xff) << 8;
+    pa_reg_op_t *op = &sw->op[0];
+
+    if (sw->num && op->reg != reg) {
+        op = &sw->op[1];
+    }
+    if (op == &sw->op[sw->num]) {
+        op->reg = reg;
+        sw->num++;
+    }
+
+    op->clr |= oen_bit | out_bit;
+    op->set |= on ? out_bit : oen_bit;  // oen is active low
+}
+#endif
+
 _attribute_ram_code_ void app_rf_pa_handler(int type)
 {
-#if (PA_ENABLE)
-    if (type == PA_TYPE_TX_ON) {
-        gpio_set_output_en(PA_RXEN_PIN, 0);
-        gpio_write(PA_RXEN_PIN, 0);
-        gpio_set_output_en(PA_TXEN_PIN, 1);
-        gpio_write(PA_TXEN_PIN, 1);
-    } else if (type == PA_TYPE_RX_ON) {
-        gpio_set_output_en(PA_TXEN_PIN, 0);
-        gpio_write(PA_TXEN_PIN, 0);
-        gpio_set_output_en(PA_RXEN_PIN, 1);
-        gpio_write(PA_RXEN_PIN, 1);
-    } else {
-        gpio_set_output_en(PA_RXEN_PIN, 0);
-        gpio_write(PA_RXEN_PIN, 0);
-        gpio_set_output_en(PA_TXEN_PIN, 0);
-        gpio_write(PA_TXEN_PIN, 0);
+#if (PA_ENABLE && PA_CTRL_MODE == PA_CTRL_SOFTWARE)
+    pa_switch_t *sw = &pa_switch[(type == PA_TYPE_TX_ON || type == PA_TYPE_RX_ON) ? type : PA_TYPE_OFF];
+
+    *sw->op[0].reg = (*sw->op[0].reg & ~sw->op[0].clr) | sw->op[0].set;
+    if (sw->num > 1) {
+        *sw->op[1].reg = (*sw->op[1].reg & ~sw->op[1].clr) | sw->op[1].set;
     }
 #endif
 }
@@ -46,6 +68,10 @@ _attribute_ram_code_ void app_rf_pa_handler(int type)
 void rf_pa_init(void)
 {
 #if (PA_ENABLE)
+#if (PA_CTRL_MODE == PA_CTRL_RFFE)
+    rf_set_rffe_pin(PA_RFFE_TX_PIN, PA_RFFE_RX_PIN);
+    blc_rf_pa_cb = 0;
+#else
     gpio_set_func(PA_TXEN_PIN, AS_GPIO);
     gpio_set_output_en(PA_TXEN_PIN, 0);
     gpio_write(PA_TXEN_PIN, 0);
@@ -54,8 +80,18 @@ void rf_pa_init(void)
     gpio_set_output_en(PA_RXEN_PIN, 0);
     gpio_write(PA_RXEN_PIN, 0);
 
+    // resolve port and bit once here, the pin being switched off is written first
+    memset(pa_switch, 0, sizeof(pa_switch));
+    rf_pa_switch_add_pin(&pa_switch[PA_TYPE_TX_ON], PA_RXEN_PIN, 0);
+    rf_pa_switch_add_pin(&pa_switch[PA_TYPE_TX_ON], PA_TXEN_PIN, 1);
+    rf_pa_switch_add_pin(&pa_switch[PA_TYPE_RX_ON], PA_TXEN_PIN, 0);
+    rf_pa_switch_add_pin(&pa_switch[PA_TYPE_RX_ON], PA_RXEN_PIN, 1);
+    rf_pa_switch_add_pin(&pa_switch[PA_TYPE_OFF], PA_RXEN_PIN, 0);
+    rf_pa_switch_add_pin(&pa_switch[PA_TYPE_OFF], PA_TXEN_PIN, 0);
+
     blc_rf_pa_cb = app_rf_pa_handler;
 #endif
+#endif
 }
 
 void set_blc_rf_pa_cb(rf_pa_callback_t cb)
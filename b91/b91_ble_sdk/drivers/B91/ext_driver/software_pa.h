@@ -20,6 +20,7 @@
 #define BLT_PA_H_
 
 #include "../gpio.h"
+#include "../rf.h"
 
 #ifndef PA_ENABLE
 #define PA_ENABLE 0
@@ -33,9 +34,45 @@
 #define PA_RXEN_PIN GPIO_PB3
 #endif
 
+/* PA control mode:
+   PA_CTRL_SOFTWARE: PA_TXEN_PIN/PA_RXEN_PIN switched by app_rf_pa_handler in RF IRQ
+   PA_CTRL_RFFE:     PA_RFFE_TX_PIN/PA_RFFE_RX_PIN switched by RF hardware, no software switching */
+#define PA_CTRL_SOFTWARE 0
+#define PA_CTRL_RFFE     1
+
+#ifndef PA_CTRL_MODE
+#define PA_CTRL_MODE PA_CTRL_SOFTWARE
+#endif
+
+#ifndef PA_RFFE_TX_PIN
+#define PA_RFFE_TX_PIN RF_RFFE_TX_PB0
+#endif
+
+#ifndef PA_RFFE_RX_PIN
+#define PA_RFFE_RX_PIN RF_RFFE_RX_PB1
+#endif
+
 #define PA_TYPE_OFF   0
 #define PA_TYPE_TX_ON 1
 #define PA_TYPE_RX_ON 2
+#define PA_TYPE_NUM   3
+
+/**
+ * @brief	one read-modify-write on the output enable(low byte) and output(high byte) halfword of a port
+ */
+typedef struct {
+    volatile unsigned short *reg;
+    unsigned short clr;
+    unsigned short set;
+} pa_reg_op_t;
+
+/**
+ * @brief	register writes for one PA state, TX and RX pin on the same port need only one write
+ */
+typedef struct {
+    pa_reg_op_t op[2];
+    unsigned char num;
+} pa_switch_t;
 
 typedef void (*rf_pa_callback_t)(int type);
 
@@ -0,0 +1,248 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+#include "xtal_32k_start.h"
+#include "../analog.h"
+#include "../clock.h"
+#include "../stimer.h"
+#include "../sys.h"
+#include "ext_pm.h"
+#include "pm_wakeup.h"
+
+/**********************************************************************************************************************
+ *                                              local data type                                                     *
+ *********************************************************************************************************************/
+typedef struct {
+    unsigned int state_tick;  // system timer tick when the current state or window started
+    unsigned int ref_tick;    // system timer tick of ref_tick_32k (RC) before the trial, for timebase compensation
+    unsigned int ref_tick_32k;
+    unsigned int win_tick_32k;  // 32k tick at the start of the check window
+    unsigned char state;
+    unsigned char kick_left;
+    unsigned char good_cnt;
+    // PWM and pin registers saved during the kick
+    unsigned char reg_31e;
+    unsigned char reg_336;
+    unsigned char reg_355;
+    unsigned char reg_401;
+    unsigned char reg_402;
+    unsigned short reg_414;
+    unsigned short reg_416;
+} xtal_32k_start_t;
+
+/**********************************************************************************************************************
+ *                                              local variable                                                     *
+ *********************************************************************************************************************/
+static xtal_32k_start_t xtal_32k;
+
+/**********************************************************************************************************************
+ *                                         local function implementation                                              *
+ *********************************************************************************************************************/
+static int xtal_32k_elapsed(unsigned int tick, unsigned int us)
+{
+    return (unsigned int)(stimer_get_tick() - tick) >= us * SYSTEM_TIMER_TICK_1US;
+}
+
+/**
+ * @brief      This function serves to select the 32k source and keep the 32k timer continuous: the timer is
+ *             set to the reference tick plus the system time since the reference. The write is synchronized
+ *             to the 32k clock, so it is only done when the new source is known to run.
+ * @param[in]  src        - 32k source.
+ * @param[in]  compensate - 1: set the 32k timer.
+ * @return     none.
+ */
+static void xtal_32k_select(clk_32k_type_e src, unsigned char compensate)
+{
+    analog_write_reg8(0x4e, (analog_read_reg8(0x4e) & 0x7f) | (src << 7));
+
+    if (compensate) {
+        unsigned int now = stimer_get_tick();
+        clock_set_32k_tick(xtal_32k.ref_tick_32k + (unsigned int)((unsigned long long)(now - xtal_32k.ref_tick) *
+                                                                  32768 / SYSTEM_TIMER_TICK_1S));
+    }
+}
+
+/**
+ * @brief      This function serves to drive the crystal pin PD0 with 32k PWM, see clock_kick_32k_xtal.
+ *             clock_kick_32k_xtal halves PCLK for the kick, here PCLK stays 24M for the whole kick and
+ *             the PWM period is doubled instead.
+ * @return     none.
+ */
+static void xtal_32k_kick_start(void)
+{
+    if (0xff == g_chip_version) {
+        return;  // A0 has no PWM kick, only the wait
+    }
+
+    // **condition: PCLK is 24MHZ
+    xtal_32k.reg_31e = read_reg8(0x14031e);  // PD0 -> pwm0
+    write_reg8(0x14031e, xtal_32k.reg_31e & 0xfe);
+    xtal_32k.reg_336 = read_reg8(0x140336);
+    write_reg8(0x140336, (xtal_32k.reg_336 & 0xfc) | 0x02);
+    xtal_32k.reg_355 = read_reg8(0x140355);
+    write_reg8(0x140355, xtal_32k.reg_355 | 0x01);
+
+    xtal_32k.reg_414 = read_reg16(0x140414);  // pwm0 cmp
+    write_reg16(0x140414, 0x02);
+    xtal_32k.reg_416 = read_reg16(0x140416);  // pwm0 max
+    write_reg16(0x140416, 0x04);
+
+    xtal_32k.reg_402 = read_reg8(0x140402);  // pwm clk div, shared by all pwm channels
+    write_reg8(0x140402, 0xb6);  // 24M/(0xb6 + 1)/4 = 32k
+    xtal_32k.reg_401 = read_reg8(0x140401);  // pwm_en  pwm0 enable, other bits kept
+    write_reg8(0x140401, xtal_32k.reg_401 | 0x01);
+}
+
+/**
+ * @brief      This function serves to stop the kick and give PD0 back to the crystal.
+ * @return     none.
+ */
+static void xtal_32k_kick_stop(void)
+{
+    if (0xff == g_chip_version) {
+        return;
+    }
+
+    analog_write_reg8(0x03, 0x4f);  // Xtal 32k output, <7:6>current select
+
+    write_reg8(0x14031e, xtal_32k.reg_31e);
+    write_reg8(0x140336, xtal_32k.reg_336);
+    write_reg8(0x140355, xtal_32k.reg_355);
+    write_reg16(0x140414, xtal_32k.reg_414);
+    write_reg16(0x140416, xtal_32k.reg_416);
+    write_reg8(0x140401, (read_reg8(0x140401) & 0xfe) | (xtal_32k.reg_401 & 0x01));
+    write_reg8(0x140402, xtal_32k.reg_402);
+}
+
+/**
+ * @brief      This function serves to end the check window with the RC selected again,
+ *             and kick again or give up. Suspend stays off for the next kick, suspend stops the PWM.
+ * @return     none.
+ */
+static void xtal_32k_check_fail(void)
+{
+    xtal_32k_select(CLK_32K_RC, 1);
+
+    if (xtal_32k.kick_left) {
+        xtal_32k.kick_left--;
+        blt_miscParam.pm_enter_en = 0;
+        xtal_32k_kick_start();
+        xtal_32k.state_tick = stimer_get_tick();
+        xtal_32k.state = XTAL_32K_KICK;
+    } else {
+        analog_write_reg8(0x05, (analog_read_reg8(0x05) & 0xfc) | 0x2);  // 32k rc only
+        blt_miscParam.pm_enter_en = 1;
+        xtal_32k.state = XTAL_32K_FAIL;
+    }
+}
+
+/**********************************************************************************************************************
+ *                                         global function implementation                                             *
+ *********************************************************************************************************************/
+/**
+ * @brief      This function serves to start the 32k crystal in background, the 32k RC stays the source meanwhile.
+ * @param[in]  kick_times - kicks before giving up.
+ * @return     none.
+ */
+void xtal_32k_start_async(unsigned char kick_times)
+{
+    if (!kick_times || xtal_32k.state == XTAL_32K_KICK || xtal_32k.state == XTAL_32K_CHECK) {
+        return;
+    }
+
+    analog_write_reg8(0x05, analog_read_reg8(0x05) & 0xfc);  // power on both 32k rc and 32k xtal
+
+    // no suspend during the kick, suspend stops the PWM
+    blt_miscParam.pm_enter_en = 0;
+    xtal_32k.kick_left = kick_times - 1;
+    xtal_32k_kick_start();
+    xtal_32k.state_tick = stimer_get_tick();
+    xtal_32k.state = XTAL_32K_KICK;
+}
+
+/**
+ * @brief      This function serves to run the start-up state machine, it only reads timers and writes registers.
+ * @return     the state after this step.
+ */
+xtal_32k_state_e xtal_32k_start_poll(void)
+{
+    switch (xtal_32k.state) {
+        case XTAL_32K_KICK: {
+            unsigned int kick_us = (0xff == g_chip_version) ? 1000000 : XTAL_32K_KICK_MS * 1000;
+            if (!xtal_32k_elapsed(xtal_32k.state_tick, kick_us)) {
+                break;
+            }
+            xtal_32k_kick_stop();
+
+            // select the crystal on trial, still no suspend until it is known to run
+            xtal_32k.ref_tick_32k = clock_get_32k_tick();
+            xtal_32k.ref_tick = stimer_get_tick();
+            xtal_32k_select(CLK_32K_XTAL, 0);
+            xtal_32k.win_tick_32k = xtal_32k.ref_tick_32k;
+            xtal_32k.state_tick = xtal_32k.ref_tick;
+            xtal_32k.good_cnt = 0;
+            xtal_32k.state = XTAL_32K_CHECK;
+            break;
+        }
+
+        case XTAL_32K_CHECK: {
+            if (!xtal_32k_elapsed(xtal_32k.state_tick, XTAL_32K_CHECK_US)) {
+                break;
+            }
+            unsigned int now = stimer_get_tick();
+            unsigned int tick_32k = clock_get_32k_tick();
+            unsigned int expect =
+                (unsigned int)((unsigned long long)(now - xtal_32k.state_tick) * 32768 / SYSTEM_TIMER_TICK_1S);
+            unsigned int got = tick_32k - xtal_32k.win_tick_32k;
+
+            // within 1/8 of the expected count: the crystal runs, not the kick residue or a stalled counter
+            if (got + expect / 8 + 1 < expect || got > expect + expect / 8 + 1) {
+                xtal_32k_check_fail();
+                break;
+            }
+
+            xtal_32k.win_tick_32k = tick_32k;
+            xtal_32k.state_tick = now;
+            if (++xtal_32k.good_cnt < XTAL_32K_CHECK_NUM) {
+                break;
+            }
+
+            xtal_32k_select(CLK_32K_XTAL, 1);  // ticks lost while the crystal was starting
+            analog_write_reg8(0x05, (analog_read_reg8(0x05) & 0xfc) | 0x1);  // 32k xtal only
+            g_clk_32k_src = CLK_32K_XTAL;
+            blc_pm_select_external_32k_crystal();
+            pm_wakeup_set_sleep_handler(cpu_sleep_wakeup_32k_xtal);  // cpu_sleep_wakeup was overwritten
+            blt_miscParam.pm_enter_en = 1;
+            xtal_32k.state = XTAL_32K_DONE;
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return (xtal_32k_state_e)xtal_32k.state;
+}
+
+/**
+ * @brief      This function serves to get the start-up state.
+ * @return     the state.
+ */
+xtal_32k_state_e xtal_32k_start_get_state(void)
+{
+    return (xtal_32k_state_e)xtal_32k.state;
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+/**	@page XTAL_32K_START
+ *
+ *	Introduction
+ *	===============
+ *	clock_kick_32k_xtal blocks for the PWM kick and the stability check, and the crystal may
+ *	need several kicks. Here the system boots on the 32k RC and the crystal is started by a
+ *	state machine driven from xtal_32k_start_poll, which never waits. The crystal is checked by
+ *	selecting it as 32k source for some windows and comparing its tick count with the system
+ *	timer, suspend is not allowed from the first kick until the crystal is stable or given up. At every source change the 32k timer is rewritten
+ *	with the value the old source would have reached, so the 32k timebase has no jump.
+ *	When the crystal is stable the pm handlers are switched to the 32k crystal ones, the sleep handler
+ *	through pm_wakeup_set_sleep_handler so that the pm_wakeup hooks stay installed.
+ *
+ *	Usage: boot on the RC (clock_32k_init(CLK_32K_RC), blc_pm_select_internal_32k_crystal),
+ *	call xtal_32k_start_async, then xtal_32k_start_poll from the main loop until it returns
+ *	XTAL_32K_DONE or XTAL_32K_FAIL. The PWM kick needs PCLK 24M, PCLK is not changed.
+ *
+ *	API Reference
+ *	===============
+ *	Header File: xtal_32k_start.h
+ */
+#ifndef DRIVERS_B91_EXT_DRIVER_XTAL_32K_START_H_
+#define DRIVERS_B91_EXT_DRIVER_XTAL_32K_START_H_
+
+#ifndef XTAL_32K_KICK_MS
+#define XTAL_32K_KICK_MS 10  // PWM kick length
+#endif
+
+#ifndef XTAL_32K_CHECK_US
+#define XTAL_32K_CHECK_US 1000  // length of one check window, about 32 ticks
+#endif
+
+#ifndef XTAL_32K_CHECK_NUM
+#define XTAL_32K_CHECK_NUM 3  // consecutive good windows for stable
+#endif
+
+/**
+ * @brief	start-up state
+ */
+typedef enum {
+    XTAL_32K_IDLE = 0,
+    XTAL_32K_KICK,        // PWM drives the crystal pin
+    XTAL_32K_CHECK,       // crystal selected on trial
+    XTAL_32K_DONE,        // 32k source is the crystal
+    XTAL_32K_FAIL,        // all kicks failed, 32k source stays the RC
+} xtal_32k_state_e;
+
+/**
+ * @brief      This function serves to start the 32k crystal in background, the 32k RC stays the source meanwhile.
+ * @param[in]  kick_times - kicks before giving up.
+ * @return     none.
+ */
+void xtal_32k_start_async(unsigned char kick_times);
+
+/**
+ * @brief      This function serves to run the start-up state machine, it only reads timers and writes registers.
+ * @return     the state after this step.
+ */
+xtal_32k_state_e xtal_32k_start_poll(void);
+
+/**
+ * @brief      This function serves to get the start-up state.
+ * @return     the state.
+ */
+xtal_32k_state_e xtal_32k_start_get_state(void);
+
+#endif /* DRIVERS_B91_EXT_DRIVER_XTAL_32K_START_H_ */
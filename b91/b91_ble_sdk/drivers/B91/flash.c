@@ -31,6 +31,41 @@ static preempt_config_t s_flash_preempt_config = {
     .threshold = 1,
 };
 
+static flash_yield_cb_t flash_erase_yield_cb = 0;
+static unsigned int flash_timeout_cnt;
+
+_attribute_data_retention_sec_ static flash_timeout_t s_flash_timeout = {
+    .page_program = FLASH_TIMEOUT_PAGE_PROGRAM_US,
+    .sector_erase = FLASH_TIMEOUT_SECTOR_ERASE_US,
+    .block32k_erase = FLASH_TIMEOUT_32KBLK_ERASE_US,
+    .block64k_erase = FLASH_TIMEOUT_64KBLK_ERASE_US,
+    .chip_erase = FLASH_TIMEOUT_CHIP_ERASE_US,
+    .status_write = FLASH_TIMEOUT_STATUS_WRITE_US,
+};
+
+#if FLASH_CACHE_LINE_NUM
+#define FLASH_CACHE_WAY_NUM 2
+#define FLASH_CACHE_SET_NUM (FLASH_CACHE_LINE_NUM / FLASH_CACHE_WAY_NUM)
+#if (FLASH_CACHE_LINE_NUM % FLASH_CACHE_WAY_NUM)
+#error "FLASH_CACHE_LINE_NUM must be a multiple of FLASH_CACHE_WAY_NUM"
+#endif
+
+typedef struct {
+    unsigned int tag;      // page number + 1, 0: invalid
+    unsigned char filling; // a miss is loading data with interrupts enabled, not a victim meanwhile
+    unsigned char data[PAGE_SIZE];
+} flash_cache_line_t;
+
+static flash_cache_line_t flash_cache[FLASH_CACHE_SET_NUM][FLASH_CACHE_WAY_NUM];
+static unsigned char flash_cache_victim[FLASH_CACHE_SET_NUM];
+static unsigned int flash_cache_hit;
+static unsigned int flash_cache_miss;
+static unsigned int flash_cache_seq;  // bumped by invalidations and fills, a fill only commits if it is unchanged
+#if (PAGE_SIZE % FLASH_CACHE_FILL_SIZE)
+#error "PAGE_SIZE must be a multiple of FLASH_CACHE_FILL_SIZE"
+#endif
+#endif
+
 /**
  * @brief 		This function serves to set priority threshold. when the interrupt priority > Threshold flash process will disturb by interrupt.
  * @param[in]   preempt_en	- 1 can disturb by interrupt, 0 can disturb by interrupt.
@@ -43,6 +78,35 @@ void flash_plic_preempt_config(unsigned char preempt_en, unsigned char threshold
     s_flash_preempt_config.threshold = threshold;
 }
 
+static unsigned int flash_timeout_update(unsigned int cur, unsigned int us)
+{
+    if (!us) {
+        return cur;
+    }
+    return us < FLASH_TIMEOUT_MAX_US ? us : FLASH_TIMEOUT_MAX_US;
+}
+
+/**
+ * @brief 		This function serves to set the busy timeouts of program/erase/status write, e.g. from SFDP.
+ * 				A zero field keeps the current value, values are limited to FLASH_TIMEOUT_MAX_US.
+ * @param[in]   timeout	- timeouts in us.
+ * @return    	none.
+ */
+void flash_set_timeout(const flash_timeout_t *timeout)
+{
+    s_flash_timeout.page_program = flash_timeout_update(s_flash_timeout.page_program, timeout->page_program);
+    s_flash_timeout.sector_erase = flash_timeout_update(s_flash_timeout.sector_erase, timeout->sector_erase);
+    s_flash_timeout.block32k_erase = flash_timeout_update(s_flash_timeout.block32k_erase, timeout->block32k_erase);
+    s_flash_timeout.block64k_erase = flash_timeout_update(s_flash_timeout.block64k_erase, timeout->block64k_erase);
+    s_flash_timeout.chip_erase = flash_timeout_update(s_flash_timeout.chip_erase, timeout->chip_erase);
+    s_flash_timeout.status_write = flash_timeout_update(s_flash_timeout.status_write, timeout->status_write);
+}
+
+unsigned int flash_get_timeout_count(void)
+{
+    return flash_timeout_cnt;
+}
+
 /********************************************************************************************************
  *								Functions for internal use in flash,
  *		There is no need to add an evasion solution to solve the problem of access flash conflicts.
@@ -88,21 +152,139 @@ _attribute_ram_code_sec_noinline_ static void flash_send_addr(unsigned int addr)
 }
 
 /**
- * @brief     This function serves to wait flash done.(make this a asynchorous version).
+ * @brief		This function serves to send the data of a page program.
+ * 				MSPI only takes one byte per transfer, the buffer is loaded by word when it is aligned
+ * 				so that the loop is only the data register write and the busy poll.
+ * @param[in]	buf	- the data.
+ * @param[in]	len	- the length of data.
+ * @return		none.
+ */
+_attribute_ram_code_sec_noinline_ static void flash_send_data(const unsigned char *buf, unsigned long len)
+{
+    if (!((unsigned long)buf & 0x03)) {
+        const unsigned int *word = (const unsigned int *)buf;
+        for (; len >= 4; len -= 4) {
+            unsigned int w = *word++;
+            mspi_write((unsigned char)w);
+            mspi_wait();
+            mspi_write((unsigned char)(w >> 8));
+            mspi_wait();
+            mspi_write((unsigned char)(w >> 16));
+            mspi_wait();
+            mspi_write((unsigned char)(w >> 24));
+            mspi_wait();
+        }
+        buf = (const unsigned char *)word;
+    }
+
+    while (len--) {
+        mspi_write(*buf++);
+        mspi_wait();
+    }
+}
+
+/**
+ * @brief     This function serves to reset a flash which does not finish an operation, called with CS high.
+ * 			  The reset aborts the program or erase, the area is left partly written.
  * @return    none.
  */
-_attribute_ram_code_sec_noinline_ static void flash_wait_done(void)
+_attribute_ram_code_sec_noinline_ static void flash_reset(void)
+{
+    flash_send_cmd(FLASH_ENABLE_RESET);
+    mspi_high();
+    flash_send_cmd(FLASH_ENABLE_RESET_CMD);
+    mspi_high();
+    delay_us(FLASH_RESET_US);
+}
+
+/**
+ * @brief     This function serves to wait flash done.(make this a asynchorous version).
+ * 			  An overrun of the timeout is counted (see flash_get_timeout_count) and the wait goes on, since
+ * 			  XIP must not resume on a busy flash. After FLASH_TIMEOUT_HARD_FACTOR times the timeout the flash
+ * 			  is reset and the operation fails.
+ * @param[in] timeout_us	- the longest time the operation may take, see flash_set_timeout.
+ * @return    0: done, -1: the flash did not finish and was reset.
+ */
+_attribute_ram_code_sec_noinline_ static int flash_wait_done(unsigned int timeout_us)
 {
+    unsigned int start = stimer_get_tick();
+    unsigned int hard_us = (timeout_us < FLASH_TIMEOUT_MAX_US / FLASH_TIMEOUT_HARD_FACTOR)
+                               ? timeout_us * FLASH_TIMEOUT_HARD_FACTOR
+                               : FLASH_TIMEOUT_MAX_US;
+    int overrun = 0;
+
     flash_send_cmd(FLASH_READ_STATUS_CMD);
 
-    int i;
-    for (i = 0; i < 10000000; ++i) {
-        if (!flash_is_busy()) {
-            flash_cnt++;
-            break;
+    // the status register is output continuously while CS is low, each poll costs one byte of clock
+    while (flash_is_busy()) {
+        unsigned int elapsed = stimer_get_tick() - start;
+        if (!overrun && elapsed >= timeout_us * SYSTEM_TIMER_TICK_1US) {
+            overrun = 1;
+            flash_timeout_cnt++;
+        }
+        if (elapsed >= hard_us * SYSTEM_TIMER_TICK_1US) {
+            mspi_high();
+            flash_reset();
+            return -1;
         }
     }
+    flash_cnt++;
     mspi_high();
+    return 0;
+}
+
+/**
+ * @brief		This function serves to wait flash done after the command phase, with interrupts disabled.
+ * 				If preemption is configured by flash_plic_preempt_config, interrupts above the threshold are
+ * 				enabled while the flash is busy, their handlers must run from RAM and must not access flash.
+ * @param[in]	r			- the value returned by core_interrupt_disable before the command phase.
+ * @param[in]	timeout_us	- the longest time the operation may take.
+ * @return		0: done, -1: failed, see flash_wait_done.
+ */
+_attribute_ram_code_sec_noinline_ static int flash_wait_done_preempt(unsigned int r, unsigned int timeout_us)
+{
+    int ret;
+
+    if (g_plic_preempt_en && s_flash_preempt_config.preempt_en) {
+        unsigned char threshold = reg_irq_threshold;
+        plic_set_threshold(s_flash_preempt_config.threshold);
+        core_restore_interrupt(r);
+        ret = flash_wait_done(timeout_us);
+        core_interrupt_disable();
+        plic_set_threshold(threshold);
+    } else {
+        ret = flash_wait_done(timeout_us);
+    }
+    return ret;
+}
+
+/**
+ * @brief		This function serves to drop the cached pages of an area which is programmed or erased,
+ * 				called with interrupts disabled.
+ * @param[in]	addr	- the start address of the area.
+ * @param[in]	len		- the length of the area.
+ * @return		none.
+ */
+_attribute_ram_code_sec_noinline_ static void flash_cache_invalidate(unsigned long addr, unsigned long len)
+{
+#if FLASH_CACHE_LINE_NUM
+    unsigned int first = addr / PAGE_SIZE + 1;
+    unsigned int last = (len > 0xffffffff - addr) ? 0xffffffff : (addr + len - 1) / PAGE_SIZE + 1;
+
+    flash_cache_seq++;
+
+    for (unsigned int set = 0; set < FLASH_CACHE_SET_NUM; set++) {
+        for (unsigned int way = 0; way < FLASH_CACHE_WAY_NUM; way++) {
+            unsigned int tag = flash_cache[set][way].tag;
+            if (tag >= first && tag <= last) {
+                flash_cache[set][way].tag = 0;
+            }
+        }
+    }
+#else
+    (void)addr;
+    (void)len;
+#endif
 }
 
 /********************************************************************************************************
@@ -111,10 +293,11 @@ _attribute_ram_code_sec_noinline_ static void flash_wait_done(void)
 /**
  * @brief 		This function serves to erase a sector.
  * @param[in]   addr	- the start address of the sector needs to erase.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_erase_sector_ram(unsigned long addr)
+_attribute_ram_code_sec_noinline_ int flash_erase_sector_ram(unsigned long addr)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -125,19 +308,24 @@ _attribute_ram_code_sec_noinline_ void flash_erase_sector_ram(unsigned long addr
     flash_send_cmd(FLASH_SECT_ERASE_CMD);
     flash_send_addr(addr);
     mspi_high();
-    flash_wait_done();
-    CLOCK_DLY_5_CYC;
+    flash_cache_invalidate(addr, FLASH_SECTOR_SIZE);
 #if SUPPORT_PFT_ARCH
+    ret = flash_wait_done(s_flash_timeout.sector_erase);
+    CLOCK_DLY_5_CYC;
     reg_irq_threshold = 0;
 #else
+    ret = flash_wait_done_preempt(r, s_flash_timeout.sector_erase);
+    CLOCK_DLY_5_CYC;
     core_restore_interrupt(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_erase_sector(unsigned long addr)
+_attribute_text_sec_ int flash_erase_sector(unsigned long addr)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_erase_sector_ram(addr);
+    int ret = flash_erase_sector_ram(addr);
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
 }
 
 /**
@@ -145,10 +333,11 @@ _attribute_text_sec_ void flash_erase_sector(unsigned long addr)
  * @param[in]   addr	- the start address of the page.
  * @param[in]   len		- the length(in byte) of content needs to write into the page.
  * @param[in]   buf		- the start address of the content needs to write into.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_write_page_ram(unsigned long addr, unsigned long len, unsigned char *buf)
+_attribute_ram_code_sec_noinline_ int flash_write_page_ram(unsigned long addr, unsigned long len, unsigned char *buf)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -158,37 +347,46 @@ _attribute_ram_code_sec_noinline_ void flash_write_page_ram(unsigned long addr,
     flash_send_cmd(FLASH_WRITE_ENABLE_CMD);
     flash_send_cmd(FLASH_WRITE_CMD);
     flash_send_addr(addr);
-
-    unsigned int i;
-    for (i = 0; i < len; ++i) {
-        mspi_write(buf[i]); /* write data */
-        mspi_wait();
-    }
+    flash_send_data(buf, len);
     mspi_high();
-    flash_wait_done();
-    CLOCK_DLY_5_CYC;
+    flash_cache_invalidate(addr, len);
 
 #if SUPPORT_PFT_ARCH
+    ret = flash_wait_done(s_flash_timeout.page_program);
+    CLOCK_DLY_5_CYC;
     reg_irq_threshold = 0;
 #else
+    ret = flash_wait_done_preempt(r, s_flash_timeout.page_program);
+    CLOCK_DLY_5_CYC;
     core_restore_interrupt(r);                  // ???irq_restore(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_write_page(unsigned long addr, unsigned long len, unsigned char *buf)
+_attribute_text_sec_ int flash_write_page(unsigned long addr, unsigned long len, unsigned char *buf)
 {
     unsigned int ns = PAGE_SIZE - (addr & 0xff);
     int nw = 0;
+    int ret;
+
+    if (len == 0) {
+        return 0;
+    }
 
+    /* one program command per flash page, an aligned full page is a single command */
     do {
         nw = len > ns ? ns : len;
         __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-        flash_write_page_ram(addr, nw, buf);
+        ret = flash_write_page_ram(addr, nw, buf);
         __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+        if (ret) {
+            return ret;
+        }
         ns = PAGE_SIZE;
         addr += nw;
         buf += nw;
         len -= nw;
     } while (len > 0);
+    return 0;
 }
 
 /**
@@ -227,19 +425,119 @@ _attribute_ram_code_sec_noinline_ void flash_read_page_ram(unsigned long addr, u
     core_restore_interrupt(r);                  // ???irq_restore(r);
 #endif
 }
+#if FLASH_CACHE_LINE_NUM
+/**
+ * @brief 		This function serves to read a small area inside one page through the page cache,
+ * 				a miss reads the whole page into the line chosen by round robin in its set.
+ * 				The line is filled FLASH_CACHE_FILL_SIZE bytes at a time with interrupts enabled in between,
+ * 				it is marked filling so that a miss of another task picks another line or reads directly.
+ * 				If an interrupt or task programs, erases or fills meanwhile the line is dropped and the area
+ * 				is read directly.
+ * @param[in]   addr	- the start address.
+ * @param[in]   len		- the length, the area must not cross a page.
+ * @param[out]  buf		- the start address of the buffer.
+ * @return 		none.
+ */
+_attribute_ram_code_sec_noinline_ static void flash_read_page_cached_ram(unsigned long addr, unsigned long len,
+                                                                         unsigned char *buf)
+{
+    unsigned int tag = addr / PAGE_SIZE + 1;
+    unsigned int set = tag % FLASH_CACHE_SET_NUM;
+    flash_cache_line_t *line = 0;
+    unsigned int r = core_interrupt_disable();
+
+    for (unsigned int way = 0; way < FLASH_CACHE_WAY_NUM; way++) {
+        if (flash_cache[set][way].tag == tag) {
+            line = &flash_cache[set][way];
+            break;
+        }
+    }
+
+    if (line) {
+        flash_cache_hit++;
+    } else {
+        unsigned int seq;
+
+        for (unsigned int way = 0; way < FLASH_CACHE_WAY_NUM && !line; way++) {
+            unsigned int victim = flash_cache_victim[set];
+            flash_cache_victim[set] = (victim + 1) % FLASH_CACHE_WAY_NUM;
+            if (!flash_cache[set][victim].filling) {
+                line = &flash_cache[set][victim];
+            }
+        }
+        flash_cache_miss++;
+        if (!line) {
+            // every line of the set is being filled by other tasks
+            core_restore_interrupt(r);
+            flash_read_page_ram(addr, len, buf);
+            return;
+        }
+        line->tag = 0;
+        line->filling = 1;
+        seq = ++flash_cache_seq;
+        core_restore_interrupt(r);
+
+        for (unsigned int off = 0; off < PAGE_SIZE; off += FLASH_CACHE_FILL_SIZE) {
+            flash_read_page_ram((addr & ~(PAGE_SIZE - 1)) + off, FLASH_CACHE_FILL_SIZE, line->data + off);
+        }
+
+        r = core_interrupt_disable();
+        line->filling = 0;
+        if (flash_cache_seq != seq) {
+            core_restore_interrupt(r);
+            flash_read_page_ram(addr, len, buf);
+            return;
+        }
+        line->tag = tag;
+    }
+
+    for (unsigned int i = 0; i < len; i++) {
+        buf[i] = line->data[(addr & (PAGE_SIZE - 1)) + i];
+    }
+
+    core_restore_interrupt(r);
+}
+#endif
+
 _attribute_text_sec_ void flash_read_page(unsigned long addr, unsigned long len, unsigned char *buf)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
+#if FLASH_CACHE_LINE_NUM
+    if (len <= FLASH_CACHE_READ_MAX && (addr & (PAGE_SIZE - 1)) + len <= PAGE_SIZE) {
+        flash_read_page_cached_ram(addr, len, buf);
+    } else {
+        flash_read_page_ram(addr, len, buf);
+    }
+#else
     flash_read_page_ram(addr, len, buf);
+#endif
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
 }
 
+/**
+ * @brief 		This function serves to get the counters of the page cache in front of flash_read_page.
+ * @param[out]  hit		- reads served from the cache.
+ * @param[out]  miss	- reads which loaded a page.
+ * @return 		none.
+ */
+void flash_cache_get_stats(unsigned int *hit, unsigned int *miss)
+{
+#if FLASH_CACHE_LINE_NUM
+    *hit = flash_cache_hit;
+    *miss = flash_cache_miss;
+#else
+    *hit = 0;
+    *miss = 0;
+#endif
+}
+
 /**
  * @brief     	This function serves to erase a chip.
- * @return    	none.
+ * @return    	0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_erase_chip_ram(void)
+_attribute_ram_code_sec_noinline_ int flash_erase_chip_ram(void)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -249,28 +547,32 @@ _attribute_ram_code_sec_noinline_ void flash_erase_chip_ram(void)
     flash_send_cmd(FLASH_WRITE_ENABLE_CMD);
     flash_send_cmd(FLASH_CHIP_ERASE_CMD);
     mspi_high();
-    flash_wait_done();
+    flash_cache_invalidate(0, 0xffffffff);
+    ret = flash_wait_done(s_flash_timeout.chip_erase);
     CLOCK_DLY_5_CYC;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 0;
 #else
     core_restore_interrupt(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_erase_chip(void)
+_attribute_text_sec_ int flash_erase_chip(void)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_erase_chip_ram();
+    int ret = flash_erase_chip_ram();
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
 }
 
 /**
  * @brief     	This function serves to erase a page(256 bytes).
  * @param[in] 	addr	- the start address of the page needs to erase.
- * @return    	none.
+ * @return    	0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_erase_page_ram(unsigned int addr)
+_attribute_ram_code_sec_noinline_ int flash_erase_page_ram(unsigned int addr)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -282,28 +584,32 @@ _attribute_ram_code_sec_noinline_ void flash_erase_page_ram(unsigned int addr)
     flash_send_cmd(FLASH_PAGE_ERASE_CMD);
     flash_send_addr(addr);
     mspi_high();
-    flash_wait_done();
+    flash_cache_invalidate(addr, PAGE_SIZE);
+    ret = flash_wait_done(s_flash_timeout.sector_erase);
     CLOCK_DLY_5_CYC;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 0;
 #else
     core_restore_interrupt(r);  // ???irq_restore(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_erase_page(unsigned int addr)
+_attribute_text_sec_ int flash_erase_page(unsigned int addr)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_erase_page_ram(addr);
+    int ret = flash_erase_page_ram(addr);
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
 }
 
 /**
  * @brief 		This function serves to erase a block(32k).
  * @param[in]   addr	- the start address of the block needs to erase.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_erase_32kblock_ram(unsigned int addr)
+_attribute_ram_code_sec_noinline_ int flash_erase_32kblock_ram(unsigned int addr)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -315,28 +621,32 @@ _attribute_ram_code_sec_noinline_ void flash_erase_32kblock_ram(unsigned int add
     flash_send_cmd(FLASH_32KBLK_ERASE_CMD);
     flash_send_addr(addr);
     mspi_high();
-    flash_wait_done();
+    flash_cache_invalidate(addr, FLASH_32KBLK_SIZE);
+    ret = flash_wait_done(s_flash_timeout.block32k_erase);
     CLOCK_DLY_5_CYC;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 0;
 #else
     core_restore_interrupt(r);  // ???irq_restore(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_erase_32kblock(unsigned int addr)
+_attribute_text_sec_ int flash_erase_32kblock(unsigned int addr)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_erase_32kblock_ram(addr);
+    int ret = flash_erase_32kblock_ram(addr);
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
 }
 
 /**
  * @brief 		This function serves to erase a block(64k).
  * @param[in]   addr	- the start address of the block needs to erase.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_erase_64kblock_ram(unsigned int addr)
+_attribute_ram_code_sec_noinline_ int flash_erase_64kblock_ram(unsigned int addr)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -348,28 +658,113 @@ _attribute_ram_code_sec_noinline_ void flash_erase_64kblock_ram(unsigned int add
     flash_send_cmd(FLASH_64KBLK_ERASE_CMD);
     flash_send_addr(addr);
     mspi_high();
-    flash_wait_done();
+    flash_cache_invalidate(addr, FLASH_64KBLK_SIZE);
+    ret = flash_wait_done(s_flash_timeout.block64k_erase);
     CLOCK_DLY_5_CYC;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 0;
 #else
     core_restore_interrupt(r);  // ???irq_restore(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_erase_64kblock(unsigned int addr)
+_attribute_text_sec_ int flash_erase_64kblock(unsigned int addr)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_erase_64kblock_ram(addr);
+    int ret = flash_erase_64kblock_ram(addr);
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
+}
+
+/**
+ * @brief 		This function serves to check whether a flash area is erased.
+ * 				It reads through MSPI, an XIP read may hit a cache line older than the last program.
+ * @param[in]   addr	- the start address.
+ * @param[in]   len		- the length, multiple of FLASH_BLANK_CHECK_SIZE.
+ * @return 		1: all bytes are 0xff, 0: not blank.
+ */
+_attribute_text_sec_ static int flash_is_blank(unsigned long addr, unsigned long len)
+{
+    unsigned int buf[FLASH_BLANK_CHECK_SIZE / 4];
+
+    for (; len; addr += FLASH_BLANK_CHECK_SIZE, len -= FLASH_BLANK_CHECK_SIZE) {
+        flash_read_page(addr, FLASH_BLANK_CHECK_SIZE, (unsigned char *)buf);
+        for (unsigned int i = 0; i < FLASH_BLANK_CHECK_SIZE / 4; i++) {
+            if (buf[i] != 0xffffffff) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 		This function serves to set the function called between two erase units of flash_erase_range.
+ * @param[in]   cb	- yield function, e.g. a task yield of the OS, 0 for none.
+ * @return 		none.
+ */
+void flash_set_erase_yield_cb(flash_yield_cb_t cb)
+{
+    flash_erase_yield_cb = cb;
+}
+
+/**
+ * @brief 		This function serves to erase a range with the largest aligned erase unit at each step (64k, 32k, 4k).
+ * 				Units which are already blank are skipped, interrupts are enabled and the yield callback
+ * 				is called between two units.
+ * @param[in]   addr	- the start address, 4k aligned.
+ * @param[in]   len		- the length, multiple of 4k.
+ * @return 		0: success, -1: addr or len not 4k aligned, -2: an erase did not finish and the flash was reset.
+ */
+_attribute_text_sec_ int flash_erase_range(unsigned long addr, unsigned long len)
+{
+    unsigned long end = addr + len;
+    unsigned long unit;
+
+    if ((addr | len) & (FLASH_SECTOR_SIZE - 1)) {
+        return -1;
+    }
+
+    while (addr < end) {
+        if (!(addr & (FLASH_64KBLK_SIZE - 1)) && end - addr >= FLASH_64KBLK_SIZE) {
+            unit = FLASH_64KBLK_SIZE;
+        } else if (!(addr & (FLASH_32KBLK_SIZE - 1)) && end - addr >= FLASH_32KBLK_SIZE) {
+            unit = FLASH_32KBLK_SIZE;
+        } else {
+            unit = FLASH_SECTOR_SIZE;
+        }
+
+        if (!flash_is_blank(addr, unit)) {
+            int ret;
+            if (unit == FLASH_64KBLK_SIZE) {
+                ret = flash_erase_64kblock(addr);
+            } else if (unit == FLASH_32KBLK_SIZE) {
+                ret = flash_erase_32kblock(addr);
+            } else {
+                ret = flash_erase_sector(addr);
+            }
+            if (ret) {
+                return -2;
+            }
+        }
+        addr += unit;
+
+        if (flash_erase_yield_cb && addr < end) {
+            flash_erase_yield_cb();
+        }
+    }
+
+    return 0;
 }
 
 /**
  * @brief 		This function write the status of flash.
  * @param[in]  	data	- the value of status.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_write_status_ram(unsigned short data)
+_attribute_ram_code_sec_noinline_ int flash_write_status_ram(unsigned short data)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -383,7 +778,7 @@ _attribute_ram_code_sec_noinline_ void flash_write_status_ram(unsigned short dat
     mspi_write((unsigned char)(data >> 8));
     mspi_wait();
     mspi_high();
-    flash_wait_done();
+    ret = flash_wait_done(s_flash_timeout.status_write);
     mspi_high();
     CLOCK_DLY_5_CYC;
 #if SUPPORT_PFT_ARCH
@@ -391,12 +786,14 @@ _attribute_ram_code_sec_noinline_ void flash_write_status_ram(unsigned short dat
 #else
     core_restore_interrupt(r);  // ???irq_restore(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_write_status(unsigned short data)
+_attribute_text_sec_ int flash_write_status(unsigned short data)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_write_status_ram(data);
+    int ret = flash_write_status_ram(data);
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
 }
 
 /**
@@ -478,10 +875,11 @@ _attribute_text_sec_ void flash_deep_powerdown(void)
  * 				(ID)number.Release from Power-Down will take the time duration of tRES1 before
  * 				the device will resume normal operation and other command are accepted.The CS#
  * 				pin must remain high during the tRES1(8us) time duration.
- * @return      none.
+ * @return      0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_release_deep_powerdown_ram(void)
+_attribute_ram_code_sec_noinline_ int flash_release_deep_powerdown_ram(void)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -491,7 +889,7 @@ _attribute_ram_code_sec_noinline_ void flash_release_deep_powerdown_ram(void)
     mspi_stop_xip();
     flash_send_cmd(FLASH_POWER_DOWN_RELEASE);
     mspi_high();
-    flash_wait_done();
+    ret = flash_wait_done(s_flash_timeout.status_write);
     mspi_high();
     CLOCK_DLY_5_CYC;
 
@@ -500,12 +898,14 @@ _attribute_ram_code_sec_noinline_ void flash_release_deep_powerdown_ram(void)
 #else
     core_restore_interrupt(r);  // ???irq_restore(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_release_deep_powerdown(void)
+_attribute_text_sec_ int flash_release_deep_powerdown(void)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_release_deep_powerdown_ram();
+    int ret = flash_release_deep_powerdown_ram();
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
 }
 
 /**
@@ -604,14 +1004,59 @@ _attribute_text_sec_ void flash_read_uid(unsigned char idcmd, unsigned char *buf
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
 }
 
+/**
+ * @brief 		This function serves to read the SFDP (Serial Flash Discoverable Parameters, JESD216) area.
+ * @param[in]   addr	- the address in the SFDP area.
+ * @param[in]   len		- the length to read.
+ * @param[out]  buf		- the start address of the buffer.
+ * @return 		none.
+ */
+_attribute_ram_code_sec_noinline_ void flash_read_sfdp_ram(unsigned long addr, unsigned long len, unsigned char *buf)
+{
+#if SUPPORT_PFT_ARCH
+    reg_irq_threshold = 1;
+#else
+    unsigned int r = core_interrupt_disable();
+#endif
+    mspi_stop_xip();
+    flash_send_cmd(FLASH_READ_SFDP_CMD);
+    flash_send_addr(addr);
+    mspi_write(0x00); /* 8 dummy clocks */
+    mspi_wait();
+
+    mspi_write(0x00); /* dummy,  to issue clock */
+    mspi_wait();
+    mspi_fm_rd_en(); /* auto mode, mspi_get() automatically triggers mspi_write(0x00) once. */
+    mspi_wait();
+    for (unsigned int i = 0; i < len; ++i) {
+        *buf++ = mspi_get();
+        mspi_wait();
+    }
+    mspi_fm_rd_dis(); /* off read auto mode */
+    mspi_high();
+    CLOCK_DLY_5_CYC;
+#if SUPPORT_PFT_ARCH
+    reg_irq_threshold = 0;
+#else
+    core_restore_interrupt(r);
+#endif
+}
+_attribute_text_sec_ void flash_read_sfdp(unsigned long addr, unsigned long len, unsigned char *buf)
+{
+    __asm__("csrci 	mmisc_ctl,8");  // disable BTB
+    flash_read_sfdp_ram(addr, len, buf);
+    __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+}
+
 /**
  * @brief 		This function serves to set the protection area of the flash.
  * @param[in]   type	- flash type include Puya.
  * @param[in]   data	- refer to Driver API Doc.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_lock_ram(flash_type_e type, unsigned short data)
+_attribute_ram_code_sec_noinline_ int flash_lock_ram(flash_type_e type, unsigned short data)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -628,7 +1073,7 @@ _attribute_ram_code_sec_noinline_ void flash_lock_ram(flash_type_e type, unsigne
     }
     mspi_wait();
     mspi_high();
-    flash_wait_done();
+    ret = flash_wait_done(s_flash_timeout.status_write);
     mspi_high();
     CLOCK_DLY_5_CYC;
 
@@ -637,21 +1082,24 @@ _attribute_ram_code_sec_noinline_ void flash_lock_ram(flash_type_e type, unsigne
 #else
     core_restore_interrupt(r);  // ???irq_restore(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_lock(flash_type_e type, unsigned short data)
+_attribute_text_sec_ int flash_lock(flash_type_e type, unsigned short data)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_lock_ram(type, data);
+    int ret = flash_lock_ram(type, data);
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
 }
 
 /**
  * @brief 		This function serves to flash release protection.
  * @param[in]   type	- flash type include Puya.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_ram_code_sec_noinline_ void flash_unlock_ram(flash_type_e type)
+_attribute_ram_code_sec_noinline_ int flash_unlock_ram(flash_type_e type)
 {
+    int ret;
 #if SUPPORT_PFT_ARCH
     reg_irq_threshold = 1;
 #else
@@ -668,7 +1116,7 @@ _attribute_ram_code_sec_noinline_ void flash_unlock_ram(flash_type_e type)
     }
     mspi_wait();
     mspi_high();
-    flash_wait_done();
+    ret = flash_wait_done(s_flash_timeout.status_write);
     mspi_high();
     CLOCK_DLY_5_CYC;
 #if SUPPORT_PFT_ARCH
@@ -676,12 +1124,14 @@ _attribute_ram_code_sec_noinline_ void flash_unlock_ram(flash_type_e type)
 #else
     core_restore_interrupt(r);  // ???irq_restore(r);
 #endif
+    return ret;
 }
-_attribute_text_sec_ void flash_unlock(flash_type_e type)
+_attribute_text_sec_ int flash_unlock(flash_type_e type)
 {
     __asm__("csrci 	mmisc_ctl,8");  // disable BTB
-    flash_unlock_ram(type);
+    int ret = flash_unlock_ram(type);
     __asm__("csrsi 	mmisc_ctl,8");  // enable BTB
+    return ret;
 }
 /**
  * @brief 		This function is used to update the configuration parameters of xip(eXecute In Place),
@@ -74,6 +74,9 @@ typedef enum {
     FLASH_DISABLE_SO_TO_OUTPUT = 0x80,
 } flash_command_e;
 
+/* JESD216 read SFDP, the same opcode as FLASH_XTX_READ_UID_CMD so it is not part of flash_command_e */
+#define FLASH_READ_SFDP_CMD 0x5A
+
 /**
  * @brief     flash type definition
  */
@@ -107,48 +110,107 @@ typedef struct {
     unsigned char flash_read_addr_line : 1; /**< 0:single line;  1:the same to dat_line_h */
     unsigned char flash_read_cmd_line : 1;  /**< 0:single line;  1:the same to dat_line_h */
 } flash_xip_config_t;
+
+#define FLASH_SECTOR_SIZE      0x1000
+#define FLASH_32KBLK_SIZE      0x8000
+#define FLASH_64KBLK_SIZE      0x10000
+#define FLASH_BLANK_CHECK_SIZE 64
+
+/* lines of the page cache in front of flash_read_page, 0 to disable. Reads up to FLASH_CACHE_READ_MAX bytes
+   inside one page go through the cache, programs and erases by this driver invalidate it. */
+#ifndef FLASH_CACHE_LINE_NUM
+#define FLASH_CACHE_LINE_NUM 8
+#endif
+#define FLASH_CACHE_READ_MAX 32
+/* a miss fills the line in pieces of this size, interrupts are enabled between the pieces */
+#define FLASH_CACHE_FILL_SIZE 32
+
+typedef void (*flash_yield_cb_t)(void);
+
+/* default busy timeouts, used until flash_set_timeout is called (e.g. by flash_sfdp_init) */
+#define FLASH_TIMEOUT_PAGE_PROGRAM_US  10000
+#define FLASH_TIMEOUT_SECTOR_ERASE_US  500000
+#define FLASH_TIMEOUT_32KBLK_ERASE_US  2000000
+#define FLASH_TIMEOUT_64KBLK_ERASE_US  3000000
+#define FLASH_TIMEOUT_CHIP_ERASE_US    60000000
+#define FLASH_TIMEOUT_STATUS_WRITE_US  50000
+#define FLASH_TIMEOUT_MAX_US           0x0fffffff  // system timer tick must not overflow
+/* a busy wait gives up after this many times the timeout, resets the flash and the operation fails */
+#define FLASH_TIMEOUT_HARD_FACTOR      4
+/* wait after the reset, tRST after an aborted erase is up to 12ms on common parts */
+#define FLASH_RESET_US                 12000
+
+/**
+ * @brief	busy timeouts in us
+ */
+typedef struct {
+    unsigned int page_program;
+    unsigned int sector_erase;
+    unsigned int block32k_erase;
+    unsigned int block64k_erase;
+    unsigned int chip_erase;
+    unsigned int status_write;
+} flash_timeout_t;
+
 /**
  * @brief     	This function serves to erase a page(256 bytes).
  * @param[in] 	addr	- the start address of the page needs to erase.
- * @return    	none.
+ * @return    	0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_erase_page(unsigned int addr);
+_attribute_text_sec_ int flash_erase_page(unsigned int addr);
 
 /**
  * @brief 		This function serves to erase a sector.
  * @param[in]   addr	- the start address of the sector needs to erase.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_erase_sector(unsigned long addr);
+_attribute_text_sec_ int flash_erase_sector(unsigned long addr);
 
 /**
  * @brief 		This function serves to erase a block(32k).
  * @param[in]   addr	- the start address of the block needs to erase.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_erase_32kblock(unsigned int addr);
+_attribute_text_sec_ int flash_erase_32kblock(unsigned int addr);
 
 /**
  * @brief 		This function serves to erase a block(64k).
  * @param[in]   addr	- the start address of the block needs to erase.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_erase_64kblock(unsigned int addr);
+_attribute_text_sec_ int flash_erase_64kblock(unsigned int addr);
 
 /**
  * @brief     	This function serves to erase a chip.
- * @return    	none.
+ * @return    	0: done, -1: the flash did not finish in time and was reset.
+ */
+_attribute_text_sec_ int flash_erase_chip(void);
+
+/**
+ * @brief 		This function serves to set the function called between two erase units of flash_erase_range.
+ * @param[in]   cb	- yield function, e.g. a task yield of the OS, 0 for none.
+ * @return 		none.
+ */
+void flash_set_erase_yield_cb(flash_yield_cb_t cb);
+
+/**
+ * @brief 		This function serves to erase a range with the largest aligned erase unit at each step (64k, 32k, 4k).
+ * 				Units which are already blank are skipped, interrupts are enabled and the yield callback
+ * 				is called between two units.
+ * @param[in]   addr	- the start address, 4k aligned.
+ * @param[in]   len		- the length, multiple of 4k.
+ * @return 		0: success, -1: addr or len not 4k aligned, -2: an erase did not finish and the flash was reset.
  */
-_attribute_text_sec_ void flash_erase_chip(void);
+_attribute_text_sec_ int flash_erase_range(unsigned long addr, unsigned long len);
 
 /**
  * @brief 		This function writes the buffer's content to a page.
  * @param[in]   addr	- the start address of the page.
  * @param[in]   len		- the length(in byte) of content needs to write into the page.
  * @param[in]   buf		- the start address of the content needs to write into.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_write_page(unsigned long addr, unsigned long len, unsigned char *buf);
+_attribute_text_sec_ int flash_write_page(unsigned long addr, unsigned long len, unsigned char *buf);
 
 /**
  * @brief 		This function reads the content from a page to the buf.
@@ -159,12 +221,20 @@ _attribute_text_sec_ void flash_write_page(unsigned long addr, unsigned long len
  */
 _attribute_text_sec_ void flash_read_page(unsigned long addr, unsigned long len, unsigned char *buf);
 
+/**
+ * @brief 		This function serves to get the counters of the page cache in front of flash_read_page.
+ * @param[out]  hit		- reads served from the cache.
+ * @param[out]  miss	- reads which loaded a page.
+ * @return 		none.
+ */
+void flash_cache_get_stats(unsigned int *hit, unsigned int *miss);
+
 /**
  * @brief 		This function write the status of flash.
  * @param[in]  	data	- the value of status.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_write_status(unsigned short data);
+_attribute_text_sec_ int flash_write_status(unsigned short data);
 
 /**
  * @brief 		This function reads the status of flash.
@@ -189,9 +259,9 @@ _attribute_text_sec_ void flash_deep_powerdown(void);
  * 				(ID)number.Release from Power-Down will take the time duration of tRES1 before
  * 				the device will resume normal operation and other command are accepted.The CS#
  * 				pin must remain high during the tRES1(8us) time duration.
- * @return      none.
+ * @return      0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_release_deep_powerdown(void);
+_attribute_text_sec_ int flash_release_deep_powerdown(void);
 
 /**
  * @brief	  	This function serves to read MID of flash(MAC id). Before reading UID of flash,
@@ -222,16 +292,16 @@ _attribute_text_sec_ int flash_read_mid_uid_with_check(unsigned int *flash_mid,
  * @brief 		This function serves to set the protection area of the flash.
  * @param[in]   type	- flash type include Puya.
  * @param[in]   data	- refer to Driver API Doc.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_lock(flash_type_e type, unsigned short data);
+_attribute_text_sec_ int flash_lock(flash_type_e type, unsigned short data);
 
 /**
  * @brief 		This function serves to flash release protection.
  * @param[in]   type	- flash type include Puya.
- * @return 		none.
+ * @return 		0: done, -1: the flash did not finish in time and was reset.
  */
-_attribute_text_sec_ void flash_unlock(flash_type_e type);
+_attribute_text_sec_ int flash_unlock(flash_type_e type);
 
 /**
  * @brief 		This function serves to set priority threshold. when the interrupt priority > Threshold flash process will disturb by interrupt.
@@ -240,6 +310,32 @@ _attribute_text_sec_ void flash_unlock(flash_type_e type);
  * @return    	none.
  */
 _attribute_text_sec_ void flash_plic_preempt_config(unsigned char preempt_en, unsigned char threshold);
+
+/**
+ * @brief 		This function serves to set the busy timeouts of program/erase/status write, e.g. from SFDP.
+ * 				A zero field keeps the current value, values are limited to FLASH_TIMEOUT_MAX_US.
+ * @param[in]   timeout	- timeouts in us.
+ * @return    	none.
+ */
+void flash_set_timeout(const flash_timeout_t *timeout);
+
+/**
+ * @brief 		This function serves to get how often a program/erase/status write was still busy after its
+ * 				timeout. The driver keeps waiting in that case, XIP must not resume while the flash is busy,
+ * 				up to FLASH_TIMEOUT_HARD_FACTOR times the timeout. Then it resets the flash and the operation
+ * 				returns -1.
+ * @return 		the number of overruns since power on.
+ */
+unsigned int flash_get_timeout_count(void);
+
+/**
+ * @brief 		This function serves to read the SFDP (Serial Flash Discoverable Parameters, JESD216) area.
+ * @param[in]   addr	- the address in the SFDP area.
+ * @param[in]   len		- the length to read.
+ * @param[out]  buf		- the start address of the buffer.
+ * @return 		none.
+ */
+_attribute_text_sec_ void flash_read_sfdp(unsigned long addr, unsigned long len, unsigned char *buf);
 /**
  * @brief 		This function is used to update the configuration parameters of xip(eXecute In Place),
  * 				this configuration will affect the speed of MCU fetching,
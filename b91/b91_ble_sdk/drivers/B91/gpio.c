@@ -16,6 +16,7 @@
  *
  *****************************************************************************/
 #include "gpio.h"
+#include "ext_driver/pm_retention.h"
 
 /**********************************************************************************************************************
  *                                			  local constants                                                       *
@@ -28,6 +29,18 @@
 /**********************************************************************************************************************
  *                                             local data type                                                     *
  *********************************************************************************************************************/
+/* digital gpio registers lost in deep retention, PC/PD ie/ds/pull-up are analog and kept */
+typedef struct {
+    unsigned int setting[12];  // 0x140300 ~ 0x14032f: setting1/setting2 of PA ~ PF
+    unsigned int fs[2];        // 0x140330 ~ 0x140337: PA ~ PD function mux
+    unsigned short fs_pe;      // 0x140350
+    unsigned short fs_pf;      // 0x140356
+    unsigned char irq_risc0[6];
+    unsigned char irq_risc1[6];
+    unsigned char irq_risc_mask;
+    unsigned char irq_ctrl;
+    unsigned char pad_mul_sel;
+} gpio_retention_ctx_t;
 
 /**********************************************************************************************************************
  *                                              global variable                                                       *
@@ -36,10 +49,13 @@
 /**********************************************************************************************************************
  *                                              local variable                                                     *
  *********************************************************************************************************************/
+_attribute_data_retention_sec_ static gpio_retention_ctx_t gpio_retention_ctx;
 
 /**********************************************************************************************************************
  *                                          local function prototype                                               *
  *********************************************************************************************************************/
+static void gpio_retention_save(void *ctx);
+static void gpio_retention_restore(const void *ctx);
 
 /**********************************************************************************************************************
  *                                         global function implementation                                             *
@@ -355,6 +371,73 @@ void gpio_set_pullup_res_30k(gpio_pin_e pin)
     }
 }
 
+/**
+ * @brief     This function serves to register the gpio registers to pm_retention, so that
+ *            pm_retention_restore_all brings back all pin settings after deep retention wakeup.
+ * @return    none.
+ */
+void gpio_retention_register(void)
+{
+    pm_ret_node_t node = {
+        .save = gpio_retention_save,
+        .restore = gpio_retention_restore,
+        .ctx = &gpio_retention_ctx,
+        .dep_mask = 0,
+    };
+
+    pm_retention_register(PM_RET_ID_GPIO, &node);
+}
+
 /**********************************************************************************************************************
   *                    						local function implementation                                             *
   *********************************************************************************************************************/
+/**
+ * @brief     This function serves to save the digital gpio registers before deep retention.
+ * @param[in] ctx - gpio_retention_ctx_t.
+ * @return    none.
+ */
+static void gpio_retention_save(void *ctx)
+{
+    gpio_retention_ctx_t *p = (gpio_retention_ctx_t *)ctx;
+
+    for (int i = 0; i < 12; i++) {
+        p->setting[i] = REG_ADDR32(0x140300 + (i << 2));
+    }
+    p->fs[0] = REG_ADDR32(0x140330);
+    p->fs[1] = REG_ADDR32(0x140334);
+    p->fs_pe = reg_gpio_pe_fs;
+    p->fs_pf = reg_gpio_pf_fs;
+    for (int i = 0; i < 6; i++) {
+        p->irq_risc0[i] = reg_gpio_irq_risc0_en(i << 8);
+        p->irq_risc1[i] = reg_gpio_irq_risc1_en(i << 8);
+    }
+    p->irq_risc_mask = reg_gpio_irq_risc_mask;
+    p->irq_ctrl = reg_gpio_irq_ctrl;
+    p->pad_mul_sel = reg_gpio_pad_mul_sel;
+}
+
+/**
+ * @brief     This function serves to write back the digital gpio registers after deep retention.
+ *            Function mux is written before output enable so that no glitch goes to the pads.
+ * @param[in] ctx - gpio_retention_ctx_t.
+ * @return    none.
+ */
+static void gpio_retention_restore(const void *ctx)
+{
+    const gpio_retention_ctx_t *p = (const gpio_retention_ctx_t *)ctx;
+
+    reg_gpio_pad_mul_sel = p->pad_mul_sel;
+    REG_ADDR32(0x140330) = p->fs[0];
+    REG_ADDR32(0x140334) = p->fs[1];
+    reg_gpio_pe_fs = p->fs_pe;
+    reg_gpio_pf_fs = p->fs_pf;
+    for (int i = 0; i < 12; i++) {
+        REG_ADDR32(0x140300 + (i << 2)) = p->setting[i];
+    }
+    for (int i = 0; i < 6; i++) {
+        reg_gpio_irq_risc0_en(i << 8) = p->irq_risc0[i];
+        reg_gpio_irq_risc1_en(i << 8) = p->irq_risc1[i];
+    }
+    reg_gpio_irq_risc_mask = p->irq_risc_mask;
+    reg_gpio_irq_ctrl = p->irq_ctrl;
+}
@@ -450,4 +450,11 @@ void gpio_set_up_down_res(gpio_pin_e pin, gpio_pull_type_e up_down_res);
  */
 void gpio_set_pullup_res_30k(gpio_pin_e pin);
 
+/**
+ * @brief     This function serves to register the gpio registers to pm_retention, so that
+ *            pm_retention_restore_all brings back all pin settings after deep retention wakeup.
+ * @return    none.
+ */
+void gpio_retention_register(void);
+
 #endif
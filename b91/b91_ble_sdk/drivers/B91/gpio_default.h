@@ -850,6 +850,16 @@
 #define PF5_FUNC AS_MSPI
 #endif
 
+#define GPIO_PULL_BYTE(p0, p1, p2, p3) ((p0) | ((p1) << 2) | ((p2) << 4) | ((p3) << 6))
+#define GPIO_BIT_BYTE(b0, b1, b2, b3, b4, b5, b6, b7)                                                              \
+    (((b0) << 0) | ((b1) << 1) | ((b2) << 2) | ((b3) << 3) | ((b4) << 4) | ((b5) << 5) | ((b6) << 6) | ((b7) << 7))
+
+#if (areg_gpio_pc_pe != areg_gpio_pc_ie + 1 || areg_gpio_pc_ds != areg_gpio_pc_ie + 2 ||                             \
+     areg_gpio_pd_ie != areg_gpio_pc_ie + 3 || areg_gpio_pd_pe != areg_gpio_pc_ie + 4 ||                             \
+     areg_gpio_pd_ds != areg_gpio_pc_ie + 5)
+#error "gpio_init writes the PC/PD analog registers as one block"
+#endif
+
 /**
  * @brief      This function servers to initiate pull up-down resistor of all gpio.
  * @param[in]  none
@@ -862,38 +872,21 @@
  */
 static inline void gpio_analog_resistance_init(void)
 {
-    // A<3:0>
-    analog_write_reg8(0x0e, PULL_WAKEUP_SRC_PA0 | (PULL_WAKEUP_SRC_PA1 << 2) | (PULL_WAKEUP_SRC_PA2 << 4) |
-                                (PULL_WAKEUP_SRC_PA3 << 6));
-    // A<7:4>
-    analog_write_reg8(0x0f, PULL_WAKEUP_SRC_PA4 | (PULL_WAKEUP_SRC_PA5 << 2) | (PULL_WAKEUP_SRC_PA6 << 4) |
-                                (PULL_WAKEUP_SRC_PA7 << 6));
-    // B<3:0>
-    analog_write_reg8(0x10, PULL_WAKEUP_SRC_PB0 | (PULL_WAKEUP_SRC_PB1 << 2) | (PULL_WAKEUP_SRC_PB2 << 4) |
-                                (PULL_WAKEUP_SRC_PB3 << 6));
-    // B<7:4>
-    analog_write_reg8(0x11, PULL_WAKEUP_SRC_PB4 | (PULL_WAKEUP_SRC_PB5 << 2) | (PULL_WAKEUP_SRC_PB6 << 4) |
-                                (PULL_WAKEUP_SRC_PB7 << 6));
+    // analog 0x0e ~ 0x17, 2 bits per pin, written in one analog bus transfer
+    unsigned char pull[10] = {
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PA0, PULL_WAKEUP_SRC_PA1, PULL_WAKEUP_SRC_PA2, PULL_WAKEUP_SRC_PA3),  // A<3:0>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PA4, PULL_WAKEUP_SRC_PA5, PULL_WAKEUP_SRC_PA6, PULL_WAKEUP_SRC_PA7),  // A<7:4>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PB0, PULL_WAKEUP_SRC_PB1, PULL_WAKEUP_SRC_PB2, PULL_WAKEUP_SRC_PB3),  // B<3:0>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PB4, PULL_WAKEUP_SRC_PB5, PULL_WAKEUP_SRC_PB6, PULL_WAKEUP_SRC_PB7),  // B<7:4>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PC0, PULL_WAKEUP_SRC_PC1, PULL_WAKEUP_SRC_PC2, PULL_WAKEUP_SRC_PC3),  // C<3:0>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PC4, PULL_WAKEUP_SRC_PC5, PULL_WAKEUP_SRC_PC6, PULL_WAKEUP_SRC_PC7),  // C<7:4>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PD0, PULL_WAKEUP_SRC_PD1, PULL_WAKEUP_SRC_PD2, PULL_WAKEUP_SRC_PD3),  // D<3:0>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PD4, PULL_WAKEUP_SRC_PD5, PULL_WAKEUP_SRC_PD6, PULL_WAKEUP_SRC_PD7),  // D<7:4>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PE0, PULL_WAKEUP_SRC_PE1, PULL_WAKEUP_SRC_PE2, PULL_WAKEUP_SRC_PE3),  // E<3:0>
+        GPIO_PULL_BYTE(PULL_WAKEUP_SRC_PE4, PULL_WAKEUP_SRC_PE5, PULL_WAKEUP_SRC_PE6, PULL_WAKEUP_SRC_PE7),  // E<7:4>
+    };
 
-    // C<3:0>
-    analog_write_reg8(0x12, PULL_WAKEUP_SRC_PC0 | (PULL_WAKEUP_SRC_PC1 << 2) | (PULL_WAKEUP_SRC_PC2 << 4) |
-                                (PULL_WAKEUP_SRC_PC3 << 6));
-    // C<7:4>
-    analog_write_reg8(0x13, PULL_WAKEUP_SRC_PC4 | (PULL_WAKEUP_SRC_PC5 << 2) | (PULL_WAKEUP_SRC_PC6 << 4) |
-                                (PULL_WAKEUP_SRC_PC7 << 6));
-
-    // D<3:0>
-    analog_write_reg8(0x14, PULL_WAKEUP_SRC_PD0 | (PULL_WAKEUP_SRC_PD1 << 2) | (PULL_WAKEUP_SRC_PD2 << 4) |
-                                (PULL_WAKEUP_SRC_PD3 << 6));
-    // D<7:4>
-    analog_write_reg8(0x15, PULL_WAKEUP_SRC_PD4 | (PULL_WAKEUP_SRC_PD5 << 2) | (PULL_WAKEUP_SRC_PD6 << 4) |
-                                (PULL_WAKEUP_SRC_PD7 << 6));
-    // E<3:0>
-    analog_write_reg8(0x16, PULL_WAKEUP_SRC_PE0 | (PULL_WAKEUP_SRC_PE1 << 2) | (PULL_WAKEUP_SRC_PE2 << 4) |
-                                (PULL_WAKEUP_SRC_PE3 << 6));
-    // E<7:4>
-    analog_write_reg8(0x17, PULL_WAKEUP_SRC_PE4 | (PULL_WAKEUP_SRC_PE5 << 2) | (PULL_WAKEUP_SRC_PE6 << 4) |
-                                (PULL_WAKEUP_SRC_PE7 << 6));
+    analog_write_buff(0x0e, pull, sizeof(pull));
 }
 
 _attribute_ram_code_sec_ static inline void gpio_init(int anaRes_init_en)
@@ -934,13 +927,20 @@ _attribute_ram_code_sec_ static inline void gpio_init(int anaRes_init_en)
                            (PB4_FUNC == AS_GPIO ? BIT(20) : 0) | (PB5_FUNC == AS_GPIO ? BIT(21) : 0) |
                            (PB6_FUNC == AS_GPIO ? BIT(22) : 0) | (PB7_FUNC == AS_GPIO ? BIT(23) : 0);
 
-    // PC group
-    // ie
-    analog_write_reg8(areg_gpio_pc_ie, (PC0_INPUT_ENABLE << 0) | (PC1_INPUT_ENABLE << 1) | (PC2_INPUT_ENABLE << 2) |
-                                           (PC3_INPUT_ENABLE << 3) | (PC4_INPUT_ENABLE << 4) |
-                                           (PC5_INPUT_ENABLE << 5) | (PC6_INPUT_ENABLE << 6) |
-                                           (PC7_INPUT_ENABLE << 7));
+    // PC/PD ie, pe, ds are adjacent analog registers, one read and one write keep the pull enables
+    unsigned char ana[6];
+    analog_read_buff(areg_gpio_pc_ie, ana, sizeof(ana));
+    ana[0] = GPIO_BIT_BYTE(PC0_INPUT_ENABLE, PC1_INPUT_ENABLE, PC2_INPUT_ENABLE, PC3_INPUT_ENABLE, PC4_INPUT_ENABLE,
+                           PC5_INPUT_ENABLE, PC6_INPUT_ENABLE, PC7_INPUT_ENABLE);
+    ana[2] = GPIO_BIT_BYTE(PC0_DATA_STRENGTH, PC1_DATA_STRENGTH, PC2_DATA_STRENGTH, PC3_DATA_STRENGTH,
+                           PC4_DATA_STRENGTH, PC5_DATA_STRENGTH, PC6_DATA_STRENGTH, PC7_DATA_STRENGTH);
+    ana[3] = GPIO_BIT_BYTE(PD0_INPUT_ENABLE, PD1_INPUT_ENABLE, PD2_INPUT_ENABLE, PD3_INPUT_ENABLE, PD4_INPUT_ENABLE,
+                           PD5_INPUT_ENABLE, PD6_INPUT_ENABLE, PD7_INPUT_ENABLE);
+    ana[5] = GPIO_BIT_BYTE(PD0_DATA_STRENGTH, PD1_DATA_STRENGTH, PD2_DATA_STRENGTH, PD3_DATA_STRENGTH,
+                           PD4_DATA_STRENGTH, PD5_DATA_STRENGTH, PD6_DATA_STRENGTH, PD7_DATA_STRENGTH);
+    analog_write_buff(areg_gpio_pc_ie, ana, sizeof(ana));
 
+    // PC group
     // oen
     reg_gpio_pc_oen = ((PC0_OUTPUT_ENABLE ? 0 : 1) << 0) | ((PC1_OUTPUT_ENABLE ? 0 : 1) << 1) |
                       ((PC2_OUTPUT_ENABLE ? 0 : 1) << 2) | ((PC3_OUTPUT_ENABLE ? 0 : 1) << 3) |
@@ -950,24 +950,12 @@ _attribute_ram_code_sec_ static inline void gpio_init(int anaRes_init_en)
     reg_gpio_pc_out = (PC0_DATA_OUT << 0) | (PC1_DATA_OUT << 1) | (PC2_DATA_OUT << 2) | (PC3_DATA_OUT << 3) |
                       (PC4_DATA_OUT << 4) | (PC5_DATA_OUT << 5) | (PC6_DATA_OUT << 6) | (PC7_DATA_OUT << 7);
 
-    // ds
-    analog_write_reg8(areg_gpio_pc_ds, (PC0_DATA_STRENGTH << 0) | (PC1_DATA_STRENGTH << 1) | (PC2_DATA_STRENGTH << 2) |
-                                           (PC3_DATA_STRENGTH << 3) | (PC4_DATA_STRENGTH << 4) |
-                                           (PC5_DATA_STRENGTH << 5) | (PC6_DATA_STRENGTH << 6) |
-                                           (PC7_DATA_STRENGTH << 7));
-
     reg_gpio_pc_gpio = (PC0_FUNC == AS_GPIO ? BIT(0) : 0) | (PC1_FUNC == AS_GPIO ? BIT(1) : 0) |
                        (PC2_FUNC == AS_GPIO ? BIT(2) : 0) | (PC3_FUNC == AS_GPIO ? BIT(3) : 0) |
                        (PC4_FUNC == AS_GPIO ? BIT(4) : 0) | (PC5_FUNC == AS_GPIO ? BIT(5) : 0) |
                        (PC6_FUNC == AS_GPIO ? BIT(6) : 0) | (PC7_FUNC == AS_GPIO ? BIT(7) : 0);
 
     // PD group
-    // ie
-    analog_write_reg8(areg_gpio_pd_ie, (PD0_INPUT_ENABLE << 0) | (PD1_INPUT_ENABLE << 1) | (PD2_INPUT_ENABLE << 2) |
-                                           (PD3_INPUT_ENABLE << 3) | (PD4_INPUT_ENABLE << 4) |
-                                           (PD5_INPUT_ENABLE << 5) | (PD6_INPUT_ENABLE << 6) |
-                                           (PD7_INPUT_ENABLE << 7));
-
     // oen
     reg_gpio_pd_oen = ((PD0_OUTPUT_ENABLE ? 0 : 1) << 0) | ((PD1_OUTPUT_ENABLE ? 0 : 1) << 1) |
                       ((PD2_OUTPUT_ENABLE ? 0 : 1) << 2) | ((PD3_OUTPUT_ENABLE ? 0 : 1) << 3) |
@@ -977,12 +965,6 @@ _attribute_ram_code_sec_ static inline void gpio_init(int anaRes_init_en)
     reg_gpio_pd_out = (PD0_DATA_OUT << 0) | (PD1_DATA_OUT << 1) | (PD2_DATA_OUT << 2) | (PD3_DATA_OUT << 3) |
                       (PD4_DATA_OUT << 4) | (PD5_DATA_OUT << 5) | (PD6_DATA_OUT << 6) | (PD7_DATA_OUT << 7);
 
-    // ds
-    analog_write_reg8(areg_gpio_pd_ds, (PD0_DATA_STRENGTH << 0) | (PD1_DATA_STRENGTH << 1) | (PD2_DATA_STRENGTH << 2) |
-                                           (PD3_DATA_STRENGTH << 3) | (PD4_DATA_STRENGTH << 4) |
-                                           (PD5_DATA_STRENGTH << 5) | (PD6_DATA_STRENGTH << 6) |
-                                           (PD7_DATA_STRENGTH << 7));
-
     reg_gpio_pd_gpio = (PD0_FUNC == AS_GPIO ? BIT(0) : 0) | (PD1_FUNC == AS_GPIO ? BIT(1) : 0) |
                        (PD2_FUNC == AS_GPIO ? BIT(2) : 0) | (PD3_FUNC == AS_GPIO ? BIT(3) : 0) |
                        (PD4_FUNC == AS_GPIO ? BIT(4) : 0) | (PD5_FUNC == AS_GPIO ? BIT(5) : 0) |
@@ -16,9 +16,20 @@
  *
  *****************************************************************************/
 #include "i2c.h"
+#include "ext_driver/pm_retention.h"
 
-static unsigned char i2c_dma_tx_chn;
-static unsigned char i2c_dma_rx_chn;
+/* i2c registers lost in deep retention */
+typedef struct {
+    unsigned char sp;
+    unsigned char id;
+    unsigned char sct0;
+    unsigned char slave_strech_en;
+    unsigned char dma_cfg;  // BIT(0): tx dma configured, BIT(1): rx dma configured
+} i2c_retention_ctx_t;
+
+_attribute_data_retention_sec_ static unsigned char i2c_dma_tx_chn;
+_attribute_data_retention_sec_ static unsigned char i2c_dma_rx_chn;
+_attribute_data_retention_sec_ static i2c_retention_ctx_t i2c_retention_ctx;
 
 dma_config_t i2c_tx_dma_config = {
     .dst_req_sel = DMA_REQ_I2C_TX,  // tx req
@@ -55,7 +66,7 @@ dma_config_t i2c_rx_dma_config = {
  * This parameter is 0x20 by default, that is, each write or read API opens the stop command.
  * if g_i2c_stop_en=0x00,it means every write or read API will disable stop command.
  */
-unsigned char g_i2c_stop_en = 0x20;
+_attribute_data_retention_sec_ unsigned char g_i2c_stop_en = 0x20;
 
 /**
  * @brief      The function of this interface is equivalent to that after the user finishes calling the write or read interface, the stop signal is not sent,
@@ -335,7 +346,7 @@ void i2c_master_read_dma(unsigned char id, unsigned char *data, unsigned char le
     reg_i2c_id = (id | FLD_I2C_WRITE_READ_BIT);  // BIT(0):R:High  W:Low
 
     dma_set_size(i2c_dma_rx_chn, len, DMA_WORD_WIDTH);
-    dma_set_address(i2c_dma_rx_chn, reg_i2c_data_buf0_addr, (unsigned int)convert_ram_addr_cpu2bus(rx_data));
+    dma_set_address(i2c_dma_rx_chn, reg_i2c_data_buf0_addr, (unsigned int)convert_ram_addr_cpu2bus(data));
     dma_chn_en(i2c_dma_rx_chn);
 
     reg_i2c_len = len;
@@ -411,6 +422,7 @@ void i2c_slave_write(unsigned char *data, unsigned char len)
 void i2c_set_tx_dma_config(dma_chn_e chn)
 {
     i2c_dma_tx_chn = chn;
+    i2c_retention_ctx.dma_cfg |= BIT(0);
     dma_config(chn, &i2c_tx_dma_config);
 }
 
@@ -422,5 +434,60 @@ void i2c_set_tx_dma_config(dma_chn_e chn)
 void i2c_set_rx_dma_config(dma_chn_e chn)
 {
     i2c_dma_rx_chn = chn;
+    i2c_retention_ctx.dma_cfg |= BIT(1);
     dma_config(chn, &i2c_rx_dma_config);
 }
+
+/**
+ * @brief     This function serves to save the i2c registers before deep retention.
+ * @param[in] ctx - i2c_retention_ctx_t.
+ * @return    none
+ */
+static void i2c_retention_save(void *ctx)
+{
+    i2c_retention_ctx_t *p = (i2c_retention_ctx_t *)ctx;
+
+    p->sp = reg_i2c_sp;
+    p->id = reg_i2c_id;
+    p->sct0 = reg_i2c_sct0;
+    p->slave_strech_en = reg_i2c_slave_strech_en;
+}
+
+/**
+ * @brief     This function serves to write back the i2c registers after deep retention.
+ * @param[in] ctx - i2c_retention_ctx_t.
+ * @return    none
+ */
+static void i2c_retention_restore(const void *ctx)
+{
+    const i2c_retention_ctx_t *p = (const i2c_retention_ctx_t *)ctx;
+
+    reg_i2c_sp = p->sp;
+    reg_i2c_id = p->id;
+    reg_i2c_slave_strech_en = p->slave_strech_en;
+    reg_i2c_sct0 = p->sct0;
+    if (p->dma_cfg & BIT(0)) {
+        dma_config(i2c_dma_tx_chn, &i2c_tx_dma_config);
+    }
+    if (p->dma_cfg & BIT(1)) {
+        dma_config(i2c_dma_rx_chn, &i2c_rx_dma_config);
+    }
+}
+
+/**
+ * @brief     This function serves to register i2c to pm_retention, the i2c configuration and the
+ *            dma channel setting are restored by pm_retention_restore_all after deep retention wakeup.
+ *            It depends on the gpio node which restores the i2c pins.
+ * @return    none
+ */
+void i2c_retention_register(void)
+{
+    pm_ret_node_t node = {
+        .save = i2c_retention_save,
+        .restore = i2c_retention_restore,
+        .ctx = &i2c_retention_ctx,
+        .dep_mask = BIT(PM_RET_ID_GPIO),
+    };
+
+    pm_retention_register(PM_RET_ID_I2C, &node);
+}
@@ -303,4 +303,12 @@ void i2c_set_tx_dma_config(dma_chn_e chn);
  */
 void i2c_set_rx_dma_config(dma_chn_e chn);
 
+/**
+ * @brief     This function serves to register i2c to pm_retention, the i2c configuration and the
+ *            dma channel setting are restored by pm_retention_restore_all after deep retention wakeup.
+ *            It depends on the gpio node which restores the i2c pins.
+ * @return    none
+ */
+void i2c_retention_register(void);
+
 #endif
@@ -16,6 +16,7 @@
  *
  *****************************************************************************/
 #include "uart.h"
+#include "ext_driver/pm_retention.h"
 
 /**********************************************************************************************************************
  *                                			  local constants                                                       *
@@ -30,6 +31,13 @@
 /**********************************************************************************************************************
  *                                             local data type                                                     *
  *********************************************************************************************************************/
+/* uart registers lost in deep retention */
+typedef struct {
+    unsigned int div_ctrl;    // 0x140084 ~ 0x140087: clk_div, ctrl0, ctrl1
+    unsigned int ctrl_tmo;    // 0x140088 ~ 0x14008b: ctrl2, ctrl3, rx_timeout0, rx_timeout1
+    unsigned char uart_num;
+    unsigned char dma_cfg;    // BIT(0): tx dma configured, BIT(1): rx dma configured
+} uart_retention_ctx_t;
 
 /**********************************************************************************************************************
  *                                              global variable                                                       *
@@ -103,8 +111,9 @@ dma_config_t uart_rx_dma_config[2] = {
 /**********************************************************************************************************************
  *                                              local variable                                                     *
  *********************************************************************************************************************/
-static unsigned char uart_dma_tx_chn[2];
-static unsigned char uart_dma_rx_chn[2];
+_attribute_data_retention_sec_ static unsigned char uart_dma_tx_chn[2];
+_attribute_data_retention_sec_ static unsigned char uart_dma_rx_chn[2];
+_attribute_data_retention_sec_ static uart_retention_ctx_t uart_retention_ctx[2];
 /**********************************************************************************************************************
  *                                          local function prototype                                               *
  *********************************************************************************************************************/
@@ -123,6 +132,9 @@ static unsigned char uart_is_prime(unsigned int n);
   */
 static void uart_set_fuc_pin(uart_tx_pin_e tx_pin, uart_rx_pin_e rx_pin);
 
+static void uart_retention_save(void *ctx);
+static void uart_retention_restore(const void *ctx);
+
 /**********************************************************************************************************************
  *                                         global function implementation                                             *
  *********************************************************************************************************************/
@@ -552,6 +564,7 @@ void uart_receive_dma(uart_num_e uart_num, unsigned char *addr, unsigned int rev
 void uart_set_tx_dma_config(uart_num_e uart_num, dma_chn_e chn)
 {
     uart_dma_tx_chn[uart_num] = chn;
+    uart_retention_ctx[uart_num].dma_cfg |= BIT(0);
     dma_config(chn, &uart_tx_dma_config[uart_num]);
 }
 
@@ -564,6 +577,7 @@ void uart_set_tx_dma_config(uart_num_e uart_num, dma_chn_e chn)
 void uart_set_rx_dma_config(uart_num_e uart_num, dma_chn_e chn)
 {
     uart_dma_rx_chn[uart_num] = chn;
+    uart_retention_ctx[uart_num].dma_cfg |= BIT(1);
     dma_config(chn, &uart_rx_dma_config[uart_num]);
 }
 
@@ -612,6 +626,26 @@ void uart_rts_config(uart_num_e uart_num, uart_rts_pin_e rts_pin, unsigned char
     }
 }
 
+/**
+ * @brief     This function serves to register a uart to pm_retention, the uart configuration and the
+ *            dma channel setting are restored by pm_retention_restore_all after deep retention wakeup.
+ *            It depends on the gpio node which restores the uart pins.
+ * @param[in] uart_num - UART0 or UART1.
+ * @return    none
+ */
+void uart_retention_register(uart_num_e uart_num)
+{
+    pm_ret_node_t node = {
+        .save = uart_retention_save,
+        .restore = uart_retention_restore,
+        .ctx = &uart_retention_ctx[uart_num],
+        .dep_mask = BIT(PM_RET_ID_GPIO),
+    };
+
+    uart_retention_ctx[uart_num].uart_num = uart_num;
+    pm_retention_register(uart_num == UART0 ? PM_RET_ID_UART0 : PM_RET_ID_UART1, &node);
+}
+
 /**********************************************************************************************************************
   *                    						local function implementation                                             *
   *********************************************************************************************************************/
@@ -698,3 +732,35 @@ static void uart_set_fuc_pin(uart_tx_pin_e tx_pin, uart_rx_pin_e rx_pin)
     gpio_function_dis(tx_pin);
     gpio_function_dis(rx_pin);
 }
+
+/**
+ * @brief     This function serves to save the uart registers before deep retention.
+ * @param[in] ctx - uart_retention_ctx_t.
+ * @return    none
+ */
+static void uart_retention_save(void *ctx)
+{
+    uart_retention_ctx_t *p = (uart_retention_ctx_t *)ctx;
+
+    p->div_ctrl = REG_ADDR32(0x140084 + p->uart_num * 0x40);
+    p->ctrl_tmo = REG_ADDR32(0x140088 + p->uart_num * 0x40);
+}
+
+/**
+ * @brief     This function serves to write back the uart registers after deep retention.
+ * @param[in] ctx - uart_retention_ctx_t.
+ * @return    none
+ */
+static void uart_retention_restore(const void *ctx)
+{
+    const uart_retention_ctx_t *p = (const uart_retention_ctx_t *)ctx;
+
+    REG_ADDR32(0x140084 + p->uart_num * 0x40) = p->div_ctrl;
+    REG_ADDR32(0x140088 + p->uart_num * 0x40) = p->ctrl_tmo;
+    if (p->dma_cfg & BIT(0)) {
+        dma_config(uart_dma_tx_chn[p->uart_num], &uart_tx_dma_config[p->uart_num]);
+    }
+    if (p->dma_cfg & BIT(1)) {
+        dma_config(uart_dma_rx_chn[p->uart_num], &uart_rx_dma_config[p->uart_num]);
+    }
+}
@@ -621,4 +621,13 @@ static inline void uart_rtx_en(uart_num_e chn)
     reg_uart_rx_timeout1(chn) |= FLD_UART_P7816_EN;
 }
 
+/**
+ * @brief     This function serves to register a uart to pm_retention, the uart configuration and the
+ *            dma channel setting are restored by pm_retention_restore_all after deep retention wakeup.
+ *            It depends on the gpio node which restores the uart pins.
+ * @param[in] uart_num - UART0 or UART1.
+ * @return    none
+ */
+void uart_retention_register(uart_num_e uart_num);
+
 #endif /* UART_H_ */
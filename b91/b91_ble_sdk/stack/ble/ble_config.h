@@ -84,6 +84,7 @@
 #endif
 
 ///////////////////////////////////////dbg channels///////////////////////////////////////////
+// BLT_DBG_TRACE_ENABLE maps the channels below to the RAM tracer, see vendor/common/blt_dbg_trace.h
 #ifndef DBG_CHN0_TOGGLE
 #define DBG_CHN0_TOGGLE
 #endif
@@ -32,9 +32,12 @@
 
 #include <string.h>
 
+#include "vendor/common/blm_conn_manager.h"
 #include "vendor/common/blt_common.h"
+#include "vendor/common/blt_dbg_trace.h"
 #include "vendor/common/blt_led.h"
 #include "vendor/common/blt_soft_timer.h"
+#include "vendor/common/blt_led_engine.h"
 #include "vendor/common/custom_pair.h"
 #include "vendor/common/flash_fw_check.h"
 
@@ -22,6 +22,8 @@
 #include "osal.h"
 
 #include <B91/gpio.h>
+#include <B91/stimer.h>
+#include <B91/ext_driver/pin_mux.h>
 
 #include <b91_irq.h>
 
@@ -34,6 +36,14 @@ struct B91GpioCntlr {
 
     struct {
         bool irq_enabled;
+        bool debounce_pending; /* pin irq masked until the re-sample */
+        bool held;             /* active level delivered, pin irq masked until it is released */
+        uint8_t irq_mode;
+        uint32_t debounce_us; /* 0: no debounce, from HCS debounceUs */
+        uint32_t edge_tick;
+        uint32_t delivered;
+        uint32_t suppressed;
+        OsalTimer timer;
     }* config;
 
     uint8_t pinNum;
@@ -141,14 +151,101 @@ struct GpioMethod g_GpioCntlrMethod = {
     .disableIrq = GpioDevDisableIrq,
 };
 
+/* The edge has to be at the active level for the whole debounce time, level triggers are not debounced */
+static inline bool GpioIsDebounced(struct B91GpioCntlr *pB91GpioCntlr, size_t i)
+{
+    uint8_t mode = pB91GpioCntlr->config[i].irq_mode;
+
+    return pB91GpioCntlr->config[i].debounce_us != 0 &&
+           (mode == GPIO_IRQ_TRIGGER_RISING || mode == GPIO_IRQ_TRIGGER_FALLING);
+}
+
+static inline bool GpioIsActive(struct B91GpioCntlr *pB91GpioCntlr, size_t i)
+{
+    gpio_pin_e gpioPin = g_GpioIndexToActualPin[pB91GpioCntlr->pinReflectionMap[i]];
+
+    return gpio_get_level(gpioPin) == (pB91GpioCntlr->config[i].irq_mode == GPIO_IRQ_TRIGGER_RISING);
+}
+
+/* end the debounce and unmask the pin, also when the timer cannot be started */
+static void GpioDebounceStop(struct B91GpioCntlr *pB91GpioCntlr, size_t i)
+{
+    pB91GpioCntlr->config[i].debounce_pending = false;
+    pB91GpioCntlr->config[i].held = false;
+    if (pB91GpioCntlr->config[i].irq_enabled) {
+        gpio_irq_en(g_GpioIndexToActualPin[pB91GpioCntlr->pinReflectionMap[i]]);
+    }
+}
+
+static void GpioDebounceStart(struct B91GpioCntlr *pB91GpioCntlr, size_t i)
+{
+    if (OsalTimerStartOnce(&pB91GpioCntlr->config[i].timer) != HDF_SUCCESS) {
+        GpioDebounceStop(pB91GpioCntlr, i);
+    }
+}
+
+/* Re-sample after the debounce time. An active level is delivered once, then the pin stays masked and is
+ * re-sampled every debounce time until it is released: unmasking a held pin would let the next edge of
+ * the shared irq start another debounce and deliver the same press again. */
+static void GpioDebounceTimeout(uintptr_t arg)
+{
+    struct B91GpioCntlr *pB91GpioCntlr = &g_B91GpioCntlr;
+    size_t i = (size_t)arg;
+
+    if (!pB91GpioCntlr->config[i].irq_enabled) {
+        pB91GpioCntlr->config[i].debounce_pending = false;
+        pB91GpioCntlr->config[i].held = false;
+        return;
+    }
+
+    /* the os timer only has tick resolution */
+    if (!clock_time_exceed(pB91GpioCntlr->config[i].edge_tick, pB91GpioCntlr->config[i].debounce_us)) {
+        GpioDebounceStart(pB91GpioCntlr, i);
+        return;
+    }
+
+    if (!GpioIsActive(pB91GpioCntlr, i)) {
+        if (!pB91GpioCntlr->config[i].held) {
+            pB91GpioCntlr->config[i].suppressed++;
+        }
+        GpioDebounceStop(pB91GpioCntlr, i);
+        return;
+    }
+
+    if (!pB91GpioCntlr->config[i].held) {
+        pB91GpioCntlr->config[i].held = true;
+        pB91GpioCntlr->config[i].delivered++;
+        GpioCntlrIrqCallback(&pB91GpioCntlr->cntlr, i);
+    }
+    pB91GpioCntlr->config[i].edge_tick = stimer_get_tick();
+    GpioDebounceStart(pB91GpioCntlr, i);
+}
+
 _attribute_ram_code_ static void GpioIrqHandler(void)
 {
     struct B91GpioCntlr *pB91GpioCntlr = &g_B91GpioCntlr;
 
     for (size_t i = 0; i < pB91GpioCntlr->pinNum; ++i) {
-        if (pB91GpioCntlr->config[i].irq_enabled) {
+        if (!pB91GpioCntlr->config[i].irq_enabled) {
+            continue;
+        }
+
+        if (!GpioIsDebounced(pB91GpioCntlr, i)) {
             GpioCntlrIrqCallback(&pB91GpioCntlr->cntlr, i);
+            continue;
         }
+
+        /* the gpio irq is shared by all pins, a pin not at the active level had no edge or bounced back,
+         * the edge that settles it fires the irq again */
+        if (pB91GpioCntlr->config[i].debounce_pending || !GpioIsActive(pB91GpioCntlr, i)) {
+            continue;
+        }
+
+        /* mask the pin until the re-sample, so its bounces do not interrupt again */
+        gpio_irq_dis(g_GpioIndexToActualPin[pB91GpioCntlr->pinReflectionMap[i]]);
+        pB91GpioCntlr->config[i].debounce_pending = true;
+        pB91GpioCntlr->config[i].edge_tick = stimer_get_tick();
+        GpioDebounceStart(pB91GpioCntlr, i);
     }
 
     gpio_clr_irq_status(FLD_GPIO_IRQ_CLR);
@@ -176,7 +273,7 @@ static int32_t GetGpioDeviceResource(struct B91GpioCntlr *cntlr, const struct De
         return HDF_ERR_MALLOC_FAIL;
     }
 
-    cntlr->config = OsalMemAlloc(sizeof(cntlr->config[0]) * cntlr->pinNum);
+    cntlr->config = OsalMemCalloc(sizeof(cntlr->config[0]) * cntlr->pinNum);
     if (cntlr->config == NULL) {
         HDF_LOGE("%s: OsalMemAlloc error", __func__);
         return HDF_ERR_MALLOC_FAIL;
@@ -189,6 +286,16 @@ static int32_t GetGpioDeviceResource(struct B91GpioCntlr *cntlr, const struct De
         }
 
         cntlr->pinReflectionMap[i] = pinIndex;
+
+        /* optional */
+        (void)dri->GetUint32ArrayElem(resourceNode, "debounceUs", i, &cntlr->config[i].debounce_us, 0);
+        if (cntlr->config[i].debounce_us != 0) {
+            uint32_t ms = (cntlr->config[i].debounce_us + 999) / 1000;
+            if (OsalTimerCreate(&cntlr->config[i].timer, ms, GpioDebounceTimeout, i) != HDF_SUCCESS) {
+                HDF_LOGE("Failed to create debounce timer!");
+                return HDF_FAILURE;
+            }
+        }
     }
 
     return HDF_SUCCESS;
@@ -244,6 +351,16 @@ static void GpioDriverRelease(struct HdfDeviceObject *device)
         return;
     }
 
+    if (pB91GpioCntlr->config) {
+        for (uint32_t i = 0; i < pB91GpioCntlr->pinNum; i++) {
+            if (pB91GpioCntlr->config[i].debounce_us != 0) {
+                (void)OsalTimerDelete(&pB91GpioCntlr->config[i].timer);
+            }
+        }
+        OsalMemFree(pB91GpioCntlr->config);
+        pB91GpioCntlr->config = NULL;
+    }
+
     if (pB91GpioCntlr->pinReflectionMap) {
         OsalMemFree(pB91GpioCntlr->pinReflectionMap);
         pB91GpioCntlr->pinReflectionMap = NULL;
@@ -314,6 +431,14 @@ static int32_t GpioDevSetDir(struct GpioCntlr *cntlr, uint16_t gpio, uint16_t di
     gpio_pin_e gpioPin = g_GpioIndexToActualPin[pB91GpioCntlr->pinReflectionMap[gpio]];
     HDF_LOGD("%s: %d - %d", __func__, gpioPin, dir);
 
+    if (dir == GPIO_DIR_OUT || dir == GPIO_DIR_IN) {
+        pin_mux_cfg_t pin = {gpioPin, PIN_MUX_FUNC_KEEP};
+        if (pin_mux_claim(PIN_MUX_OWNER_GPIO, &pin, 1, 0) != 0) {
+            HDF_LOGE("%s: %d belongs to another driver", __func__, gpioPin);
+            return HDF_ERR_DEVICE_BUSY;
+        }
+    }
+
     if (dir == GPIO_DIR_OUT) {
         gpio_function_en(gpioPin);
         gpio_input_dis(gpioPin);
@@ -382,6 +507,8 @@ static int32_t GpioDevSetIrq(struct GpioCntlr *cntlr, uint16_t local, uint16_t m
         }
     }
 
+    pB91GpioCntlr->config[local].irq_mode = mode & 0x0F;
+
     return HDF_SUCCESS;
 }
 
@@ -405,7 +532,10 @@ static int32_t GpioDevEnableIrq(struct GpioCntlr *cntlr, uint16_t local)
     gpio_pin_e gpioPin = g_GpioIndexToActualPin[pB91GpioCntlr->pinReflectionMap[local]];
     HDF_LOGD("%s: %d", __func__, local);
 
-    gpio_irq_en(gpioPin);
+    /* a pending debounce unmasks the pin when it ends */
+    if (!pB91GpioCntlr->config[local].debounce_pending) {
+        gpio_irq_en(gpioPin);
+    }
 
     pB91GpioCntlr->config[local].irq_enabled = true;
 
@@ -426,5 +556,10 @@ static int32_t GpioDevDisableIrq(struct GpioCntlr *cntlr, uint16_t local)
 
     pB91GpioCntlr->config[local].irq_enabled = false;
 
+    if (pB91GpioCntlr->config[local].debounce_us != 0) {
+        HDF_LOGD("%s: %d delivered %lu suppressed %lu", __func__, local, pB91GpioCntlr->config[local].delivered,
+                 pB91GpioCntlr->config[local].suppressed);
+    }
+
     return HDF_SUCCESS;
 }
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef B91_ASSETFS_H
+#define B91_ASSETFS_H
+
+#include <stdint.h>
+
+/*
+ * Read-only asset image, packed at build time by util/assetfs_pack.py and flashed to its own region.
+ * Files are accessed in place through the XIP window, no copy to RAM is needed.
+ *
+ * Layout (little endian):
+ *   header   AssetFsHeader
+ *   entries  AssetFsEntry[entryNum], sorted by name (byte compare) for binary search
+ *   names    NUL terminated strings
+ *   data     each file aligned to header.align
+ */
+
+#ifndef ASSETFS_PHYS_ADDR
+#define ASSETFS_PHYS_ADDR 0xB0000
+#endif
+
+#ifndef ASSETFS_PHYS_SIZE
+#define ASSETFS_PHYS_SIZE (256 * 1024)
+#endif
+
+#define ASSETFS_MAGIC   0x31534641 /* "AFS1" */
+#define ASSETFS_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entryNum;
+    uint32_t imageSize;
+    uint32_t align;
+    uint32_t dirCrc;    /* crc32 of entries and names */
+    uint32_t headerCrc; /* crc32 of the fields above */
+} AssetFsHeader;
+
+typedef struct {
+    uint32_t nameOffset; /* from image start */
+    uint32_t dataOffset; /* from image start */
+    uint32_t size;
+    uint32_t crc; /* crc32 of data */
+} AssetFsEntry;
+
+/* mount the image at the physical flash address, it is accessed through the XIP window */
+int AssetFsMount(uint32_t physAddr);
+
+/* mount an image already mapped in memory */
+int AssetFsMountAt(const void *image, uint32_t maxSize);
+
+void AssetFsUnmount(void);
+
+/* returns a pointer into the image and the file size, NULL if not found or not mounted */
+const void *AssetFsGet(const char *name, uint32_t *size);
+
+/* check the data crc of a file, 0 if it matches */
+int AssetFsVerify(const char *name);
+
+uint32_t AssetFsCount(void);
+
+#endif /* B91_ASSETFS_H */
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef B91_FPU_STATS_H
+#define B91_FPU_STATS_H
+
+#include <stdint.h>
+
+/*
+ * Per task FPU usage, to see which tasks touch floating point before changing how the FP context is switched.
+ * The kernel saves and restores the FP registers of every task (LOSCFG_ARCH_FPU_ENABLE), that is not part of
+ * this port. On every task switch the hook reads mstatus.FS of the task switched out: dirty means it wrote an
+ * FP register in its time slice, FS is then set back to clean. A task switched out from an interrupt gets its
+ * saved mstatus back, so it can be counted again without new FP use: fpuSlices is an upper bound, a task
+ * with fpuSlices 0 never wrote an FP register. Needs the kernel hooks (LOSCFG_DEBUG_HOOK).
+ *
+ * The hook is not read only: FpuStatsSwitchedIn clears mstatus.FS from the scheduler hook, so it changes the
+ * state of the task switched out, whose context is then saved with FS clean although its FP registers were
+ * written. The kernel here saves every FP context whatever FS says, so nothing is lost. Do not enable the stats
+ * with a dispatcher which skips the FP save of a clean task, it would drop the FP registers of that slice.
+ */
+
+#ifndef FPU_STATS_ENABLE
+#define FPU_STATS_ENABLE 0
+#endif
+
+typedef struct {
+    uint32_t slices;    /* times the task was switched out */
+    uint32_t fpuSlices; /* of those, with FS dirty */
+} FpuStats;
+
+/* register the task switch hook, call before the scheduler starts */
+int FpuStatsInit(void);
+
+/* task ids are reused, reset the counters when a task is created */
+int FpuStatsGet(uint32_t taskId, FpuStats *stats);
+int FpuStatsReset(uint32_t taskId);
+
+#endif /* B91_FPU_STATS_H */
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef B91_LOGSTORE_H
+#define B91_LOGSTORE_H
+
+#include <stdint.h>
+
+/*
+ * Circular log store on raw flash sectors.
+ * Log lines are collected in a RAM page and programmed one flash page at a time, every page is a
+ * chunk with a header carrying the sequence number of its first line and a crc. When the head
+ * sector is full the oldest sector is erased and reused, so a sector is erased once per
+ * LOGSTORE_SECTOR_SIZE bytes of log. A chunk torn by power loss fails its crc and is skipped.
+ */
+
+#ifndef LOGSTORE_ENABLE
+#define LOGSTORE_ENABLE 0 /* persist hilog output */
+#endif
+
+#ifndef LOGSTORE_PHYS_ADDR
+#define LOGSTORE_PHYS_ADDR 0xA0000
+#endif
+
+#ifndef LOGSTORE_SECTOR_NUM
+#define LOGSTORE_SECTOR_NUM 16
+#endif
+
+#define LOGSTORE_SECTOR_SIZE 4096
+#define LOGSTORE_PAGE_SIZE   256
+
+/* a page holds a 12 byte chunk header and the lines, each with a 1 byte length prefix */
+#define LOGSTORE_LINE_MAX (LOGSTORE_PAGE_SIZE - 12 - 1)
+
+/* called for every stored line, return non zero to stop */
+typedef int (*LogStoreReadCb)(uint32_t seq, const char *line, uint32_t len, void *arg);
+
+typedef struct {
+    uint32_t pages;  /* pages programmed since init */
+    uint32_t erases; /* sectors erased since init */
+    uint32_t lost;   /* lines dropped or truncated to LOGSTORE_LINE_MAX */
+} LogStoreStats;
+
+/* scan the region and find the write position, must be called from a task */
+int LogStoreInit(void);
+
+int LogStoreAppend(const char *line, uint32_t len);
+
+/* program the pending lines, the rest of the page is left unused */
+int LogStoreFlush(void);
+
+/* stream stored lines with sequence number >= seq, lines still in the RAM page are not included */
+int LogStoreRead(uint32_t seq, LogStoreReadCb cb, void *arg);
+
+/* sequence number of the oldest stored line and of the next line to be appended */
+uint32_t LogStoreFirstSeq(void);
+uint32_t LogStoreNextSeq(void);
+
+void LogStoreGetStats(LogStoreStats *stats);
+
+#endif /* B91_LOGSTORE_H */
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef B91_TSSTORE_H
+#define B91_TSSTORE_H
+
+#include <stdint.h>
+
+/*
+ * Time-series store on raw flash sectors, for sensor readings buffered offline.
+ * Samples (time, value) are packed into flash page sized blocks: the first sample is stored in the block
+ * header, the following ones as zigzag varints of the time delta-of-delta and of the value delta, so a
+ * periodic slowly changing signal takes 2 bytes per sample instead of 8. Every block header carries the
+ * time range and value min/max, a query reads only the 32 byte headers of the blocks it does not need.
+ * Sectors are used as a ring, the oldest sector is erased when the head sector is full.
+ */
+
+#ifndef TSSTORE_PHYS_ADDR
+#define TSSTORE_PHYS_ADDR 0x90000
+#endif
+
+#ifndef TSSTORE_SECTOR_NUM
+#define TSSTORE_SECTOR_NUM 16
+#endif
+
+#define TSSTORE_SECTOR_SIZE 4096
+#define TSSTORE_PAGE_SIZE   256
+
+typedef struct {
+    uint16_t magic;
+    uint16_t num; /* samples in the block */
+    uint32_t seq; /* block sequence number */
+    uint32_t timeFirst;
+    uint32_t timeLast;
+    int32_t valueFirst;
+    int32_t valueMin;
+    int32_t valueMax;
+    uint16_t len; /* payload bytes */
+    uint16_t crc; /* crc16 of header fields above and payload */
+} TsStoreBlockHeader;
+
+typedef struct {
+    TsStoreBlockHeader header;
+    uint8_t payload[TSSTORE_PAGE_SIZE - sizeof(TsStoreBlockHeader)];
+} TsStoreBlock;
+
+typedef struct {
+    uint32_t physAddr;
+    uint32_t sectorNum;
+    uint32_t headSector;
+    uint32_t headPage;
+    uint32_t nextSeq;
+    uint32_t mutex;
+    /* encoder state of the block in RAM */
+    TsStoreBlock block;
+    uint32_t lastTime;
+    uint32_t lastDelta;
+    int32_t lastValue;
+    /* statistics */
+    uint32_t samples;
+    uint32_t pages;
+    uint32_t erases;
+} TsStore;
+
+typedef struct {
+    uint32_t timeBegin; /* inclusive */
+    uint32_t timeEnd;   /* inclusive */
+    int32_t valueLow;   /* only samples within [valueLow, valueHigh] are reported */
+    int32_t valueHigh;
+} TsStoreRange;
+
+/* called for every matching sample, return non zero to stop */
+typedef int (*TsStoreQueryCb)(uint32_t time, int32_t value, void *arg);
+
+/* scan the region and find the write position, must be called from a task */
+int TsStoreInit(TsStore *ts, uint32_t physAddr, uint32_t sectorNum);
+
+/* time must not go backwards */
+int TsStoreAppend(TsStore *ts, uint32_t time, int32_t value);
+
+/* program the block in RAM, the rest of the page is left unused */
+int TsStoreFlush(TsStore *ts);
+
+/* report samples in range, oldest first, including the block in RAM */
+int TsStoreQuery(TsStore *ts, const TsStoreRange *range, TsStoreQueryCb cb, void *arg);
+
+#endif /* B91_TSSTORE_H */
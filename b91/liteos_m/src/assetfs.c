@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include <B91/sys.h>
+
+#include <assetfs.h>
+
+#define ASSETFS_ERROR -1
+
+static const uint8_t *g_assetImage = NULL;
+
+static const uint32_t g_crc32HalfTbl[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+/* same as zlib crc32, which the packer uses */
+static uint32_t AssetFsCrc32(const uint8_t *buf, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (len--) {
+        crc ^= *buf++;
+        crc = (crc >> 4) ^ g_crc32HalfTbl[crc & 0x0F];
+        crc = (crc >> 4) ^ g_crc32HalfTbl[crc & 0x0F];
+    }
+
+    return ~crc;
+}
+
+static const AssetFsHeader *AssetFsGetHeader(void)
+{
+    return (const AssetFsHeader *)g_assetImage;
+}
+
+static const AssetFsEntry *AssetFsGetEntry(uint32_t index)
+{
+    return (const AssetFsEntry *)(g_assetImage + sizeof(AssetFsHeader)) + index;
+}
+
+static const AssetFsEntry *AssetFsFind(const char *name)
+{
+    uint32_t lo = 0;
+    uint32_t hi;
+    uint32_t mid;
+    int cmp;
+    const AssetFsEntry *entry = NULL;
+
+    if ((g_assetImage == NULL) || (name == NULL)) {
+        return NULL;
+    }
+
+    hi = AssetFsGetHeader()->entryNum;
+    while (lo < hi) {
+        mid = lo + ((hi - lo) >> 1);
+        entry = AssetFsGetEntry(mid);
+        cmp = strcmp(name, (const char *)(g_assetImage + entry->nameOffset));
+        if (cmp == 0) {
+            return entry;
+        } else if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    return NULL;
+}
+
+int AssetFsMountAt(const void *image, uint32_t maxSize)
+{
+    const AssetFsHeader *header = (const AssetFsHeader *)image;
+    const AssetFsEntry *entry;
+    uint32_t dirSize;
+    uint32_t nameBase;
+    uint32_t nameOffset;
+    uint32_t i;
+
+    g_assetImage = NULL;
+
+    if ((image == NULL) || (maxSize < sizeof(AssetFsHeader)) || (header->magic != ASSETFS_MAGIC) ||
+        (header->version != ASSETFS_VERSION) ||
+        (AssetFsCrc32(image, offsetof(AssetFsHeader, headerCrc)) != header->headerCrc) ||
+        (header->imageSize > maxSize) ||
+        (header->imageSize < sizeof(AssetFsHeader) + header->entryNum * sizeof(AssetFsEntry))) {
+        return ASSETFS_ERROR;
+    }
+
+    /* directory ends where the first file starts, data offsets are checked once here */
+    entry = (const AssetFsEntry *)(header + 1);
+    dirSize = header->imageSize - sizeof(AssetFsHeader);
+    for (i = 0; i < header->entryNum; i++) {
+        if ((entry[i].dataOffset < sizeof(AssetFsHeader)) || (entry[i].dataOffset > header->imageSize) ||
+            (entry[i].size > header->imageSize - entry[i].dataOffset)) {
+            return ASSETFS_ERROR;
+        }
+        if ((entry[i].dataOffset - sizeof(AssetFsHeader)) < dirSize) {
+            dirSize = entry[i].dataOffset - sizeof(AssetFsHeader);
+        }
+    }
+
+    /* names are NUL terminated within the directory, so lookups never strcmp past the crc checked part */
+    nameBase = header->entryNum * sizeof(AssetFsEntry);
+    if (nameBase > dirSize) {
+        return ASSETFS_ERROR;
+    }
+    for (i = 0; i < header->entryNum; i++) {
+        nameOffset = entry[i].nameOffset - sizeof(AssetFsHeader);
+        if ((entry[i].nameOffset < sizeof(AssetFsHeader)) || (nameOffset < nameBase) || (nameOffset >= dirSize) ||
+            (memchr((const uint8_t *)entry + nameOffset, '\0', dirSize - nameOffset) == NULL)) {
+            return ASSETFS_ERROR;
+        }
+    }
+
+    if (AssetFsCrc32((const uint8_t *)entry, dirSize) != header->dirCrc) {
+        return ASSETFS_ERROR;
+    }
+
+    g_assetImage = (const uint8_t *)image;
+
+    return 0;
+}
+
+int AssetFsMount(uint32_t physAddr)
+{
+    return AssetFsMountAt((const void *)(uintptr_t)(FLASH_R_BASE_ADDR + physAddr), ASSETFS_PHYS_SIZE);
+}
+
+void AssetFsUnmount(void)
+{
+    g_assetImage = NULL;
+}
+
+const void *AssetFsGet(const char *name, uint32_t *size)
+{
+    const AssetFsEntry *entry = AssetFsFind(name);
+
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    if (size != NULL) {
+        *size = entry->size;
+    }
+
+    return g_assetImage + entry->dataOffset;
+}
+
+int AssetFsVerify(const char *name)
+{
+    const AssetFsEntry *entry = AssetFsFind(name);
+
+    if (entry == NULL) {
+        return ASSETFS_ERROR;
+    }
+
+    return (AssetFsCrc32(g_assetImage + entry->dataOffset, entry->size) == entry->crc) ? 0 : ASSETFS_ERROR;
+}
+
+uint32_t AssetFsCount(void)
+{
+    return (g_assetImage == NULL) ? 0 : AssetFsGetHeader()->entryNum;
+}
@@ -48,6 +48,8 @@ STATIC VOID BoardConfigInnerSafe(VOID);
 #ifdef __GNUC__
 #pragma GCC push_options
 #pragma GCC optimize("-fno-stack-protector")
+/* the loops below run before the RAM code (string_opt.c memcpy/memset) is copied, they must not become calls */
+#pragma GCC optimize("-fno-tree-loop-distribute-patterns")
 #endif /* __GNUC__ */
 
 __attribute__((noinline)) STATIC VOID CopyBuf32(UINT32 *dst, const UINT32 *dstEnd, const UINT32 *src)
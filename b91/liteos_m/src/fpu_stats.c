@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+
+#include <los_hook.h>
+#include <los_interrupt.h>
+#include <los_task.h>
+
+#include <nds_intrinsic.h>
+
+#include <fpu_stats.h>
+
+#if (FPU_STATS_ENABLE)
+
+#if !defined(LOSCFG_ARCH_FPU_ENABLE) || (LOSCFG_DEBUG_HOOK != 1)
+#error "FPU_STATS_ENABLE needs LOSCFG_ARCH_FPU_ENABLE and LOSCFG_DEBUG_HOOK"
+#endif
+
+#define FPU_STATS_ERROR -1
+
+#define MSTATUS_FS_DIRTY   0x6000
+#define MSTATUS_FS_INITIAL 0x2000 /* cleared to go from dirty to clean, never to off */
+
+#define FPU_STATS_TASK_NUM (LOSCFG_BASE_CORE_TSK_LIMIT + 1)
+
+static FpuStats g_fpuStats[FPU_STATS_TASK_NUM];
+
+/* runs in the scheduler before the switch, mstatus still belongs to the task switched out, which keeps FS clean */
+static VOID FpuStatsSwitchedIn(VOID)
+{
+    UINT32 taskId = g_losTask.runTask->taskID;
+
+    if (taskId >= FPU_STATS_TASK_NUM) {
+        return;
+    }
+
+    g_fpuStats[taskId].slices++;
+    if ((__nds__csrr(NDS_MSTATUS) & MSTATUS_FS_DIRTY) == MSTATUS_FS_DIRTY) {
+        g_fpuStats[taskId].fpuSlices++;
+        __nds__csrrc(MSTATUS_FS_INITIAL, NDS_MSTATUS);
+    }
+}
+
+int FpuStatsInit(void)
+{
+    return (LOS_HookReg(LOS_HOOK_TYPE_TASK_SWITCHEDIN, FpuStatsSwitchedIn) == LOS_OK) ? 0 : FPU_STATS_ERROR;
+}
+
+int FpuStatsGet(uint32_t taskId, FpuStats *stats)
+{
+    UINT32 intSave;
+
+    if (taskId >= FPU_STATS_TASK_NUM) {
+        return FPU_STATS_ERROR;
+    }
+
+    intSave = LOS_IntLock();
+    *stats = g_fpuStats[taskId];
+    LOS_IntRestore(intSave);
+
+    return 0;
+}
+
+int FpuStatsReset(uint32_t taskId)
+{
+    UINT32 intSave;
+
+    if (taskId >= FPU_STATS_TASK_NUM) {
+        return FPU_STATS_ERROR;
+    }
+
+    intSave = LOS_IntLock();
+    (void)memset(&g_fpuStats[taskId], 0, sizeof(FpuStats));
+    LOS_IntRestore(intSave);
+
+    return 0;
+}
+
+#endif /* FPU_STATS_ENABLE */
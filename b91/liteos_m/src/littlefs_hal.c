@@ -19,11 +19,14 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <los_interrupt.h>
 #include <los_mux.h>
 
 #include <lfs.h>
 
+#include <B91/aes.h>
 #include <B91/flash.h>
+#include <B91/trng.h>
 
 #define LITTLEFS_PATH "/littlefs/"
 
@@ -38,16 +41,171 @@
 #define LOOKAHEAD_SIZE 64
 #define BLOCK_CYCLES   500
 
+#ifndef LITTLEFS_ENCRYPT_ENABLE
+#define LITTLEFS_ENCRYPT_ENABLE 0 /* AES-XTS on the block device, existing plain data is not readable anymore */
+#endif
+
+/* the last block of the region holds the wrapped keys, it is not handed to littlefs */
+#if (LITTLEFS_ENCRYPT_ENABLE)
+#define LITTLEFS_KEY_BLOCKS 1
+#else
+#define LITTLEFS_KEY_BLOCKS 0
+#endif
+
 #if defined(LFS_THREADSAFE)
 static uint32_t g_lfsMutex;
 #endif /* LFS_THREADSAFE */
 
+#if (LITTLEFS_ENCRYPT_ENABLE)
+/*
+ * AES-XTS with 256 byte data units: the tweak of a unit is the unit index encrypted with the tweak key,
+ * multiplied by alpha for every 16 byte block, so any 16 byte aligned range is decrypted on its own.
+ * The data key and tweak key are random (TRNG) and stored in the key sector wrapped with a key derived
+ * from the flash UID, a flash image copied to another chip cannot be decrypted.
+ * Erased (all 0xFF) blocks are read back as erased, they are not valid ciphertext.
+ */
+#define LITTLEFS_KEY_ADDR  (LITTLEFS_PHYS_ADDR + (BLOCK_COUNT - LITTLEFS_KEY_BLOCKS) * BLOCK_SIZE)
+#define LITTLEFS_KEY_MAGIC 0x59454B4C /* "LKEY" */
+#define AES_BLOCK_LEN      16
+#define XTS_UNIT_SIZE      256
+
+typedef struct {
+    uint32_t magic;
+    uint8_t key[2][AES_BLOCK_LEN]; /* data key and tweak key, wrapped */
+    uint8_t check[AES_BLOCK_LEN];  /* zero block encrypted with the data key */
+} LittlefsKeyRecord;
+
+static uint8_t g_lfsDataKey[AES_BLOCK_LEN];
+static uint8_t g_lfsTweakKey[AES_BLOCK_LEN];
+static uint8_t g_lfsProgBuf[XTS_UNIT_SIZE];
+
+/* the AES engine is shared with the BLE stack, one block at a time with interrupts locked */
+static void LittlefsAes(const uint8_t *key, const uint8_t *in, uint8_t *out, int decrypt)
+{
+    UINT32 intSave = LOS_IntLock();
+
+    if (decrypt) {
+        (void)aes_decrypt((unsigned char *)key, (unsigned char *)in, out);
+    } else {
+        (void)aes_encrypt((unsigned char *)key, (unsigned char *)in, out);
+    }
+
+    LOS_IntRestore(intSave);
+}
+
+/* multiply by alpha in GF(2^128), little endian as in IEEE 1619 */
+static void LittlefsXtsDouble(uint8_t *tweak)
+{
+    uint8_t carry = 0;
+
+    for (int i = 0; i < AES_BLOCK_LEN; i++) {
+        uint8_t msb = tweak[i] >> 7;
+        tweak[i] = (uint8_t)(tweak[i] << 1) | carry;
+        carry = msb;
+    }
+
+    if (carry) {
+        tweak[0] ^= 0x87;
+    }
+}
+
+static int LittlefsIsErased(const uint8_t *block)
+{
+    for (int i = 0; i < AES_BLOCK_LEN; i++) {
+        if (block[i] != 0xFF) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* en/decrypt in place, addr and size are 16 byte aligned and within one data unit */
+static void LittlefsXts(uint32_t addr, uint8_t *buf, uint32_t size, int decrypt)
+{
+    uint8_t tweak[AES_BLOCK_LEN] = {0};
+    uint8_t block[AES_BLOCK_LEN];
+    uint32_t unit = addr / XTS_UNIT_SIZE;
+
+    (void)memcpy(tweak, &unit, sizeof(unit));
+    LittlefsAes(g_lfsTweakKey, tweak, tweak, 0);
+    for (uint32_t j = (addr % XTS_UNIT_SIZE) / AES_BLOCK_LEN; j > 0; j--) {
+        LittlefsXtsDouble(tweak);
+    }
+
+    for (uint32_t off = 0; off < size; off += AES_BLOCK_LEN) {
+        if (decrypt && LittlefsIsErased(&buf[off])) {
+            LittlefsXtsDouble(tweak);
+            continue;
+        }
+        for (int i = 0; i < AES_BLOCK_LEN; i++) {
+            block[i] = buf[off + i] ^ tweak[i];
+        }
+        LittlefsAes(g_lfsDataKey, block, block, decrypt);
+        for (int i = 0; i < AES_BLOCK_LEN; i++) {
+            buf[off + i] = block[i] ^ tweak[i];
+        }
+        LittlefsXtsDouble(tweak);
+    }
+}
+
+/* load the keys, create them on first boot, fails if the keys cannot be bound to this flash */
+static int LittlefsKeyInit(void)
+{
+    static const uint8_t kekLabel[AES_BLOCK_LEN] = "B91 littlefs kek";
+    uint8_t uid[AES_BLOCK_LEN] = {0};
+    uint8_t kek[AES_BLOCK_LEN];
+    uint8_t check[AES_BLOCK_LEN] = {0};
+    unsigned int mid;
+    LittlefsKeyRecord rec;
+
+    if (!flash_read_mid_uid_with_check(&mid, uid)) {
+        printf("littlefs: flash uid unknown, not mounted\r\n");
+        return -1;
+    }
+    LittlefsAes(uid, kekLabel, kek, 0);
+
+    flash_read_page(LITTLEFS_KEY_ADDR, sizeof(rec), (unsigned char *)&rec);
+    if (rec.magic != LITTLEFS_KEY_MAGIC) {
+        trng_init();
+        for (uint32_t i = 0; i < sizeof(rec.key) / sizeof(uint32_t); i++) {
+            ((uint32_t *)rec.key)[i] = (uint32_t)trng_rand();
+        }
+        LittlefsAes(rec.key[0], check, rec.check, 0);
+        LittlefsAes(kek, rec.key[0], rec.key[0], 0);
+        LittlefsAes(kek, rec.key[1], rec.key[1], 0);
+        rec.magic = LITTLEFS_KEY_MAGIC;
+        flash_erase_sector(LITTLEFS_KEY_ADDR);
+        flash_write_page(LITTLEFS_KEY_ADDR, sizeof(rec), (unsigned char *)&rec);
+    }
+
+    LittlefsAes(kek, rec.key[0], g_lfsDataKey, 1);
+    LittlefsAes(kek, rec.key[1], g_lfsTweakKey, 1);
+
+    LittlefsAes(g_lfsDataKey, check, check, 0);
+    if (memcmp(check, rec.check, sizeof(check)) != 0) {
+        printf("littlefs: key does not belong to this flash, not mounted\r\n");
+        return -1;
+    }
+
+    return 0;
+}
+#endif /* LITTLEFS_ENCRYPT_ENABLE */
+
 static int LittlefsRead(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size)
 {
     uint32_t addr = block * (cfg->block_size) + off;
 
     flash_read_page(LITTLEFS_PHYS_ADDR + addr, size, buffer);
 
+#if (LITTLEFS_ENCRYPT_ENABLE)
+    for (uint32_t done = 0, len; done < size; done += len) {
+        len = XTS_UNIT_SIZE - ((addr + done) % XTS_UNIT_SIZE);
+        len = (len < size - done) ? len : (size - done);
+        LittlefsXts(addr + done, (uint8_t *)buffer + done, len, 1);
+    }
+#endif
+
     return LFS_ERR_OK;
 }
 
@@ -56,7 +214,18 @@ static int LittlefsProg(const struct lfs_config *cfg, lfs_block_t block, lfs_off
 {
     uint32_t addr = block * (cfg->block_size) + off;
 
+#if (LITTLEFS_ENCRYPT_ENABLE)
+    /* one data unit at a time, units are flash page aligned */
+    for (uint32_t done = 0, len; done < size; done += len) {
+        len = XTS_UNIT_SIZE - ((addr + done) % XTS_UNIT_SIZE);
+        len = (len < size - done) ? len : (size - done);
+        (void)memcpy(g_lfsProgBuf, (const uint8_t *)buffer + done, len);
+        LittlefsXts(addr + done, g_lfsProgBuf, len, 0);
+        flash_write_page(LITTLEFS_PHYS_ADDR + addr + done, len, g_lfsProgBuf);
+    }
+#else
     flash_write_page(LITTLEFS_PHYS_ADDR + addr, size, (unsigned char *)buffer);
+#endif
 
     return LFS_ERR_OK;
 }
@@ -106,7 +275,7 @@ static struct lfs_config g_lfsConfig = {
     .read_size = READ_SIZE,
     .prog_size = PROG_SIZE,
     .block_size = BLOCK_SIZE,
-    .block_count = BLOCK_COUNT,
+    .block_count = BLOCK_COUNT - LITTLEFS_KEY_BLOCKS,
     .cache_size = CACHE_SIZE,
     .lookahead_size = LOOKAHEAD_SIZE,
     .block_cycles = BLOCK_CYCLES,
@@ -117,8 +286,14 @@ void LittlefsDriverInit(int needErase)
     (void)needErase;
 }
 
+/* NULL if the region cannot be used */
 struct lfs_config *LittlefsConfigGet(void)
 {
+#if (LITTLEFS_ENCRYPT_ENABLE)
+    if (LittlefsKeyInit() != 0) {
+        return NULL;
+    }
+#endif
 #if defined(LFS_THREADSAFE)
     (void)LOS_MuxCreate(&g_lfsMutex);
 #endif /* LFS_THREADSAFE */
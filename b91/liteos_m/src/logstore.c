@@ -0,0 +1,318 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include <los_mux.h>
+
+#include <B91/flash.h>
+
+#include <logstore.h>
+
+#define LOGSTORE_ERROR -1
+
+#define LOGSTORE_CHUNK_MAGIC 0x474C /* "LG" */
+#define LOGSTORE_PAGE_NUM    (LOGSTORE_SECTOR_SIZE / LOGSTORE_PAGE_SIZE)
+#define LOGSTORE_NO_SECTOR   0xFFFFFFFF
+
+typedef struct {
+    uint16_t magic;
+    uint16_t len; /* payload bytes */
+    uint32_t seq; /* sequence number of the first line */
+    uint16_t num; /* lines in the chunk */
+    uint16_t crc; /* crc16 of header fields above and payload */
+} LogStoreChunkHeader;
+
+#define LOGSTORE_PAYLOAD_MAX (LOGSTORE_PAGE_SIZE - sizeof(LogStoreChunkHeader))
+
+_Static_assert(LOGSTORE_LINE_MAX == LOGSTORE_PAYLOAD_MAX - 1, "a line and its length byte must fill at most one page");
+
+typedef struct {
+    LogStoreChunkHeader header;
+    uint8_t payload[LOGSTORE_PAYLOAD_MAX]; /* lines as 1 byte length + text */
+} LogStoreChunk;
+
+static LogStoreChunk g_logChunk;
+static uint32_t g_logHeadSector = LOGSTORE_NO_SECTOR;
+static uint32_t g_logHeadPage;
+static uint32_t g_logFirstSeq;
+static uint32_t g_logNextSeq;
+static LogStoreStats g_logStats;
+static uint32_t g_logMutex;
+static int g_logReady;
+
+static uint16_t LogStoreCrc16(uint16_t crc, const uint8_t *buf, uint32_t len)
+{
+    while (len--) {
+        crc ^= (uint16_t)(*buf++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static uint32_t LogStoreAddr(uint32_t sector, uint32_t page)
+{
+    return LOGSTORE_PHYS_ADDR + sector * LOGSTORE_SECTOR_SIZE + page * LOGSTORE_PAGE_SIZE;
+}
+
+/* header only check, used by the scan */
+static int LogStoreHeaderValid(const LogStoreChunkHeader *header)
+{
+    return (header->magic == LOGSTORE_CHUNK_MAGIC) && (header->len <= LOGSTORE_PAYLOAD_MAX) && (header->num != 0);
+}
+
+static int LogStoreHeaderErased(const LogStoreChunkHeader *header)
+{
+    const uint8_t *p = (const uint8_t *)header;
+
+    for (uint32_t i = 0; i < sizeof(LogStoreChunkHeader); i++) {
+        if (p[i] != 0xFF) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* read a whole chunk and check its crc */
+static int LogStoreReadChunk(uint32_t sector, uint32_t page, LogStoreChunk *chunk)
+{
+    flash_read_page(LogStoreAddr(sector, page), sizeof(LogStoreChunkHeader), (unsigned char *)&chunk->header);
+    if (!LogStoreHeaderValid(&chunk->header)) {
+        return 0;
+    }
+
+    flash_read_page(LogStoreAddr(sector, page) + sizeof(LogStoreChunkHeader), chunk->header.len, chunk->payload);
+
+    return LogStoreCrc16(LogStoreCrc16(0xFFFF, (const uint8_t *)&chunk->header, offsetof(LogStoreChunkHeader, crc)),
+                         chunk->payload, chunk->header.len) == chunk->header.crc;
+}
+
+/* first sequence number of a sector, or 0 if its first chunk is invalid */
+static int LogStoreSectorSeq(uint32_t sector, uint32_t *seq)
+{
+    LogStoreChunkHeader header;
+
+    flash_read_page(LogStoreAddr(sector, 0), sizeof(header), (unsigned char *)&header);
+    if (!LogStoreHeaderValid(&header)) {
+        return 0;
+    }
+
+    *seq = header.seq;
+    return 1;
+}
+
+static void LogStoreScan(void)
+{
+    LogStoreChunk chunk;
+    LogStoreChunkHeader header;
+    uint32_t seq;
+    uint32_t oldest = LOGSTORE_NO_SECTOR;
+
+    g_logHeadSector = LOGSTORE_NO_SECTOR;
+    g_logFirstSeq = 0;
+    g_logNextSeq = 0;
+
+    for (uint32_t sector = 0; sector < LOGSTORE_SECTOR_NUM; sector++) {
+        if (!LogStoreSectorSeq(sector, &seq)) {
+            continue;
+        }
+        if ((g_logHeadSector == LOGSTORE_NO_SECTOR) || ((int32_t)(seq - g_logNextSeq) > 0)) {
+            g_logHeadSector = sector;
+            g_logNextSeq = seq;
+        }
+        if ((oldest == LOGSTORE_NO_SECTOR) || ((int32_t)(seq - g_logFirstSeq) < 0)) {
+            oldest = sector;
+            g_logFirstSeq = seq;
+        }
+    }
+
+    if (g_logHeadSector == LOGSTORE_NO_SECTOR) {
+        /* empty store, start from the first sector, it is erased before use */
+        g_logHeadSector = LOGSTORE_SECTOR_NUM - 1;
+        g_logHeadPage = LOGSTORE_PAGE_NUM;
+        return;
+    }
+
+    /* the write position is the first erased page of the head sector, torn pages are skipped */
+    for (g_logHeadPage = 0; g_logHeadPage < LOGSTORE_PAGE_NUM; g_logHeadPage++) {
+        flash_read_page(LogStoreAddr(g_logHeadSector, g_logHeadPage), sizeof(header), (unsigned char *)&header);
+        if (LogStoreHeaderErased(&header)) {
+            break;
+        }
+        if (LogStoreReadChunk(g_logHeadSector, g_logHeadPage, &chunk)) {
+            g_logNextSeq = chunk.header.seq + chunk.header.num;
+        }
+    }
+}
+
+/* program the RAM chunk into the next page, erasing the oldest sector when the head is full */
+static int LogStoreProgram(void)
+{
+    LogStoreChunkHeader *header = &g_logChunk.header;
+    uint32_t seq;
+
+    if (header->num == 0) {
+        return 0;
+    }
+
+    if (g_logHeadPage >= LOGSTORE_PAGE_NUM) {
+        g_logHeadSector = (g_logHeadSector + 1) % LOGSTORE_SECTOR_NUM;
+        g_logHeadPage = 0;
+        flash_erase_sector(LogStoreAddr(g_logHeadSector, 0));
+        g_logStats.erases++;
+
+        /* the oldest lines are gone, the next valid sector holds the first line */
+        g_logFirstSeq = header->seq;
+        for (uint32_t i = 1; i < LOGSTORE_SECTOR_NUM; i++) {
+            if (LogStoreSectorSeq((g_logHeadSector + i) % LOGSTORE_SECTOR_NUM, &seq)) {
+                g_logFirstSeq = seq;
+                break;
+            }
+        }
+    }
+
+    header->magic = LOGSTORE_CHUNK_MAGIC;
+    header->crc = LogStoreCrc16(LogStoreCrc16(0xFFFF, (const uint8_t *)header, offsetof(LogStoreChunkHeader, crc)),
+                                g_logChunk.payload, header->len);
+    flash_write_page(LogStoreAddr(g_logHeadSector, g_logHeadPage), sizeof(LogStoreChunkHeader) + header->len,
+                     (unsigned char *)&g_logChunk);
+    g_logHeadPage++;
+    g_logStats.pages++;
+
+    header->len = 0;
+    header->num = 0;
+    header->seq = g_logNextSeq;
+
+    return 0;
+}
+
+int LogStoreInit(void)
+{
+    if (LOS_MuxCreate(&g_logMutex) != LOS_OK) {
+        return LOGSTORE_ERROR;
+    }
+
+    LogStoreScan();
+    memset(&g_logChunk, 0, sizeof(g_logChunk));
+    g_logChunk.header.seq = g_logNextSeq;
+    g_logReady = 1;
+
+    return 0;
+}
+
+int LogStoreAppend(const char *line, uint32_t len)
+{
+    LogStoreChunkHeader *header = &g_logChunk.header;
+
+    if (!g_logReady || (LOS_MuxPend(g_logMutex, LOS_WAIT_FOREVER) != LOS_OK)) {
+        g_logStats.lost++;
+        return LOGSTORE_ERROR;
+    }
+
+    if (len > LOGSTORE_LINE_MAX) {
+        len = LOGSTORE_LINE_MAX;
+        g_logStats.lost++;
+    }
+
+    if (header->len + 1 + len > LOGSTORE_PAYLOAD_MAX) {
+        (void)LogStoreProgram();
+    }
+
+    g_logChunk.payload[header->len] = (uint8_t)len;
+    memcpy(&g_logChunk.payload[header->len + 1], line, len);
+    header->len += 1 + len;
+    header->num++;
+    g_logNextSeq++;
+
+    (void)LOS_MuxPost(g_logMutex);
+
+    return 0;
+}
+
+int LogStoreFlush(void)
+{
+    int ret;
+
+    if (!g_logReady || (LOS_MuxPend(g_logMutex, LOS_WAIT_FOREVER) != LOS_OK)) {
+        return LOGSTORE_ERROR;
+    }
+
+    ret = LogStoreProgram();
+    (void)LOS_MuxPost(g_logMutex);
+
+    return ret;
+}
+
+int LogStoreRead(uint32_t seq, LogStoreReadCb cb, void *arg)
+{
+    static LogStoreChunk chunk;
+    uint32_t sector;
+    uint32_t line;
+    uint32_t off;
+
+    if (!g_logReady || (cb == NULL) || (LOS_MuxPend(g_logMutex, LOS_WAIT_FOREVER) != LOS_OK)) {
+        return LOGSTORE_ERROR;
+    }
+
+    /* oldest sector first, the head sector is the last one */
+    for (uint32_t i = 1; i <= LOGSTORE_SECTOR_NUM; i++) {
+        sector = (g_logHeadSector + i) % LOGSTORE_SECTOR_NUM;
+        for (uint32_t page = 0; page < LOGSTORE_PAGE_NUM; page++) {
+            if (!LogStoreReadChunk(sector, page, &chunk)) {
+                continue;
+            }
+            if ((int32_t)(chunk.header.seq + chunk.header.num - seq) <= 0) {
+                continue;
+            }
+            for (line = 0, off = 0; (line < chunk.header.num) && (off < chunk.header.len); line++) {
+                uint32_t len = chunk.payload[off];
+                if ((off + 1 + len > chunk.header.len) ||
+                    (((int32_t)(chunk.header.seq + line - seq) >= 0) &&
+                     cb(chunk.header.seq + line, (const char *)&chunk.payload[off + 1], len, arg))) {
+                    goto OUT;
+                }
+                off += 1 + len;
+            }
+        }
+    }
+
+OUT:
+    (void)LOS_MuxPost(g_logMutex);
+
+    return 0;
+}
+
+uint32_t LogStoreFirstSeq(void)
+{
+    return g_logFirstSeq;
+}
+
+uint32_t LogStoreNextSeq(void)
+{
+    return g_logNextSeq;
+}
+
+void LogStoreGetStats(LogStoreStats *stats)
+{
+    *stats = g_logStats;
+}
@@ -33,17 +33,23 @@
 #include <hiview_output_log.h>
 #include <utils_file.h>
 
+#include <assetfs.h>
 #include <board_config.h>
+#include <fpu_stats.h>
+#include <logstore.h>
 
 #include <b91_irq.h>
 #include <system_b91.h>
 
 #include <B91/clock.h>
+#include <B91/flash.h>
 #include <B91/gpio.h>
 #include <B91/uart.h>
 
 #include <B91/gpio_default.h>
 
+#include <B91/ext_driver/pin_mux.h>
+
 #include <../vendor/common/blt_common.h>
 
 #include "canary.h"
@@ -82,6 +88,9 @@ STATIC VOID LittlefsInit(VOID)
     printf("LittleFS_Init\r\n");
 
     struct lfs_config *cfg = LittlefsConfigGet();
+    if (cfg == NULL) {
+        return;
+    }
 
     res = mount(PAR_DATA, DIR_DATA, "littlefs", 0, cfg);
     printf("mount = %d\r\n", res);
@@ -94,11 +103,24 @@ VOID IoTWatchDogKick(VOID)
 {
 }
 
+STATIC VOID FlashEraseYield(VOID)
+{
+    (VOID)LOS_TaskYield();
+}
+
 STATIC VOID B91SystemInit(VOID)
 {
+    flash_set_erase_yield_cb(FlashEraseYield);
+
     OHOS_SystemInit();
 
     LittlefsInit();
+
+    printf("AssetFs mount = %d\r\n", AssetFsMount(ASSETFS_PHYS_ADDR));
+
+#if (LOGSTORE_ENABLE)
+    printf("LogStore init = %d\r\n", LogStoreInit());
+#endif
 }
 
 UINT32 LosAppInit(VOID)
@@ -107,6 +129,10 @@ UINT32 LosAppInit(VOID)
 
     B91IrqInit();
 
+#if (FPU_STATS_ENABLE)
+    printf("FpuStats init = %d\r\n", FpuStatsInit());
+#endif
+
     unsigned int taskID_ohos;
     TSK_INIT_PARAM_S task_ohos = {0};
 
@@ -140,7 +166,14 @@ VOID UsartInit(VOID)
 {
     unsigned short div;
     unsigned char bwpc;
+    const pin_mux_cfg_t pins[] = {
+        {(gpio_pin_e)DEBUG_UART_PIN_TX, PIN_MUX_FUNC_KEEP},
+        {(gpio_pin_e)DEBUG_UART_PIN_RX, PIN_MUX_FUNC_KEEP},
+    };
 
+    if (pin_mux_claim(PIN_MUX_OWNER_UART0, pins, sizeof(pins) / sizeof(pins[0]), 0) != 0) {
+        return;
+    }
     uart_set_pin(DEBUG_UART_PIN_TX, DEBUG_UART_PIN_RX);
     uart_reset(DEBUG_UART_PORT);
     uart_cal_div_and_bwpc(DEBUG_UART_BAUDRATE, sys_clk.pclk * HZ_IN_MHZ, &div, &bwpc);
@@ -177,6 +210,11 @@ static boolean hilog(const HiLogContent *hilogContent, uint32 len)
     static char buf[256];
     int32 bytes = LogContentFmt(buf, sizeof(buf), (const uint8 *)hilogContent);
     _write(STDOUT_FILENO, buf, bytes);
+#if (LOGSTORE_ENABLE)
+    if (bytes > 0) {
+        (void)LogStoreAppend(buf, bytes);
+    }
+#endif
     return TRUE;
 }
 
@@ -0,0 +1,184 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Word-wide memcpy/memset/memcmp/strlen, linked in place of the generic byte loops of the kernel libc
+ * (LOSCFG_TELINK_B91_STRING_OPT). They are defined as __wrap_xxx and the link uses --wrap=xxx, so every
+ * reference resolves to them whatever the archive order is, unlike a second strong definition under
+ * -z muldefs where the first one seen wins. Misaligned word accesses are not single bus cycles on the D25, so every
+ * function aligns the destination first and only uses aligned word loads and stores, memcpy with a
+ * misaligned source merges two aligned source words. The code runs from RAM, it is used by flash and
+ * BLE paths which must not fetch from flash.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <compiler.h>
+
+/* the compiler must not turn the byte loops back into calls to these functions */
+#define STRING_OPT_FUNC _attribute_ram_code_sec_noinline_ __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+#define WORD_SIZE    sizeof(uint32_t)
+#define WORD_MASK    (WORD_SIZE - 1)
+#define ONES         0x01010101U
+#define HIGHS        0x80808080U
+#define HAS_ZERO(x)  (((x) - ONES) & ~(x) & HIGHS)
+
+typedef uint32_t __attribute__((may_alias)) word_t;
+
+void *__wrap_memcpy(void *restrict dst, const void *restrict src, size_t n);
+void *__wrap_memset(void *dst, int c, size_t n);
+int __wrap_memcmp(const void *a, const void *b, size_t n);
+size_t __wrap_strlen(const char *str);
+
+STRING_OPT_FUNC void *__wrap_memcpy(void *restrict dst, const void *restrict src, size_t n)
+{
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+
+    if (n >= 2 * WORD_SIZE) {
+        while ((uintptr_t)d & WORD_MASK) {
+            *d++ = *s++;
+            n--;
+        }
+
+        word_t *dw = (word_t *)d;
+        if (((uintptr_t)s & WORD_MASK) == 0) {
+            const word_t *sw = (const word_t *)s;
+            for (; n >= 4 * WORD_SIZE; n -= 4 * WORD_SIZE) {
+                uint32_t w0 = sw[0];
+                uint32_t w1 = sw[1];
+                uint32_t w2 = sw[2];
+                uint32_t w3 = sw[3];
+                dw[0] = w0;
+                dw[1] = w1;
+                dw[2] = w2;
+                dw[3] = w3;
+                sw += 4;
+                dw += 4;
+            }
+            for (; n >= WORD_SIZE; n -= WORD_SIZE) {
+                *dw++ = *sw++;
+            }
+            s = (const uint8_t *)sw;
+        } else {
+            // little endian: each output word is the high bytes of one source word and the low bytes of the next
+            unsigned int shift = ((uintptr_t)s & WORD_MASK) * 8;
+            const word_t *sw = (const word_t *)((uintptr_t)s & ~WORD_MASK);
+            uint32_t cur = *sw++;
+            // the last aligned source word read must not pass the end of the source
+            for (; n >= 2 * WORD_SIZE; n -= WORD_SIZE) {
+                uint32_t next = *sw++;
+                *dw++ = (cur >> shift) | (next << (32 - shift));
+                cur = next;
+            }
+            s = (const uint8_t *)sw - WORD_SIZE + shift / 8;
+        }
+        d = (uint8_t *)dw;
+    }
+
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+STRING_OPT_FUNC void *__wrap_memset(void *dst, int c, size_t n)
+{
+    uint8_t *d = dst;
+
+    if (n >= 2 * WORD_SIZE) {
+        while ((uintptr_t)d & WORD_MASK) {
+            *d++ = (uint8_t)c;
+            n--;
+        }
+
+        uint32_t w = (uint8_t)c * ONES;
+        word_t *dw = (word_t *)d;
+        for (; n >= 4 * WORD_SIZE; n -= 4 * WORD_SIZE) {
+            dw[0] = w;
+            dw[1] = w;
+            dw[2] = w;
+            dw[3] = w;
+            dw += 4;
+        }
+        for (; n >= WORD_SIZE; n -= WORD_SIZE) {
+            *dw++ = w;
+        }
+        d = (uint8_t *)dw;
+    }
+
+    while (n--) {
+        *d++ = (uint8_t)c;
+    }
+    return dst;
+}
+
+STRING_OPT_FUNC int __wrap_memcmp(const void *a, const void *b, size_t n)
+{
+    const uint8_t *p = a;
+    const uint8_t *q = b;
+
+    // word compare only when both sides can be aligned together, it stops at the first different word
+    if (n >= 2 * WORD_SIZE && (((uintptr_t)p ^ (uintptr_t)q) & WORD_MASK) == 0) {
+        while ((uintptr_t)p & WORD_MASK) {
+            if (*p != *q) {
+                return *p - *q;
+            }
+            p++;
+            q++;
+            n--;
+        }
+        while (n >= WORD_SIZE && *(const word_t *)p == *(const word_t *)q) {
+            p += WORD_SIZE;
+            q += WORD_SIZE;
+            n -= WORD_SIZE;
+        }
+    }
+
+    for (; n; n--, p++, q++) {
+        if (*p != *q) {
+            return *p - *q;
+        }
+    }
+    return 0;
+}
+
+STRING_OPT_FUNC size_t __wrap_strlen(const char *str)
+{
+    const char *s = str;
+
+    while ((uintptr_t)s & WORD_MASK) {
+        if (*s == '\0') {
+            return s - str;
+        }
+        s++;
+    }
+
+    // an aligned word never crosses into the next page or memory region
+    const word_t *w = (const word_t *)s;
+    while (!HAS_ZERO(*w)) {
+        w++;
+    }
+
+    for (s = (const char *)w; *s; s++) {
+    }
+    return s - str;
+}
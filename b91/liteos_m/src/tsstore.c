@@ -0,0 +1,327 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include <los_mux.h>
+
+#include <B91/flash.h>
+
+#include <tsstore.h>
+
+#define TSSTORE_ERROR -1
+
+#define TSSTORE_BLOCK_MAGIC 0x5354 /* "TS" */
+#define TSSTORE_PAGE_NUM    (TSSTORE_SECTOR_SIZE / TSSTORE_PAGE_SIZE)
+#define TSSTORE_NO_SECTOR   0xFFFFFFFF
+#define TSSTORE_SAMPLE_MAX  10 /* two 5 byte varints */
+
+static uint16_t TsStoreCrc16(uint16_t crc, const uint8_t *buf, uint32_t len)
+{
+    while (len--) {
+        crc ^= (uint16_t)(*buf++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static uint16_t TsStoreBlockCrc(const TsStoreBlock *block)
+{
+    return TsStoreCrc16(TsStoreCrc16(0xFFFF, (const uint8_t *)&block->header, offsetof(TsStoreBlockHeader, crc)),
+                        block->payload, block->header.len);
+}
+
+/* deltas are taken modulo 2^32, so any int32 step fits in 5 bytes */
+static uint32_t TsStorePutVarint(uint8_t *buf, uint32_t delta)
+{
+    uint32_t zigzag = (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+    uint32_t n = 0;
+
+    while (zigzag >= 0x80) {
+        buf[n++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    buf[n++] = (uint8_t)zigzag;
+
+    return n;
+}
+
+static uint32_t TsStoreGetVarint(const uint8_t *buf, uint32_t len, uint32_t *off)
+{
+    uint32_t zigzag = 0;
+    uint32_t shift = 0;
+
+    while ((*off < len) && (shift < 35)) {
+        uint8_t b = buf[(*off)++];
+        zigzag |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            break;
+        }
+        shift += 7;
+    }
+
+    return (zigzag >> 1) ^ (0 - (zigzag & 1));
+}
+
+static uint32_t TsStoreAddr(const TsStore *ts, uint32_t sector, uint32_t page)
+{
+    return ts->physAddr + sector * TSSTORE_SECTOR_SIZE + page * TSSTORE_PAGE_SIZE;
+}
+
+static int TsStoreHeaderValid(const TsStoreBlockHeader *header)
+{
+    return (header->magic == TSSTORE_BLOCK_MAGIC) && (header->num != 0) &&
+           (header->len <= sizeof(((TsStoreBlock *)0)->payload));
+}
+
+static int TsStoreHeaderErased(const TsStoreBlockHeader *header)
+{
+    const uint8_t *p = (const uint8_t *)header;
+
+    for (uint32_t i = 0; i < sizeof(TsStoreBlockHeader); i++) {
+        if (p[i] != 0xFF) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int TsStoreReadPayload(const TsStore *ts, uint32_t sector, uint32_t page, TsStoreBlock *block)
+{
+    flash_read_page(TsStoreAddr(ts, sector, page) + sizeof(TsStoreBlockHeader), block->header.len, block->payload);
+
+    return TsStoreBlockCrc(block) == block->header.crc;
+}
+
+static void TsStoreScan(TsStore *ts)
+{
+    TsStoreBlock block;
+    uint32_t seq = 0;
+
+    ts->headSector = TSSTORE_NO_SECTOR;
+    for (uint32_t sector = 0; sector < ts->sectorNum; sector++) {
+        flash_read_page(TsStoreAddr(ts, sector, 0), sizeof(TsStoreBlockHeader), (unsigned char *)&block.header);
+        if (!TsStoreHeaderValid(&block.header)) {
+            continue;
+        }
+        if ((ts->headSector == TSSTORE_NO_SECTOR) || ((int32_t)(block.header.seq - seq) > 0)) {
+            ts->headSector = sector;
+            seq = block.header.seq;
+        }
+    }
+
+    ts->nextSeq = 0;
+    ts->lastTime = 0;
+    if (ts->headSector == TSSTORE_NO_SECTOR) {
+        /* empty store, the first sector is erased before use */
+        ts->headSector = ts->sectorNum - 1;
+        ts->headPage = TSSTORE_PAGE_NUM;
+        return;
+    }
+
+    /* the write position is the first erased page of the head sector, torn pages are skipped */
+    for (ts->headPage = 0; ts->headPage < TSSTORE_PAGE_NUM; ts->headPage++) {
+        flash_read_page(TsStoreAddr(ts, ts->headSector, ts->headPage), sizeof(TsStoreBlockHeader),
+                        (unsigned char *)&block.header);
+        if (TsStoreHeaderErased(&block.header)) {
+            break;
+        }
+        if (TsStoreHeaderValid(&block.header) && TsStoreReadPayload(ts, ts->headSector, ts->headPage, &block)) {
+            ts->nextSeq = block.header.seq + 1;
+            ts->lastTime = block.header.timeLast;
+        }
+    }
+}
+
+/* program the block in RAM into the next page, erasing the oldest sector when the head is full */
+static void TsStoreProgram(TsStore *ts)
+{
+    TsStoreBlockHeader *header = &ts->block.header;
+
+    if (header->num == 0) {
+        return;
+    }
+
+    if (ts->headPage >= TSSTORE_PAGE_NUM) {
+        ts->headSector = (ts->headSector + 1) % ts->sectorNum;
+        ts->headPage = 0;
+        flash_erase_sector(TsStoreAddr(ts, ts->headSector, 0));
+        ts->erases++;
+    }
+
+    header->magic = TSSTORE_BLOCK_MAGIC;
+    header->seq = ts->nextSeq++;
+    header->crc = TsStoreBlockCrc(&ts->block);
+    flash_write_page(TsStoreAddr(ts, ts->headSector, ts->headPage), sizeof(TsStoreBlockHeader) + header->len,
+                     (unsigned char *)&ts->block);
+    ts->headPage++;
+    ts->pages++;
+
+    header->num = 0;
+}
+
+/* decode a block and report the samples in range, returns non zero if the callback stopped */
+static int TsStoreDecode(const TsStoreBlock *block, const TsStoreRange *range, TsStoreQueryCb cb, void *arg)
+{
+    const TsStoreBlockHeader *header = &block->header;
+    uint32_t time = header->timeFirst;
+    uint32_t delta = 0;
+    int32_t value = header->valueFirst;
+    uint32_t off = 0;
+
+    for (uint32_t i = 0; i < header->num; i++) {
+        if (i != 0) {
+            delta += TsStoreGetVarint(block->payload, header->len, &off);
+            time += delta;
+            value = (int32_t)((uint32_t)value + TsStoreGetVarint(block->payload, header->len, &off));
+        }
+        if (time > range->timeEnd) {
+            return 1;
+        }
+        if ((time >= range->timeBegin) && (value >= range->valueLow) && (value <= range->valueHigh) &&
+            cb(time, value, arg)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int TsStoreBlockSkipped(const TsStoreBlockHeader *header, const TsStoreRange *range)
+{
+    return (header->timeLast < range->timeBegin) || (header->valueMax < range->valueLow) ||
+           (header->valueMin > range->valueHigh);
+}
+
+int TsStoreInit(TsStore *ts, uint32_t physAddr, uint32_t sectorNum)
+{
+    memset(ts, 0, sizeof(TsStore));
+    ts->physAddr = physAddr;
+    ts->sectorNum = sectorNum;
+
+    if ((sectorNum == 0) || (LOS_MuxCreate(&ts->mutex) != LOS_OK)) {
+        return TSSTORE_ERROR;
+    }
+
+    TsStoreScan(ts);
+
+    return 0;
+}
+
+int TsStoreAppend(TsStore *ts, uint32_t time, int32_t value)
+{
+    TsStoreBlockHeader *header = &ts->block.header;
+    uint8_t sample[TSSTORE_SAMPLE_MAX];
+    uint32_t len;
+
+    if (LOS_MuxPend(ts->mutex, LOS_WAIT_FOREVER) != LOS_OK) {
+        return TSSTORE_ERROR;
+    }
+
+    if (time < ts->lastTime) {
+        (void)LOS_MuxPost(ts->mutex);
+        return TSSTORE_ERROR;
+    }
+
+    if (header->num != 0) {
+        len = TsStorePutVarint(sample, (time - ts->lastTime) - ts->lastDelta);
+        len += TsStorePutVarint(sample + len, (uint32_t)value - (uint32_t)ts->lastValue);
+        if (header->len + len > sizeof(ts->block.payload)) {
+            TsStoreProgram(ts);
+        } else {
+            memcpy(&ts->block.payload[header->len], sample, len);
+            header->len += len;
+            header->num++;
+            ts->lastDelta = time - ts->lastTime;
+            header->valueMin = (value < header->valueMin) ? value : header->valueMin;
+            header->valueMax = (value > header->valueMax) ? value : header->valueMax;
+        }
+    }
+
+    /* first sample of a block is kept in the header */
+    if (header->num == 0) {
+        header->num = 1;
+        header->len = 0;
+        header->timeFirst = time;
+        header->valueFirst = value;
+        header->valueMin = value;
+        header->valueMax = value;
+        ts->lastDelta = 0;
+    }
+
+    header->timeLast = time;
+    ts->lastTime = time;
+    ts->lastValue = value;
+    ts->samples++;
+
+    (void)LOS_MuxPost(ts->mutex);
+
+    return 0;
+}
+
+int TsStoreFlush(TsStore *ts)
+{
+    if (LOS_MuxPend(ts->mutex, LOS_WAIT_FOREVER) != LOS_OK) {
+        return TSSTORE_ERROR;
+    }
+
+    TsStoreProgram(ts);
+    (void)LOS_MuxPost(ts->mutex);
+
+    return 0;
+}
+
+int TsStoreQuery(TsStore *ts, const TsStoreRange *range, TsStoreQueryCb cb, void *arg)
+{
+    static TsStoreBlock block;
+    uint32_t sector;
+    int stop = 0;
+
+    if ((range == NULL) || (cb == NULL) || (LOS_MuxPend(ts->mutex, LOS_WAIT_FOREVER) != LOS_OK)) {
+        return TSSTORE_ERROR;
+    }
+
+    /* oldest sector first, the head sector is the last one, time only goes forward */
+    for (uint32_t i = 1; (i <= ts->sectorNum) && !stop; i++) {
+        sector = (ts->headSector + i) % ts->sectorNum;
+        for (uint32_t page = 0; (page < TSSTORE_PAGE_NUM) && !stop; page++) {
+            flash_read_page(TsStoreAddr(ts, sector, page), sizeof(TsStoreBlockHeader), (unsigned char *)&block.header);
+            if (!TsStoreHeaderValid(&block.header) || TsStoreBlockSkipped(&block.header, range)) {
+                continue;
+            }
+            if (block.header.timeFirst > range->timeEnd) {
+                stop = 1;
+            } else if (TsStoreReadPayload(ts, sector, page, &block)) {
+                stop = TsStoreDecode(&block, range, cb, arg);
+            }
+        }
+    }
+
+    if (!stop && (ts->block.header.num != 0) && !TsStoreBlockSkipped(&ts->block.header, range)) {
+        (void)TsStoreDecode(&ts->block, range, cb, arg);
+    }
+
+    (void)LOS_MuxPost(ts->mutex);
+
+    return 0;
+}
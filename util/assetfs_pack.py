@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Pack a directory into a read-only asset image for liteos_m/src/assetfs.c.
+
+usage: assetfs_pack.py assets_dir -o assets.bin [--align 16] [--max-size 262144]
+       assetfs_pack.py assets.bin --list
+
+Files are named by their path relative to assets_dir, with '/' separators.
+Flash assets.bin at ASSETFS_PHYS_ADDR.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = 0x31534641
+VERSION = 1
+HEADER_FMT = '<IHHIIII'
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+ENTRY_FMT = '<IIII'
+ENTRY_SIZE = struct.calcsize(ENTRY_FMT)
+
+
+def align_up(value, align):
+    return (value + align - 1) // align * align
+
+
+def collect(root):
+    files = []
+    for base, _, names in os.walk(root):
+        for name in names:
+            path = os.path.join(base, name)
+            files.append((os.path.relpath(path, root).replace(os.sep, '/').encode(), path))
+    # the device does a bytewise strcmp binary search
+    files.sort(key=lambda f: f[0])
+    return files
+
+
+def pack(files, align):
+    if align < 4 or align & (align - 1):
+        raise ValueError('align must be a power of 2 and at least 4')
+    names = b''.join(name + b'\0' for name, _ in files)
+    name_base = HEADER_SIZE + ENTRY_SIZE * len(files)
+    data_base = align_up(name_base + len(names), align)
+
+    entries = b''
+    data = b''
+    name_off = name_base
+    for name, path in files:
+        with open(path, 'rb') as f:
+            blob = f.read()
+        data += b'\0' * (align_up(data_base + len(data), align) - data_base - len(data))
+        entries += struct.pack(ENTRY_FMT, name_off, data_base + len(data), len(blob), zlib.crc32(blob))
+        data += blob
+        name_off += len(name) + 1
+
+    directory = entries + names
+    directory += b'\0' * (data_base - HEADER_SIZE - len(directory))
+    image_size = data_base + len(data)
+    head = struct.pack(HEADER_FMT[:-1], MAGIC, VERSION, len(files), image_size, align, zlib.crc32(directory))
+    return head + struct.pack('<I', zlib.crc32(head)) + directory + data
+
+
+def list_image(image):
+    magic, version, num, size, align, _, _ = struct.unpack_from(HEADER_FMT, image)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError('not an asset image')
+    print('%d files, %d bytes, align %d' % (num, size, align))
+    for i in range(num):
+        name_off, data_off, length, crc = struct.unpack_from(ENTRY_FMT, image, HEADER_SIZE + i * ENTRY_SIZE)
+        name = image[name_off:image.index(b'\0', name_off)].decode()
+        ok = zlib.crc32(image[data_off:data_off + length]) == crc
+        print('  0x%06x %8d %s%s' % (data_off, length, name, '' if ok else '  CRC ERROR'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help='asset directory, or an image with --list')
+    parser.add_argument('-o', '--output')
+    parser.add_argument('--align', type=int, default=16, help='file data alignment in bytes')
+    parser.add_argument('--max-size', type=int, default=256 * 1024, help='ASSETFS_PHYS_SIZE of the target')
+    parser.add_argument('--list', action='store_true')
+    args = parser.parse_args()
+
+    if args.list:
+        with open(args.input, 'rb') as f:
+            list_image(f.read())
+        return
+
+    if not args.output:
+        parser.error('-o is required')
+    image = pack(collect(args.input), args.align)
+    if len(image) > args.max_size:
+        sys.exit('image is %d bytes, region is %d bytes' % (len(image), args.max_size))
+    with open(args.output, 'wb') as f:
+        f.write(image)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Convert a blt_dbg_trace UART dump to VCD or to a Perfetto (Chrome JSON) trace.
+
+usage: dbg_trace2vcd.py dump.bin -o out.vcd [--name 0=RF --name 1=IRQ ...]
+       dbg_trace2vcd.py dump.bin -o out.json --format json
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = 0x54474244
+TICK_BITS = 27
+TICK_PER_US = 16
+EDGE_LOW, EDGE_HIGH, EDGE_TOGGLE = 0, 1, 2
+CHN_NUM = 8
+
+
+def parse_dump(data):
+    """Return (total, records) of the first frame found in data, records are raw words."""
+    pos = data.find(struct.pack('<I', MAGIC))
+    if pos < 0 or pos + 12 > len(data):
+        raise ValueError('no trace frame found')
+    _, total, num = struct.unpack_from('<III', data, pos)
+    body = pos + 12
+    if body + num * 4 > len(data):
+        raise ValueError('trace frame truncated')
+    return total, list(struct.unpack_from('<%dI' % num, data, body))
+
+
+def decode(records):
+    """Return [(tick, chn, edge)], tick unwrapped to a monotonic 64 bit value starting at 0."""
+    events = []
+    mask = (1 << TICK_BITS) - 1
+    tick = 0
+    last = None
+    for w in records:
+        raw = w >> 5
+        if last is not None:
+            tick += (raw - last) & mask
+        last = raw
+        events.append((tick, (w >> 2) & 0x7, w & 0x3))
+    return events
+
+
+def levels(events):
+    """Resolve toggles to levels: [(tick, chn, level)], channels start low."""
+    state = [0] * CHN_NUM
+    out = []
+    for tick, chn, edge in events:
+        if edge == EDGE_TOGGLE:
+            state[chn] ^= 1
+        else:
+            state[chn] = 1 if edge == EDGE_HIGH else 0
+        out.append((tick, chn, state[chn]))
+    return out
+
+
+def write_vcd(f, events, names):
+    f.write('$timescale 1ns $end\n$scope module dbg $end\n')
+    for chn in range(CHN_NUM):
+        f.write('$var wire 1 %s %s $end\n' % (chr(ord('!') + chn), names.get(chn, 'chn%d' % chn)))
+    f.write('$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n')
+    for chn in range(CHN_NUM):
+        f.write('0%s\n' % chr(ord('!') + chn))
+    f.write('$end\n')
+    last = 0
+    for tick, chn, level in levels(events):
+        ns = tick * 1000 // TICK_PER_US
+        if ns != last:
+            f.write('#%d\n' % ns)
+            last = ns
+        f.write('%d%s\n' % (level, chr(ord('!') + chn)))
+
+
+def write_json(f, events, names):
+    trace = []
+    for chn in range(CHN_NUM):
+        trace.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': chn,
+                      'args': {'name': names.get(chn, 'chn%d' % chn)}})
+    state = [0] * CHN_NUM
+    for tick, chn, level in levels(events):
+        if level == state[chn]:
+            continue
+        state[chn] = level
+        trace.append({'name': names.get(chn, 'chn%d' % chn), 'ph': 'B' if level else 'E',
+                      'pid': 1, 'tid': chn, 'ts': tick / TICK_PER_US})
+    json.dump({'traceEvents': trace, 'displayTimeUnit': 'ns'}, f)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('dump', help='raw UART capture containing the trace frame')
+    parser.add_argument('-o', '--output', required=True)
+    parser.add_argument('--format', choices=['vcd', 'json'], default='vcd')
+    parser.add_argument('--name', action='append', default=[], help='channel name, e.g. 0=RF')
+    args = parser.parse_args()
+
+    names = {}
+    for item in args.name:
+        chn, name = item.split('=', 1)
+        names[int(chn)] = name
+
+    with open(args.dump, 'rb') as f:
+        total, records = parse_dump(f.read())
+    if total > len(records):
+        sys.stderr.write('%d oldest events overwritten in ring\n' % (total - len(records)))
+
+    events = decode(records)
+    with open(args.output, 'w') as f:
+        if args.format == 'vcd':
+            write_vcd(f, events, names)
+        else:
+            write_json(f, events, names)
+
+
+if __name__ == '__main__':
+    main()
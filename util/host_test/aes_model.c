@@ -0,0 +1,192 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * AES-128 in software with the FIPS-197 byte order, standing in for the B91 AES engine in host tests.
+ * Slow and straightforward, it only has to be correct.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <B91/aes.h>
+
+#define AES_ROUNDS 10
+
+static uint8_t g_sbox[256];
+static uint8_t g_sboxInv[256];
+static unsigned int g_aesBlocks;
+
+static uint8_t AesXtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1B : 0));
+}
+
+static uint8_t AesMul(uint8_t a, uint8_t b)
+{
+    uint8_t r = 0;
+
+    while (b) {
+        if (b & 1) {
+            r ^= a;
+        }
+        a = AesXtime(a);
+        b >>= 1;
+    }
+
+    return r;
+}
+
+/* the S-box from the multiplicative inverse and the affine map */
+static void AesSboxInit(void)
+{
+    if (g_sbox[0] != 0) {
+        return;
+    }
+
+    for (int x = 0; x < 256; x++) {
+        uint8_t inv = 0;
+        uint8_t s;
+        for (int y = 1; (x != 0) && (y < 256); y++) {
+            if (AesMul((uint8_t)x, (uint8_t)y) == 1) {
+                inv = (uint8_t)y;
+                break;
+            }
+        }
+        s = inv;
+        for (int i = 1; i < 5; i++) {
+            s ^= (uint8_t)((inv << i) | (inv >> (8 - i)));
+        }
+        s ^= 0x63;
+        g_sbox[x] = s;
+        g_sboxInv[s] = (uint8_t)x;
+    }
+}
+
+static void AesExpandKey(const uint8_t *key, uint8_t roundKey[AES_ROUNDS + 1][16])
+{
+    uint8_t rcon = 1;
+
+    (void)memcpy(roundKey[0], key, 16);
+    for (int r = 1; r <= AES_ROUNDS; r++) {
+        const uint8_t *prev = roundKey[r - 1];
+        uint8_t *next = roundKey[r];
+        next[0] = prev[0] ^ g_sbox[prev[13]] ^ rcon;
+        next[1] = prev[1] ^ g_sbox[prev[14]];
+        next[2] = prev[2] ^ g_sbox[prev[15]];
+        next[3] = prev[3] ^ g_sbox[prev[12]];
+        for (int i = 4; i < 16; i++) {
+            next[i] = prev[i] ^ next[i - 4];
+        }
+        rcon = AesXtime(rcon);
+    }
+}
+
+static void AesAddRoundKey(uint8_t *s, const uint8_t *k)
+{
+    for (int i = 0; i < 16; i++) {
+        s[i] ^= k[i];
+    }
+}
+
+/* the state is column major, byte i is row i % 4 of column i / 4 */
+static void AesShiftRows(uint8_t *s, int inverse)
+{
+    uint8_t t[16];
+
+    for (int i = 0; i < 16; i++) {
+        int row = i % 4;
+        int col = i / 4;
+        int from = inverse ? (col - row + 4) % 4 : (col + row) % 4;
+        t[i] = s[from * 4 + row];
+    }
+    (void)memcpy(s, t, 16);
+}
+
+static void AesMixColumns(uint8_t *s, int inverse)
+{
+    static const uint8_t fwd[4] = { 2, 3, 1, 1 };
+    static const uint8_t inv[4] = { 14, 11, 13, 9 };
+    const uint8_t *m = inverse ? inv : fwd;
+    uint8_t c[4];
+
+    for (int col = 0; col < 4; col++) {
+        (void)memcpy(c, &s[col * 4], 4);
+        for (int row = 0; row < 4; row++) {
+            s[col * 4 + row] = AesMul(c[0], m[(4 - row) % 4]) ^ AesMul(c[1], m[(5 - row) % 4]) ^
+                               AesMul(c[2], m[(6 - row) % 4]) ^ AesMul(c[3], m[(7 - row) % 4]);
+        }
+    }
+}
+
+int aes_encrypt(unsigned char *key, unsigned char *plaintext, unsigned char *result)
+{
+    uint8_t roundKey[AES_ROUNDS + 1][16];
+    uint8_t s[16];
+
+    AesSboxInit();
+    AesExpandKey(key, roundKey);
+    (void)memcpy(s, plaintext, 16);
+
+    AesAddRoundKey(s, roundKey[0]);
+    for (int r = 1; r <= AES_ROUNDS; r++) {
+        for (int i = 0; i < 16; i++) {
+            s[i] = g_sbox[s[i]];
+        }
+        AesShiftRows(s, 0);
+        if (r != AES_ROUNDS) {
+            AesMixColumns(s, 0);
+        }
+        AesAddRoundKey(s, roundKey[r]);
+    }
+
+    (void)memcpy(result, s, 16);
+    g_aesBlocks++;
+    return 0;
+}
+
+int aes_decrypt(unsigned char *key, unsigned char *decrypttext, unsigned char *result)
+{
+    uint8_t roundKey[AES_ROUNDS + 1][16];
+    uint8_t s[16];
+
+    AesSboxInit();
+    AesExpandKey(key, roundKey);
+    (void)memcpy(s, decrypttext, 16);
+
+    AesAddRoundKey(s, roundKey[AES_ROUNDS]);
+    for (int r = AES_ROUNDS - 1; r >= 0; r--) {
+        AesShiftRows(s, 1);
+        for (int i = 0; i < 16; i++) {
+            s[i] = g_sboxInv[s[i]];
+        }
+        AesAddRoundKey(s, roundKey[r]);
+        if (r != 0) {
+            AesMixColumns(s, 1);
+        }
+    }
+
+    (void)memcpy(result, s, 16);
+    g_aesBlocks++;
+    return 0;
+}
+
+unsigned int aes_model_block_count(void)
+{
+    return g_aesBlocks;
+}
@@ -0,0 +1,299 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of liteos_m/src/assetfs.c over an image packed by util/assetfs_pack.py. "assetfs_test gen <dir>" writes
+ * the asset tree, run.sh packs it, and "assetfs_test <image>" maps the image file and checks that every file is
+ * found in place with its content and alignment, that missing names are not found, and that corrupted images are
+ * refused at mount, including directories with a valid crc whose names run past the directory. Also prints the
+ * binary search lookup time.
+ */
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "assetfs.h"
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define FILE_NUM   200
+#define ALIGN      16 /* default of the packer */
+#define LOOKUP_NUM 100000
+
+static const char *g_dirs[] = {"audio", "certs", "fonts", "lut"};
+
+static void FileName(char *name, size_t len, int index)
+{
+    snprintf(name, len, "%s/f%03d.bin", g_dirs[index % 4], index);
+}
+
+/* index 0 is empty, the others up to 2 KB */
+static uint32_t FileSize(int index)
+{
+    return (uint32_t)(index * 331) % 2000;
+}
+
+static uint8_t FileByte(int index, uint32_t pos)
+{
+    return (uint8_t)(index * 17 + pos * 3);
+}
+
+static uint32_t Crc32(const uint8_t *buf, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (len--) {
+        crc ^= *buf++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+
+    return ~crc;
+}
+
+static void Generate(const char *root)
+{
+    char path[512];
+    char name[32];
+
+    for (int d = 0; d < 4; d++) {
+        snprintf(path, sizeof(path), "%s/%s", root, g_dirs[d]);
+        mkdir(path, 0700);
+    }
+    for (int i = 0; i < FILE_NUM; i++) {
+        FileName(name, sizeof(name), i);
+        snprintf(path, sizeof(path), "%s/%s", root, name);
+        FILE *f = fopen(path, "wb");
+        CHECK(f != NULL);
+        for (uint32_t pos = 0; pos < FileSize(i); pos++) {
+            fputc(FileByte(i, pos), f);
+        }
+        fclose(f);
+    }
+}
+
+static void CheckLookup(const uint8_t *image, uint32_t imageSize)
+{
+    static const char *missing[] = {"", "a", "audio", "audio/", "audio/f000.bin0", "certs/f000.bin", "zz", "lut/f999.bin"};
+    char name[32];
+    uint32_t size;
+
+    CHECK(AssetFsCount() == FILE_NUM);
+    for (int i = 0; i < FILE_NUM; i++) {
+        FileName(name, sizeof(name), i);
+        const uint8_t *data = AssetFsGet(name, &size);
+        CHECK(data != NULL && size == FileSize(i));
+        CHECK(data >= image + sizeof(AssetFsHeader) && data + size <= image + imageSize);
+        CHECK((data - image) % ALIGN == 0);
+        for (uint32_t pos = 0; pos < size; pos++) {
+            CHECK(data[pos] == FileByte(i, pos));
+        }
+        CHECK(AssetFsVerify(name) == 0);
+    }
+    for (unsigned int i = 0; i < sizeof(missing) / sizeof(missing[0]); i++) {
+        CHECK(AssetFsGet(missing[i], &size) == NULL);
+        CHECK(AssetFsVerify(missing[i]) != 0);
+    }
+    CHECK(AssetFsGet(NULL, &size) == NULL);
+}
+
+/* header and directory crcs are made valid again, so only the structure checks can refuse the image */
+static void Reseal(uint8_t *image)
+{
+    AssetFsHeader *header = (AssetFsHeader *)image;
+    const AssetFsEntry *entry = (const AssetFsEntry *)(header + 1);
+    uint32_t dirEnd = header->imageSize;
+
+    for (uint32_t i = 0; i < FILE_NUM; i++) {
+        if (entry[i].dataOffset < dirEnd) {
+            dirEnd = entry[i].dataOffset;
+        }
+    }
+    header->dirCrc = Crc32((const uint8_t *)entry, dirEnd - sizeof(AssetFsHeader));
+    header->headerCrc = Crc32(image, offsetof(AssetFsHeader, headerCrc));
+}
+
+static int MountCopy(const uint8_t *copy, uint32_t size)
+{
+    int ret = AssetFsMountAt(copy, size);
+
+    CHECK(ret != 0 || AssetFsCount() != 0);
+    CHECK(ret == 0 || AssetFsCount() == 0);
+    return ret;
+}
+
+static void CheckCorruption(const uint8_t *image, uint32_t imageSize)
+{
+    uint8_t *copy = malloc(imageSize);
+    AssetFsHeader *header = (AssetFsHeader *)copy;
+    AssetFsEntry *entry = (AssetFsEntry *)(header + 1);
+    uint32_t nameEnd = sizeof(AssetFsHeader) + FILE_NUM * sizeof(AssetFsEntry);
+    char name[32];
+
+    CHECK(copy != NULL);
+    for (int i = 0; i < FILE_NUM; i++) {
+        FileName(name, sizeof(name), i);
+        nameEnd += strlen(name) + 1;
+    }
+
+#define RESET() memcpy(copy, image, imageSize)
+
+    RESET();
+    CHECK(MountCopy(copy, imageSize) == 0);
+    CHECK(MountCopy(copy, imageSize - 1) != 0);
+    CHECK(MountCopy(copy, sizeof(AssetFsHeader) - 1) != 0);
+    CHECK(AssetFsMountAt(NULL, imageSize) != 0);
+
+    // every byte of the header and directory is covered by a crc
+    for (uint32_t pos = 0; pos < nameEnd; pos += 7) {
+        RESET();
+        copy[pos] ^= 0x20;
+        CHECK(MountCopy(copy, imageSize) != 0);
+    }
+
+    // file data is only checked by AssetFsVerify, of that file alone
+    RESET();
+    FileName(name, sizeof(name), 5);
+    CHECK(MountCopy(copy, imageSize) == 0);
+    copy[(const uint8_t *)AssetFsGet(name, NULL) - copy + 1] ^= 1;
+    CHECK(MountCopy(copy, imageSize) == 0);
+    for (int i = 0; i < FILE_NUM; i++) {
+        FileName(name, sizeof(name), i);
+        CHECK((AssetFsVerify(name) == 0) == (i != 5));
+    }
+
+    // the last name loses its NUL: it would run into the padding and the file data
+    RESET();
+    for (uint32_t pos = nameEnd - 1; pos < entry[0].dataOffset; pos++) {
+        copy[pos] = 'x';
+    }
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+
+    // names outside the directory: in the entry table, in the file data, past the image
+    RESET();
+    entry[3].nameOffset = sizeof(AssetFsHeader) + 4;
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+    RESET();
+    entry[3].nameOffset = entry[10].dataOffset + 1;
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+    RESET();
+    entry[3].nameOffset = imageSize + 100;
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+
+    // data outside the image, or overlapping the entry table
+    RESET();
+    entry[7].size = imageSize;
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+    RESET();
+    entry[7].dataOffset = imageSize + 1;
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+    RESET();
+    entry[7].dataOffset = sizeof(AssetFsHeader) + 16;
+    entry[7].size = 0;
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+
+    // more entries than fit, an image larger than the region
+    RESET();
+    header->entryNum = 0xFFFF;
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+    RESET();
+    header->imageSize = imageSize + 1;
+    Reseal(copy);
+    CHECK(MountCopy(copy, imageSize) != 0);
+
+#undef RESET
+    free(copy);
+}
+
+static void Benchmark(void)
+{
+    char names[FILE_NUM][32];
+    struct timespec start, end;
+    uint32_t size;
+    uint32_t found = 0;
+
+    for (int i = 0; i < FILE_NUM; i++) {
+        FileName(names[i], sizeof(names[i]), i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < LOOKUP_NUM; i++) {
+        found += AssetFsGet(names[(i * 37) % FILE_NUM], &size) != NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    CHECK(found == LOOKUP_NUM);
+    printf("assetfs_test: %d files, %.0f ns per lookup\n", FILE_NUM,
+           ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / LOOKUP_NUM);
+}
+
+int main(int argc, char **argv)
+{
+    struct stat st;
+    const uint8_t *image;
+    int fd;
+
+    if (argc == 3 && strcmp(argv[1], "gen") == 0) {
+        Generate(argv[2]);
+        return 0;
+    }
+    CHECK(argc == 2);
+
+    fd = open(argv[1], O_RDONLY);
+    CHECK(fd >= 0 && fstat(fd, &st) == 0);
+    image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    CHECK(image != MAP_FAILED);
+
+    CHECK(AssetFsCount() == 0 && AssetFsGet("certs/f001.bin", NULL) == NULL);
+    CHECK(AssetFsMountAt(image, st.st_size) == 0);
+    CheckLookup(image, st.st_size);
+    Benchmark();
+    AssetFsUnmount();
+    CHECK(AssetFsCount() == 0);
+
+    CheckCorruption(image, st.st_size);
+
+    // the image still mounts after the failed mounts of its copies
+    CHECK(AssetFsMountAt(image, st.st_size) == 0);
+    CheckLookup(image, st.st_size);
+
+    munmap((void *)image, st.st_size);
+    close(fd);
+    printf("assetfs_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,319 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host simulation of vendor/common/blm_conn_manager.c against a virtual radio timeline.
+ * One master link, connect/poll/disconnect take fixed radio times, two periodic windows are reserved. One peer never
+ * answers the connect and one terminates its link after the manager gave up waiting. Checks that complete cycles
+ * never overlap a reserved window, that the late disconnect does not close the next cycle, and prints the peers
+ * served per minute.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tl_common.h"
+
+#include "blm_conn_manager.h"
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define MS(x)           ((x) * SYSTEM_TIMER_TICK_1MS)
+#define STEP_TICK       (100 * SYSTEM_TIMER_TICK_1US)
+#define RUN_MS          60000
+
+#define PEER_NUM        30
+#define PEER_BONDED     10
+#define PEER_DEAD       29 /* never answers the connect */
+#define PEER_SLOW       28 /* link goes down after the disconnect timeout */
+#define INTERVAL_MS     3000
+
+#define CONNECT_SCAN_MS 30
+#define CONNECT_FAST_MS 8
+#define POLL_MS         10
+#define DISCONNECT_MS   5
+#define SLOW_DISCONNECT_MS (BLM_CONN_MGR_DISCONNECT_TIMEOUT_US / 1000 + 30)
+#define CONN_HANDLE     0x80 /* the master link always gets the same handle */
+
+#define PAIR_MAX        16
+
+typedef enum {
+    EV_NONE = 0,
+    EV_CONNECTED,
+    EV_POLL_DONE,
+    EV_DISCONNECTED,
+} EventType;
+
+typedef struct {
+    u32 when;
+    u8 type;
+    u8 peer;
+} Event;
+
+typedef struct {
+    u32 anchor;
+    u32 interval;
+    u32 duration;
+} Window;
+
+u32 g_hostTick;
+
+static const Window g_windows[] = {
+    { MS(3), MS(100), MS(4) },  /* slave link anchor */
+    { MS(41), MS(150), MS(3) }, /* advertising */
+};
+
+static Event g_events[8];
+static u8 g_pair[PAIR_MAX][7];
+static int g_pairNum;
+static u8 g_peerIdx[PEER_NUM]; /* manager index of every simulated peer */
+static u8 g_mac[PEER_NUM][6];
+
+static int g_linkUp;
+static u8 g_linkPeer;
+static int g_connectWaiting = -1; /* peer waiting for the old link to go down */
+static u32 g_cycleStart;
+static int g_cycleClean; /* the cycle started on a free radio */
+static u32 g_cycles;
+static u32 g_overlaps;
+static u32 g_lateEvents;
+
+int user_tbl_slave_mac_search(u8 adr_type, u8 *adr)
+{
+    for (int i = 0; i < g_pairNum; i++) {
+        if (g_pair[i][0] == adr_type && !memcmp(&g_pair[i][1], adr, 6)) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+int user_tbl_slave_mac_add(u8 adr_type, u8 *adr)
+{
+    if (g_pairNum >= PAIR_MAX) {
+        return 0;
+    }
+    g_pair[g_pairNum][0] = adr_type;
+    memcpy(&g_pair[g_pairNum][1], adr, 6);
+    g_pairNum++;
+    return 1;
+}
+
+int user_tbl_slave_mac_free_num(void)
+{
+    return PAIR_MAX - g_pairNum;
+}
+
+static int SimPeer(u8 mgrIdx)
+{
+    for (int i = 0; i < PEER_NUM; i++) {
+        if (g_peerIdx[i] == mgrIdx) {
+            return i;
+        }
+    }
+    CHECK(0);
+    return -1;
+}
+
+static int SimPeerByMac(const u8 *mac)
+{
+    for (int i = 0; i < PEER_NUM; i++) {
+        if (!memcmp(g_mac[i], mac, 6)) {
+            return i;
+        }
+    }
+    CHECK(0);
+    return -1;
+}
+
+static void Post(u32 delayMs, u8 type, u8 peer)
+{
+    for (u32 i = 0; i < sizeof(g_events) / sizeof(g_events[0]); i++) {
+        if (g_events[i].type == EV_NONE) {
+            g_events[i].when = g_hostTick + MS(delayMs);
+            g_events[i].type = type;
+            g_events[i].peer = peer;
+            return;
+        }
+    }
+    CHECK(0);
+}
+
+static void Cancel(u8 type)
+{
+    for (u32 i = 0; i < sizeof(g_events) / sizeof(g_events[0]); i++) {
+        if (g_events[i].type == type) {
+            g_events[i].type = EV_NONE;
+        }
+    }
+}
+
+static void StartConnect(int peer, u8 fast)
+{
+    if (peer != PEER_DEAD) {
+        Post(fast ? CONNECT_FAST_MS : CONNECT_SCAN_MS, EV_CONNECTED, (u8)peer);
+    }
+}
+
+static int OpConnect(u8 adr_type, u8 *mac, u8 fast)
+{
+    int peer = SimPeerByMac(mac);
+
+    g_cycleStart = g_hostTick;
+    g_cycleClean = !g_linkUp;
+    if (g_linkUp) {
+        g_connectWaiting = peer; /* one link only, the connection is created after the old one is gone */
+        return 0;
+    }
+    StartConnect(peer, fast);
+    return 0;
+}
+
+static int OpPoll(u8 peer_idx)
+{
+    Post(POLL_MS, EV_POLL_DONE, (u8)SimPeer(peer_idx));
+    return 0;
+}
+
+static int OpDisconnect(u8 peer_idx)
+{
+    int peer = SimPeer(peer_idx);
+
+    if (!g_linkUp || g_linkPeer != peer) { /* cancel create connection */
+        Cancel(EV_CONNECTED);
+        if (g_connectWaiting == peer) {
+            g_connectWaiting = -1;
+        }
+        return 1;
+    }
+    Post(peer == PEER_SLOW ? SLOW_DISCONNECT_MS : DISCONNECT_MS, EV_DISCONNECTED, (u8)peer);
+    return 0;
+}
+
+static const blm_conn_mgr_ops_t g_ops = { OpConnect, OpPoll, OpDisconnect };
+
+/* complete cycle [start, end) against every occurrence of the reserved windows */
+static void CheckOverlap(u32 start, u32 end)
+{
+    for (u32 w = 0; w < sizeof(g_windows) / sizeof(g_windows[0]); w++) {
+        const Window *win = &g_windows[w];
+        u32 k = (start - win->anchor) / win->interval;
+        for (u32 at = win->anchor + k * win->interval; at < end; at += win->interval) {
+            if (at + win->duration > start) {
+                g_overlaps++;
+            }
+        }
+    }
+}
+
+static void Dispatch(Event *ev)
+{
+    blm_peer_t *p = blm_conn_mgr_get_peer(g_peerIdx[ev->peer]);
+
+    switch (ev->type) {
+        case EV_CONNECTED:
+            g_linkUp = 1;
+            g_linkPeer = ev->peer;
+            blm_conn_mgr_on_connected(CONN_HANDLE, p->adr_type, p->mac);
+            break;
+        case EV_POLL_DONE:
+            blm_conn_mgr_on_poll_done(1);
+            break;
+        case EV_DISCONNECTED:
+            g_linkUp = 0;
+            if (ev->peer == PEER_SLOW) {
+                g_lateEvents++;
+            } else if (g_cycleClean) {
+                g_cycles++;
+                CheckOverlap(g_cycleStart, g_hostTick);
+            }
+            blm_conn_mgr_on_disconnected(CONN_HANDLE);
+            if (g_connectWaiting >= 0) {
+                int peer = g_connectWaiting;
+                g_connectWaiting = -1;
+                StartConnect(peer, blm_conn_mgr_get_peer(g_peerIdx[peer])->bonded);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+int main(void)
+{
+    u32 served = 0;
+
+    g_hostTick = MS(1);
+    blm_conn_mgr_init(&g_ops, 50000);
+    CHECK(blm_conn_mgr_reserve(g_windows[0].anchor, 100000, 4000));
+    CHECK(blm_conn_mgr_reserve(g_windows[1].anchor, 150000, 3000));
+
+    for (int i = 0; i < PEER_NUM; i++) {
+        g_mac[i][0] = (u8)i;
+        g_mac[i][5] = 0xC0;
+        if (i < PEER_BONDED) {
+            CHECK(user_tbl_slave_mac_add(0, g_mac[i]));
+        }
+        g_peerIdx[i] = blm_conn_mgr_add_peer(0, g_mac[i], INTERVAL_MS);
+        CHECK(g_peerIdx[i] != BLM_CONN_MGR_INVALID_IDX);
+    }
+
+    for (u32 t = 0; t < MS(RUN_MS); t += STEP_TICK) {
+        g_hostTick += STEP_TICK;
+        for (u32 i = 0; i < sizeof(g_events) / sizeof(g_events[0]); i++) {
+            if (g_events[i].type != EV_NONE && (s32)(g_hostTick - g_events[i].when) >= 0) {
+                Event ev = g_events[i];
+                g_events[i].type = EV_NONE;
+                Dispatch(&ev);
+            }
+        }
+        blm_conn_mgr_process();
+    }
+
+    for (int i = 0; i < PEER_NUM; i++) {
+        blm_peer_t *p = blm_conn_mgr_get_peer(g_peerIdx[i]);
+        if (i == PEER_DEAD) {
+            CHECK(p->stat.served_cnt == 0);
+            CHECK(p->stat.fail_cnt >= RUN_MS / INTERVAL_MS - 1);
+            continue;
+        }
+        /* the late disconnect of PEER_SLOW never fails or drops the cycle after it */
+        CHECK(p->stat.fail_cnt == 0);
+        CHECK(p->stat.served_cnt >= RUN_MS / INTERVAL_MS - 1);
+        CHECK(p->stat.sched_max_us < INTERVAL_MS * 1000);
+        served += p->stat.served_cnt;
+    }
+
+    /* the timeouts of PEER_DEAD and PEER_SLOW must not raise the budget past the reserved gaps */
+    CHECK(g_lateEvents > 0);
+    CHECK(g_cycles > 0);
+    CHECK(g_overlaps == 0);
+    CHECK(blm_conn_mgr_get_served_per_min() >= (PEER_NUM - 1) * 60000 / INTERVAL_MS * 95 / 100);
+
+    printf("blm_conn_mgr_test: ok, %u peers served per minute, %u served, %u bonded\n",
+           (unsigned)blm_conn_mgr_get_served_per_min(), (unsigned)served, (unsigned)g_pairNum);
+
+    return 0;
+}
@@ -0,0 +1,326 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of vendor/common/blt_led_engine.c played through the real vendor/common/blt_soft_timer.c on a virtual
+ * clock. The main loop jumps to the wakeup tick the soft timer asks the stack for, optionally late, and runs
+ * blt_soft_timer_process there. Checks blink and breathe edges against the script timebase, also with late wakeups,
+ * several LEDs on one timer, priorities, and that a rejected blink leaves the running script alone.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tl_common.h"
+
+#include "blt_led_engine.h"
+#include "stack/ble/ble.h"
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define MS(x) ((u32)(x) * SYSTEM_TIMER_TICK_1MS)
+
+#define LED_GPIO_HIGH 0 /* GPIO, high on */
+#define LED_GPIO_LOW  1 /* GPIO, low on */
+#define LED_PWM_HIGH  2
+#define LED_PWM_LOW   3
+
+#define PIN_BUSY  0x410 /* owned by another driver */
+#define PWM_TMAX  1000
+#define EDGE_MAX  256
+#define LATE_NONE 0
+
+typedef struct {
+    u32 tick;
+    u8 led;
+    u16 level; /* GPIO: 0 / 1, PWM: high time in PWM clocks */
+} Edge;
+
+extern blt_led_t blt_led[BLT_LED_MAX_NUM];
+extern blt_soft_timer_t blt_timer;
+
+u32 g_hostTick;
+u32 g_hostMstatus;
+
+static const gpio_pin_e g_ledPin[BLT_LED_MAX_NUM] = {0x101, 0x102, 0x204, 0x208};
+static const u8 g_ledHighOn[BLT_LED_MAX_NUM] = {1, 0, 1, 0};
+static u16 g_level[BLT_LED_MAX_NUM];
+static Edge g_edge[EDGE_MAX];
+static int g_edgeNum;
+static u32 g_wakeTick;
+static u8 g_wakeEn;
+
+static void SetLevel(u8 led, u16 level)
+{
+    if (level == g_level[led]) {
+        return;
+    }
+    g_level[led] = level;
+    CHECK(g_edgeNum < EDGE_MAX);
+    g_edge[g_edgeNum].tick = g_hostTick;
+    g_edge[g_edgeNum].led = led;
+    g_edge[g_edgeNum].level = level;
+    g_edgeNum++;
+}
+
+static u8 LedOfPin(gpio_pin_e pin)
+{
+    for (u8 i = 0; i < BLT_LED_MAX_NUM; i++) {
+        if (g_ledPin[i] == pin) {
+            return i;
+        }
+    }
+    CHECK(0);
+    return 0;
+}
+
+void gpio_function_en(gpio_pin_e pin)
+{
+}
+
+void gpio_output_en(gpio_pin_e pin)
+{
+}
+
+void gpio_set_level(gpio_pin_e pin, unsigned char value)
+{
+    u8 led = LedOfPin(pin);
+
+    CHECK(value <= 1);
+    SetLevel(led, g_ledHighOn[led] ? value : !value);
+}
+
+void pwm_set_pin(gpio_pin_e pin)
+{
+}
+
+void pwm_set_tmax(pwm_id_e id, unsigned short tmax)
+{
+    CHECK(tmax == PWM_TMAX);
+}
+
+/* PWM channel n drives LED_PWM_HIGH + n */
+void pwm_set_tcmp(pwm_id_e id, unsigned short tcmp)
+{
+    u8 led = LED_PWM_HIGH + id;
+
+    CHECK(id < 2 && tcmp <= PWM_TMAX);
+    SetLevel(led, g_ledHighOn[led] ? tcmp : PWM_TMAX - tcmp);
+}
+
+void pwm_start(pwm_id_e id)
+{
+}
+
+int pin_mux_claim(pin_mux_owner_e owner, const pin_mux_cfg_t *cfg, unsigned int num, unsigned char pad_mul_sel)
+{
+    CHECK(num == 1 && cfg->func == PIN_MUX_FUNC_KEEP);
+    return cfg->pin == PIN_BUSY ? -1 : 0;
+}
+
+void bls_pm_setAppWakeupLowPower(u32 wakeup_tick, u8 enable)
+{
+    g_wakeTick = wakeup_tick;
+    g_wakeEn = enable;
+}
+
+void bls_pm_registerAppWakeupLowPowerCb(pm_appWakeupLowPower_callback_t cb)
+{
+}
+
+/* sleeps from wakeup to wakeup until end, every wakeup comes late ticks after the one asked for */
+static void RunUntil(u32 end, u32 late)
+{
+    while (g_wakeEn && (s32)(g_wakeTick + late - end) <= 0) {
+        g_hostTick = g_wakeTick + late;
+        blt_soft_timer_process(MAINLOOP_ENTRY);
+    }
+    g_hostTick = end;
+}
+
+static void Reset(void)
+{
+    for (u8 i = 0; i < BLT_LED_MAX_NUM; i++) {
+        blt_led_stop(i);
+    }
+    while (blt_timer.currentNum) {
+        blt_soft_timer_delete_by_index(0);
+    }
+    g_wakeEn = 0;
+    g_edgeNum = 0;
+}
+
+/* the edges of one LED in [from, to] must be the expected levels, each no earlier than planned and at most slack late */
+static void CheckEdges(u8 led, u32 start, const u32 *atMs, const u16 *level, int num, u32 slack)
+{
+    int n = 0;
+
+    for (int i = 0; i < g_edgeNum; i++) {
+        if (g_edge[i].led != led) {
+            continue;
+        }
+        CHECK(n < num);
+        CHECK(g_edge[i].level == level[n]);
+        CHECK((s32)(g_edge[i].tick - (start + MS(atMs[n]))) >= 0);
+        CHECK(g_edge[i].tick - (start + MS(atMs[n])) <= slack);
+        n++;
+    }
+    CHECK(n == num);
+}
+
+static void TestInit(void)
+{
+    CHECK(!blt_led_init(BLT_LED_MAX_NUM, g_ledPin[0], 1, BLT_LED_NO_PWM, 0));
+    CHECK(!blt_led_init(0, PIN_BUSY, 1, BLT_LED_NO_PWM, 0));
+
+    CHECK(blt_led_init(LED_GPIO_HIGH, g_ledPin[LED_GPIO_HIGH], 1, BLT_LED_NO_PWM, 0));
+    CHECK(blt_led_init(LED_GPIO_LOW, g_ledPin[LED_GPIO_LOW], 0, BLT_LED_NO_PWM, 0));
+    CHECK(blt_led_init(LED_PWM_HIGH, g_ledPin[LED_PWM_HIGH], 1, 0, PWM_TMAX));
+    CHECK(blt_led_init(LED_PWM_LOW, g_ledPin[LED_PWM_LOW], 0, 1, PWM_TMAX));
+    for (int i = 0; i < BLT_LED_MAX_NUM; i++) {
+        CHECK(g_level[i] == 0);
+    }
+}
+
+/* three blinks, then the LED stays off and the timer is gone */
+static void TestBlink(void)
+{
+    static const u32 atMs[] = {0, 100, 300, 400, 600, 700};
+    static const u16 level[] = {1, 0, 1, 0, 1, 0};
+    u32 start;
+
+    Reset();
+    g_hostTick = start = MS(1000);
+    CHECK(blt_led_blink(LED_GPIO_LOW, 100, 200, 3, 1));
+    RunUntil(start + MS(899), LATE_NONE);
+    CHECK(blt_led_is_busy(LED_GPIO_LOW));
+    RunUntil(start + MS(2000), LATE_NONE);
+    CHECK(!blt_led_is_busy(LED_GPIO_LOW));
+    CHECK(blt_timer.currentNum == 0);
+    CheckEdges(LED_GPIO_LOW, start, atMs, level, 6, 2 * SYSTEM_TIMER_TICK_1US);
+}
+
+/* late wakeups move the edges but not the timebase, a very late one skips the steps already passed */
+static void TestLateWakeup(void)
+{
+    static const u32 atMs[] = {0, 50, 100, 150, 200, 250, 300, 350, 500, 550};
+    static const u16 level[] = {1, 0, 1, 0, 1, 0, 1, 0, 1, 0};
+    u32 start;
+
+    Reset();
+    g_hostTick = start = MS(5000);
+    CHECK(blt_led_blink(LED_GPIO_HIGH, 50, 50, BLT_LED_REPEAT_FOREVER, 1));
+    RunUntil(start + MS(370), MS(7));
+
+    // asleep from 357 ms to 455 ms: the on step of 400 ms is skipped, the LED stays off until 500 ms
+    g_hostTick = start + MS(455);
+    blt_soft_timer_process(MAINLOOP_ENTRY);
+    CHECK(g_level[LED_GPIO_HIGH] == 0);
+    CHECK(g_wakeEn && g_wakeTick - start <= MS(500) + 2 * SYSTEM_TIMER_TICK_1US);
+    RunUntil(start + MS(570), LATE_NONE);
+
+    CheckEdges(LED_GPIO_HIGH, start, atMs, level, 10, MS(7) + 2 * SYSTEM_TIMER_TICK_1US);
+}
+
+/* a blink and two breathing PWM LEDs of different polarity share the timer, every LED keeps its own timebase */
+static void TestBreathe(void)
+{
+    static const u8 curve[] = {1,   3,   6,   12,  20,  29,  41, 55, 72, 91, 112, 135, 161, 190, 221, 255,
+                               221, 190, 161, 135, 112, 91,  72, 55, 41, 29, 20,  12,  6,   3,   1,   0};
+    static const u32 blinkMs[] = {0, 30, 70, 100};
+    static const u16 blinkLevel[] = {1, 0, 1, 0};
+    u32 atMs[sizeof(curve)];
+    u16 level[sizeof(curve)];
+    int num = 0;
+    u32 start;
+
+    for (u32 i = 0; i < sizeof(curve); i++) {
+        if (i && curve[i] == curve[i - 1]) {
+            continue;
+        }
+        atMs[num] = i * 10;
+        level[num] = (u32)PWM_TMAX * curve[i] / BLT_LED_DUTY_MAX;
+        num++;
+    }
+
+    Reset();
+    g_hostTick = start = MS(9000);
+    CHECK(blt_led_breathe(LED_PWM_HIGH, 320, 1, 1));
+    CHECK(blt_led_breathe(LED_PWM_LOW, 320, 1, 1));
+    g_hostTick = start + MS(5);
+    CHECK(blt_led_blink(LED_GPIO_HIGH, 30, 40, 2, 1));
+    RunUntil(start + MS(1000), LATE_NONE);
+
+    CheckEdges(LED_PWM_HIGH, start, atMs, level, num, 2 * SYSTEM_TIMER_TICK_1US);
+    CheckEdges(LED_PWM_LOW, start, atMs, level, num, 2 * SYSTEM_TIMER_TICK_1US);
+    CheckEdges(LED_GPIO_HIGH, start + MS(5), blinkMs, blinkLevel, 4, 2 * SYSTEM_TIMER_TICK_1US);
+    CHECK(blt_timer.currentNum == 0);
+}
+
+/* only a higher priority replaces a script, a blink that is refused does not touch the one playing */
+static void TestPriority(void)
+{
+    static const u32 atMs[] = {0, 100, 200, 300, 400, 410};
+    static const u16 level[] = {1, 0, 1, 0, 1, 0};
+    u32 start;
+
+    Reset();
+    g_hostTick = start = MS(20000);
+    CHECK(blt_led_blink(LED_GPIO_HIGH, 100, 100, BLT_LED_REPEAT_FOREVER, 2));
+    RunUntil(start + MS(150), LATE_NONE);
+
+    CHECK(!blt_led_blink(LED_GPIO_HIGH, 10, 10, 1, 2));
+    CHECK(!blt_led_blink(LED_GPIO_HIGH, 10, 10, 0, 3));
+    CHECK(!blt_led_blink(LED_GPIO_HIGH, 0, 0, 1, 3));
+    CHECK(!blt_led_blink(BLT_LED_MAX_NUM, 10, 10, 1, 3));
+    CHECK(!blt_led_breathe(LED_GPIO_HIGH, 320, 0, 3));
+    CHECK(blt_led_is_busy(LED_GPIO_HIGH));
+    CHECK(blt_led[LED_GPIO_HIGH].blink_step[0].ms == 100 && blt_led[LED_GPIO_HIGH].blink_step[1].ms == 100);
+    CHECK(blt_led[LED_GPIO_HIGH].pattern.repeat == BLT_LED_REPEAT_FOREVER);
+    RunUntil(start + MS(400), LATE_NONE);
+
+    // replaced at 400 ms: 10 ms on, 20 ms off, done
+    CHECK(blt_led_blink(LED_GPIO_HIGH, 10, 20, 1, 3) && g_level[LED_GPIO_HIGH] == 1);
+    RunUntil(start + MS(1000), LATE_NONE);
+    CHECK(!blt_led_is_busy(LED_GPIO_HIGH));
+    CheckEdges(LED_GPIO_HIGH, start, atMs, level, 6, 2 * SYSTEM_TIMER_TICK_1US);
+
+    // idle again, so any priority plays
+    g_edgeNum = 0;
+    CHECK(blt_led_blink(LED_GPIO_HIGH, 10, 10, 1, 0));
+    RunUntil(start + MS(1100), LATE_NONE);
+    CHECK(g_edgeNum == 2 && !blt_led_is_busy(LED_GPIO_HIGH));
+}
+
+int main(void)
+{
+    TestInit();
+    TestBlink();
+    TestLateWakeup();
+    TestBreathe();
+    TestPriority();
+    printf("blt_led_engine_test: ok\n");
+    return 0;
+}
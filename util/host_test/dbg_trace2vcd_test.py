@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Check util/dbg_trace2vcd.py on a dump written by dbg_trace_test.
+
+usage: dbg_trace2vcd_test.py dump.bin expected.txt out_dir
+"""
+
+import json
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TOOL = os.path.join(HERE, '..', 'dbg_trace2vcd.py')
+sys.path.insert(0, os.path.join(HERE, '..'))
+
+import dbg_trace2vcd  # noqa: E402
+
+TICK_PER_US = 16
+
+
+def check(cond, what):
+    if not cond:
+        sys.exit('dbg_trace2vcd_test: check failed: %s' % what)
+
+
+def read_vcd(path):
+    """Return {time_ns: {chn: level}} of the value changes after $dumpvars."""
+    ids = {}
+    changes = {0: {}}
+    now = 0  # the header ends at #0
+    with open(path) as f:
+        lines = f.read().split('\n')
+    body = lines.index('$end', lines.index('$dumpvars'))
+    for line in lines[:body]:
+        if line.startswith('$var'):
+            fields = line.split()
+            ids[fields[3]] = fields[4]
+    for line in lines[body + 1:]:
+        if not line:
+            continue
+        if line.startswith('#'):
+            t = int(line[1:])
+            check(t > now, 'vcd time goes forward')
+            now = t
+            changes[now] = {}
+        else:
+            changes[now][int(ids[line[1:]][3:])] = int(line[0])
+    return {t: c for t, c in changes.items() if c}
+
+
+def main():
+    dump, expected_path, out_dir = sys.argv[1:4]
+
+    expected = []
+    with open(expected_path) as f:
+        for line in f:
+            tick, chn, level = (int(x) for x in line.split())
+            expected.append((tick, chn, level))
+
+    with open(dump, 'rb') as f:
+        total, records = dbg_trace2vcd.parse_dump(f.read())
+    check(len(records) == len(expected), 'dumped event count')
+    check(total > len(records), 'ring overflow reported in the frame')
+    check(dbg_trace2vcd.levels(dbg_trace2vcd.decode(records)) == expected, 'unwrapped ticks and levels')
+
+    vcd = os.path.join(out_dir, 'dbg_trace.vcd')
+    out = subprocess.run([sys.executable, TOOL, dump, '-o', vcd], stderr=subprocess.PIPE, check=True)
+    check(b'oldest events overwritten' in out.stderr, 'overwritten events warning')
+    last = {}
+    for tick, chn, level in expected:
+        last.setdefault(tick * 1000 // TICK_PER_US, {})[chn] = level
+    check(read_vcd(vcd) == last, 'vcd value changes')
+
+    js = os.path.join(out_dir, 'dbg_trace.json')
+    subprocess.run([sys.executable, TOOL, dump, '-o', js, '--format', 'json', '--name', '3=RF'],
+                   stderr=subprocess.PIPE, check=True)
+    with open(js) as f:
+        trace = json.load(f)['traceEvents']
+    names = {e['tid']: e['args']['name'] for e in trace if e['ph'] == 'M'}
+    check(names[3] == 'RF' and names[0] == 'chn0', 'channel names')
+    state = [0] * 8
+    want = []
+    for tick, chn, level in expected:
+        if level != state[chn]:
+            state[chn] = level
+            want.append((tick / TICK_PER_US, chn, 'B' if level else 'E'))
+    got = [(e['ts'], e['tid'], e['ph']) for e in trace if e['ph'] != 'M']
+    check(got == want, 'json begin/end events')
+
+    print('dbg_trace2vcd_test: ok')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of the blt_dbg_trace recorder (vendor/common/blt_dbg_trace.c and the inline encoder in
+ * blt_dbg_trace.h). Records events whose system tick crosses the 27 bit wrap and overflows the ring, dumps them
+ * through a captured UART, and writes the dump and the expected unwrapped events for dbg_trace2vcd_test.py.
+ *
+ * usage: dbg_trace_test dump.bin expected.txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tl_common.h"
+
+#include "blt_dbg_trace.h"
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define EVENT_NUM   (BLT_DBG_TRACE_BUF_NUM * 3 + 5)
+#define TICK_MASK   ((1u << 27) - 1)
+#define GARBAGE_LEN 7 /* UART noise before the frame */
+
+u32 g_hostTick;
+u32 g_hostMstatus;
+
+static u8 g_uart[GARBAGE_LEN + 12 + 4 * BLT_DBG_TRACE_BUF_NUM];
+static u32 g_uartLen;
+
+typedef struct {
+    u32 tick; /* full system tick */
+    u8 chn;
+    u8 edge;
+} Event;
+
+static Event g_events[EVENT_NUM];
+static u32 g_rand = 7;
+
+void uart_send_byte(uart_num_e uart_num, unsigned char tx_data)
+{
+    CHECK(uart_num == UART1);
+    CHECK(g_uartLen < sizeof(g_uart));
+    g_uart[g_uartLen++] = tx_data;
+}
+
+static u32 Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+static u32 Word(u32 off)
+{
+    return g_uart[off] | (g_uart[off + 1] << 8) | (g_uart[off + 2] << 16) | ((u32)g_uart[off + 3] << 24);
+}
+
+int main(int argc, char **argv)
+{
+    u32 first = EVENT_NUM - BLT_DBG_TRACE_BUF_NUM;
+    u32 level[8] = { 0 };
+    int wrapped = 0;
+    FILE *f;
+
+    CHECK(argc == 3);
+
+    /* gaps up to 1 s, the 27 bit tick wraps in the middle of the events left in the ring */
+    for (u32 i = 0; i < EVENT_NUM; i++) {
+        g_events[i].tick = (i % 50 == 49) ? Rand() % (1000 * SYSTEM_TIMER_TICK_1MS) : 1 + Rand() % 200;
+    }
+    g_hostTick = 1u << 27;
+    for (u32 i = 0; i <= first + BLT_DBG_TRACE_BUF_NUM / 2; i++) {
+        g_hostTick -= g_events[i].tick;
+    }
+
+    for (u32 i = 0; i < EVENT_NUM; i++) {
+        g_hostTick += g_events[i].tick;
+        g_events[i].tick = g_hostTick;
+        g_events[i].chn = (u8)(Rand() % 8);
+        g_events[i].edge = (u8)(Rand() % 3);
+
+        /* interrupts are enabled again only if they were enabled before */
+        g_hostMstatus = (i & 1) ? BIT(3) : 0;
+        if (g_events[i].chn == 3 && g_events[i].edge == DBG_TRACE_EDGE_TOGGLE) {
+            DBG_CHN3_TOGGLE;
+        } else {
+            blt_dbg_trace_event(g_events[i].chn, g_events[i].edge);
+        }
+        CHECK(g_hostMstatus == ((i & 1) ? BIT(3) : 0));
+    }
+    CHECK(blt_dbgTrace.wptr == EVENT_NUM);
+
+    g_uartLen = GARBAGE_LEN;
+    memset(g_uart, 0x44, GARBAGE_LEN);
+    CHECK(blt_dbg_trace_dump(UART1) == BLT_DBG_TRACE_BUF_NUM);
+    CHECK(g_uartLen == GARBAGE_LEN + 12 + 4 * BLT_DBG_TRACE_BUF_NUM);
+    CHECK(Word(GARBAGE_LEN) == BLT_DBG_TRACE_MAGIC);
+    CHECK(Word(GARBAGE_LEN + 4) == EVENT_NUM);
+    CHECK(Word(GARBAGE_LEN + 8) == BLT_DBG_TRACE_BUF_NUM);
+
+    /* the oldest events were overwritten, the dump starts at the first one still in the ring */
+    for (u32 i = 0; i < BLT_DBG_TRACE_BUF_NUM; i++) {
+        const Event *e = &g_events[first + i];
+        u32 w = Word(GARBAGE_LEN + 12 + 4 * i);
+        CHECK(w >> 5 == (e->tick & TICK_MASK));
+        CHECK(((w >> 2) & 7) == e->chn);
+        CHECK((w & 3) == e->edge);
+        wrapped |= (i != 0) && ((e->tick & TICK_MASK) < (g_events[first + i - 1].tick & TICK_MASK));
+    }
+    CHECK(wrapped);
+
+    f = fopen(argv[1], "wb");
+    CHECK(f != NULL);
+    CHECK(fwrite(g_uart, 1, g_uartLen, f) == g_uartLen);
+    fclose(f);
+
+    /* unwrapped tick from the first dumped event, channel, level with every channel starting low */
+    f = fopen(argv[2], "w");
+    CHECK(f != NULL);
+    for (u32 i = first; i < EVENT_NUM; i++) {
+        const Event *e = &g_events[i];
+        level[e->chn] = (e->edge == DBG_TRACE_EDGE_TOGGLE) ? !level[e->chn] : (e->edge == DBG_TRACE_EDGE_HIGH);
+        fprintf(f, "%u %u %u\n", (unsigned)(e->tick - g_events[first].tick), e->chn, (unsigned)level[e->chn]);
+    }
+    fclose(f);
+
+    blt_dbg_trace_reset();
+    CHECK(blt_dbgTrace.wptr == 0);
+
+    printf("dbg_trace_test: ok\n");
+
+    return 0;
+}
@@ -0,0 +1,362 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of drivers/B91/flash.c on a model of the MSPI and the flash (mspi_flash_model.c): page programs
+ * of any alignment against a plain copy, and the bus bytes and interrupts-off time of a page program with and
+ * without preemption of the busy wait. flash_erase_range: the erase units picked for a range, skipping blank units,
+ * the yield between units, and its erase time against one sector at a time. The page cache when other tasks miss
+ * in the same set while a line is being filled. The busy wait past the timeout, and the reset and failure of an
+ * operation which never finishes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <flash.h>
+#include <mspi_flash_model.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define AREA_ADDR 0x40000
+#define AREA_SIZE 0x4000
+
+static uint32_t g_rand = 1;
+static uint8_t g_shadow[AREA_SIZE];
+static uint8_t g_buf[AREA_SIZE + 4];
+
+static uint32_t Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+static void CheckArea(void)
+{
+    CHECK(memcmp(MspiModelMem() + AREA_ADDR, g_shadow, AREA_SIZE) == 0);
+
+    flash_read_page(AREA_ADDR, AREA_SIZE, g_buf);
+    CHECK(memcmp(g_buf, g_shadow, AREA_SIZE) == 0);
+}
+
+/* random lengths from random offsets, from aligned and unaligned buffers */
+static void TestProgram(void)
+{
+    uint32_t off = 0;
+    uint32_t len;
+    uint32_t programs;
+
+    MspiModelReset();
+    memset(g_shadow, 0xFF, sizeof(g_shadow));
+
+    flash_write_page(AREA_ADDR, 0, g_buf);
+    CHECK(MspiModelStatsGet()->commands == 0);
+
+    while (off < AREA_SIZE) {
+        uint8_t *src = g_buf + Rand() % 4;
+        len = 1 + Rand() % 700;
+        len = (len > AREA_SIZE - off) ? AREA_SIZE - off : len;
+        for (uint32_t i = 0; i < len; i++) {
+            src[i] = (uint8_t)Rand();
+        }
+
+        programs = MspiModelStatsGet()->programs;
+        flash_write_page(AREA_ADDR + off, len, src);
+        /* one program command per page touched */
+        CHECK(MspiModelStatsGet()->programs - programs == (off + len - 1) / PAGE_SIZE - off / PAGE_SIZE + 1);
+        CHECK(MspiModelIrqEnabled());
+
+        memcpy(&g_shadow[off], src, len);
+        off += len;
+    }
+    CheckArea();
+}
+
+/* the bus time without the status polls, and the longest interrupts-off time */
+static void ProgramPage(uint32_t addr, uint64_t *busNs, uint64_t *irqOffNs)
+{
+    MspiModelStats *stats = MspiModelStatsGet();
+    uint32_t bytes;
+    uint32_t pollBytes;
+
+    for (int i = 0; i < PAGE_SIZE; i++) {
+        g_buf[i] = (uint8_t)Rand();
+    }
+    bytes = stats->bytes;
+    pollBytes = stats->pollBytes;
+    stats->irqOffMaxNs = 0;
+    flash_write_page(addr, PAGE_SIZE, g_buf);
+    *busNs = (uint64_t)(stats->bytes - bytes - (stats->pollBytes - pollBytes)) * MSPI_MODEL_BYTE_NS;
+    *irqOffNs = stats->irqOffMaxNs;
+    CHECK(memcmp(MspiModelMem() + addr, g_buf, PAGE_SIZE) == 0);
+}
+
+/*
+ * The data phase is one bus byte per data byte either way, the MSPI has no FIFO. The interrupts-off time drops
+ * to the command phase when preemption is configured. The host cannot time the CPU side of the byte loop.
+ */
+static void Benchmark(void)
+{
+    uint64_t busNs;
+    uint64_t offNs;
+    uint64_t offPreemptNs;
+
+    MspiModelReset();
+    ProgramPage(AREA_ADDR, &busNs, &offNs);
+
+    g_plic_preempt_en = 1;
+    flash_plic_preempt_config(1, 1);
+    ProgramPage(AREA_ADDR + PAGE_SIZE, &busNs, &offPreemptNs);
+    flash_plic_preempt_config(0, 1);
+    g_plic_preempt_en = 0;
+
+    printf("flash_driver_test: page program %u bus bytes in %u us, interrupts off %u us, %u us with preemption\n",
+           (unsigned)(busNs / MSPI_MODEL_BYTE_NS), (unsigned)(busNs / 1000), (unsigned)(offNs / 1000),
+           (unsigned)(offPreemptNs / 1000));
+
+    /* write enable, opcode, address, data and the status read opcode */
+    CHECK(busNs / MSPI_MODEL_BYTE_NS == 1 + 1 + 3 + PAGE_SIZE + 1);
+    CHECK(offNs >= (uint64_t)MSPI_MODEL_PROGRAM_US * 1000);
+    CHECK(offPreemptNs <= busNs);
+}
+
+static uint32_t g_yields;
+
+static void Yield(void)
+{
+    CHECK(MspiModelIrqEnabled());
+    g_yields++;
+}
+
+/* erase a range of a programmed flash, expect these sector, 32K and 64K erases */
+static void EraseRange(uint32_t addr, uint32_t len, uint32_t sectors, uint32_t blocks32k, uint32_t blocks64k)
+{
+    MspiModelStats *stats = MspiModelStatsGet();
+    uint8_t *mem = MspiModelMem();
+
+    memset(mem, 0, MSPI_MODEL_FLASH_SIZE);
+    memset(stats->erases, 0, sizeof(stats->erases));
+    g_yields = 0;
+
+    CHECK(flash_erase_range(addr, len) == 0);
+    CHECK(stats->erases[0] == sectors);
+    CHECK(stats->erases[1] == blocks32k);
+    CHECK(stats->erases[2] == blocks64k);
+    CHECK(g_yields == sectors + blocks32k + blocks64k - 1);
+
+    for (uint32_t i = 0; i < MSPI_MODEL_FLASH_SIZE; i++) {
+        CHECK(mem[i] == (((i >= addr) && (i < addr + len)) ? 0xFF : 0));
+    }
+}
+
+static void TestEraseRange(void)
+{
+    MspiModelStats *stats = MspiModelStatsGet();
+    uint8_t *mem = MspiModelMem();
+
+    MspiModelReset();
+    flash_set_erase_yield_cb(Yield);
+
+    CHECK(flash_erase_range(0x1800, 0x1000) == -1);
+    CHECK(flash_erase_range(0x1000, 0x800) == -1);
+
+    EraseRange(0x9000, 0x1000, 1, 0, 0);
+    EraseRange(0x1000, 0x1F000, 7, 1, 1);
+    EraseRange(0x30000, 0x28000, 0, 1, 2);
+    EraseRange(0x78000, 0x10000, 0, 2, 0);
+    EraseRange(0x2000, 0x1D000, 13, 2, 0);
+
+    /* blank units are not erased again, one programmed byte takes its whole unit */
+    memset(stats->erases, 0, sizeof(stats->erases));
+    CHECK(flash_erase_range(0x2000, 0x1D000) == 0);
+    CHECK(stats->erases[0] + stats->erases[1] + stats->erases[2] == 0);
+    mem[0x13456] = 0x7F;
+    CHECK(flash_erase_range(0x2000, 0x1D000) == 0);
+    CHECK(stats->erases[1] == 1);
+    CHECK(stats->erases[0] + stats->erases[2] == 0);
+    CHECK(mem[0x13456] == 0xFF);
+
+    flash_set_erase_yield_cb(0);
+}
+
+/* the erase time of 508K of programmed flash, blank checks included, against one sector at a time */
+static void EraseBenchmark(void)
+{
+    uint64_t start;
+    uint64_t rangeUs;
+    uint64_t sectorUs;
+
+    MspiModelReset();
+    memset(MspiModelMem(), 0, MSPI_MODEL_FLASH_SIZE);
+    start = MspiModelTimeNs();
+    CHECK(flash_erase_range(0x1000, 0x7F000) == 0);
+    rangeUs = (MspiModelTimeNs() - start) / 1000;
+
+    memset(MspiModelMem(), 0, MSPI_MODEL_FLASH_SIZE);
+    start = MspiModelTimeNs();
+    for (uint32_t addr = 0x1000; addr < 0x80000; addr += FLASH_SECTOR_SIZE) {
+        flash_erase_sector(addr);
+    }
+    sectorUs = (MspiModelTimeNs() - start) / 1000;
+
+    printf("flash_driver_test: erase 508K %u ms by range, %u ms by sector\n", (unsigned)(rangeUs / 1000),
+           (unsigned)(sectorUs / 1000));
+    /* 7 sectors, a 32K and 7 64K blocks against 127 sectors */
+    CHECK(rangeUs * 2 < sectorUs);
+}
+
+#define CACHE_PAGE 0x50000 /* pages CACHE_PAGE + n * 4 * PAGE_SIZE share a set */
+
+static int g_fillHookArmed;
+
+static void CheckCached(uint32_t page, uint32_t off)
+{
+    uint8_t buf[8];
+
+    flash_read_page(page + off, sizeof(buf), buf);
+    CHECK(memcmp(buf, MspiModelMem() + page + off, sizeof(buf)) == 0);
+}
+
+/* a task switch while the line is filled, the other task misses twice in the same set */
+static void FillHook(void)
+{
+    if (g_fillHookArmed) {
+        g_fillHookArmed = 0;
+        CheckCached(CACHE_PAGE + 4 * PAGE_SIZE, 8);
+        CheckCached(CACHE_PAGE + 8 * PAGE_SIZE, 16);
+    }
+}
+
+static void TestCacheFill(void)
+{
+    unsigned int hit;
+    unsigned int miss;
+    unsigned int hitBefore;
+
+    MspiModelReset();
+    flash_erase_sector(CACHE_PAGE);
+    for (int i = 0; i < 3 * 4 * PAGE_SIZE; i++) {
+        g_buf[i] = (uint8_t)Rand();
+    }
+    flash_write_page(CACHE_PAGE, 3 * 4 * PAGE_SIZE, g_buf);
+
+    MspiModelIrqHookSet(FillHook);
+    g_fillHookArmed = 1;
+    CheckCached(CACHE_PAGE, 0);
+    CHECK(!g_fillHookArmed);
+    MspiModelIrqHookSet(NULL);
+
+    /* the other task could only use the line it filled first, its last page is a hit and must match the flash */
+    flash_cache_get_stats(&hitBefore, &miss);
+    CheckCached(CACHE_PAGE + 8 * PAGE_SIZE, 24);
+    flash_cache_get_stats(&hit, &miss);
+    CHECK(hit == hitBefore + 1);
+    for (uint32_t n = 0; n < 3; n++) {
+        CheckCached(CACHE_PAGE + n * 4 * PAGE_SIZE, 0);
+    }
+}
+
+/* the hard limit is FLASH_TIMEOUT_HARD_FACTOR times the timeout, then the reset and its recovery time */
+static void CheckFails(int ret, int expect, uint64_t startNs, uint32_t timeoutUs)
+{
+    uint64_t us = (MspiModelTimeNs() - startNs) / 1000;
+
+    CHECK(ret == expect);
+    CHECK(us >= (uint64_t)timeoutUs * FLASH_TIMEOUT_HARD_FACTOR + FLASH_RESET_US);
+    CHECK(us < (uint64_t)timeoutUs * FLASH_TIMEOUT_HARD_FACTOR + FLASH_RESET_US + 100);
+    CHECK(MspiModelIrqEnabled());
+}
+
+static void TestTimeout(void)
+{
+    flash_timeout_t timeout = { 0 };
+    flash_timeout_t defaults = {
+        FLASH_TIMEOUT_PAGE_PROGRAM_US, FLASH_TIMEOUT_SECTOR_ERASE_US, FLASH_TIMEOUT_32KBLK_ERASE_US,
+        FLASH_TIMEOUT_64KBLK_ERASE_US, FLASH_TIMEOUT_CHIP_ERASE_US,   FLASH_TIMEOUT_STATUS_WRITE_US,
+    };
+    MspiModelStats *stats = MspiModelStatsGet();
+    unsigned int overruns = flash_get_timeout_count();
+    uint64_t start;
+
+    MspiModelReset();
+    timeout.page_program = 1000;
+    timeout.sector_erase = 30000;
+    flash_set_timeout(&timeout);
+
+    /* late but within the hard limit, counted and done */
+    memset(MspiModelMem() + AREA_ADDR, 0, FLASH_SECTOR_SIZE);
+    CHECK(flash_erase_sector(AREA_ADDR) == 0);
+    CHECK(flash_get_timeout_count() == overruns + 1);
+    CHECK(MspiModelMem()[AREA_ADDR] == 0xFF);
+    CHECK(stats->resets == 0);
+
+    /* never done: reset, and the next operation works */
+    MspiModelStuckSet(1);
+    start = MspiModelTimeNs();
+    CheckFails(flash_erase_sector(AREA_ADDR), -1, start, timeout.sector_erase);
+    CHECK(stats->resets == 1);
+    CHECK(flash_get_timeout_count() == overruns + 2);
+    g_buf[0] = 0x5A;
+    CHECK(flash_write_page(AREA_ADDR, 1, g_buf) == 0);
+    CHECK(MspiModelMem()[AREA_ADDR] == 0x5A);
+
+    /* a program across pages stops at the failed page */
+    MspiModelStuckSet(1);
+    memset(g_buf, 0, 2 * PAGE_SIZE);
+    stats->programs = 0;
+    start = MspiModelTimeNs();
+    CheckFails(flash_write_page(AREA_ADDR + PAGE_SIZE, 2 * PAGE_SIZE, g_buf), -1, start, timeout.page_program);
+    CHECK(stats->programs == 1);
+
+    /* the same with the wait open to preemption */
+    g_plic_preempt_en = 1;
+    flash_plic_preempt_config(1, 1);
+    MspiModelStuckSet(1);
+    start = MspiModelTimeNs();
+    CheckFails(flash_write_page(AREA_ADDR + 3 * PAGE_SIZE, 1, g_buf), -1, start, timeout.page_program);
+    flash_plic_preempt_config(0, 1);
+    g_plic_preempt_en = 0;
+
+    memset(MspiModelMem() + AREA_ADDR, 0, FLASH_SECTOR_SIZE);
+    MspiModelStuckSet(1);
+    start = MspiModelTimeNs();
+    CheckFails(flash_erase_range(AREA_ADDR, FLASH_SECTOR_SIZE), -2, start, timeout.sector_erase);
+    CHECK(stats->resets == 4);
+
+    flash_set_timeout(&defaults);
+}
+
+int main(void)
+{
+    TestProgram();
+    Benchmark();
+    TestEraseRange();
+    EraseBenchmark();
+    TestCacheFill();
+    TestTimeout();
+    printf("flash_driver_test: ok\n");
+
+    return 0;
+}
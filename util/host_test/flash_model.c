@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <B91/flash.h>
+
+#define FLASH_MODEL_NO_CUT 0xFFFFFFFF
+
+static uint8_t g_flash[FLASH_MODEL_SIZE];
+static uint32_t g_flashBudget = FLASH_MODEL_NO_CUT;
+static int g_flashOff;
+static uint32_t g_flashReadBytes;
+
+static void FlashModelCheck(unsigned long addr, unsigned long len)
+{
+    if ((addr > FLASH_MODEL_SIZE) || (len > FLASH_MODEL_SIZE - addr)) {
+        fprintf(stderr, "flash model: access 0x%lx+%lu out of range\n", addr, len);
+        abort();
+    }
+}
+
+void flash_erase_sector(unsigned long addr)
+{
+    addr &= ~(unsigned long)(FLASH_MODEL_SECTOR_SIZE - 1);
+    FlashModelCheck(addr, FLASH_MODEL_SECTOR_SIZE);
+    if (g_flashOff) {
+        return;
+    }
+    memset(&g_flash[addr], 0xFF, FLASH_MODEL_SECTOR_SIZE);
+}
+
+void flash_write_page(unsigned long addr, unsigned long len, unsigned char *buf)
+{
+    FlashModelCheck(addr, len);
+    /* a page program wraps inside its 256 byte page */
+    if ((addr & 0xFF) + len > 0x100) {
+        fprintf(stderr, "flash model: program 0x%lx+%lu crosses a page\n", addr, len);
+        abort();
+    }
+
+    for (unsigned long i = 0; (i < len) && !g_flashOff; i++) {
+        if (g_flashBudget == 0) {
+            g_flashOff = 1;
+            break;
+        }
+        if (g_flashBudget != FLASH_MODEL_NO_CUT) {
+            g_flashBudget--;
+        }
+        g_flash[addr + i] &= buf[i];
+    }
+}
+
+void flash_read_page(unsigned long addr, unsigned long len, unsigned char *buf)
+{
+    FlashModelCheck(addr, len);
+    memcpy(buf, &g_flash[addr], len);
+    g_flashReadBytes += len;
+}
+
+void flash_model_reset(void)
+{
+    memset(g_flash, 0xFF, sizeof(g_flash));
+    g_flashBudget = FLASH_MODEL_NO_CUT;
+    g_flashOff = 0;
+}
+
+void flash_model_power_cut(uint32_t bytes)
+{
+    g_flashBudget = bytes;
+    g_flashOff = 0;
+}
+
+int flash_model_power_on(void)
+{
+    int off = g_flashOff;
+
+    g_flashBudget = FLASH_MODEL_NO_CUT;
+    g_flashOff = 0;
+
+    return off;
+}
+
+uint32_t flash_model_read_bytes(void)
+{
+    return g_flashReadBytes;
+}
@@ -0,0 +1,250 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of liteos_m/src/fpu_stats.c on a model of the scheduler: each task runs a slice with or without FP
+ * writes, which make mstatus.FS dirty, then is switched out with the hook. A switch from a task runs the hook before
+ * the context is saved, a switch from an interrupt saves mstatus at the trap entry first, so the clear of the hook
+ * is lost. The counts are compared with the FP writes done.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <los_hook.h>
+#include <los_task.h>
+
+#include <fpu_stats.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define MSTATUS_FS       0x6000
+#define MSTATUS_FS_INIT  0x2000
+#define MSTATUS_FS_CLEAN 0x4000
+#define MSTATUS_FS_DIRTY 0x6000
+#define MSTATUS_OTHER    0x1888 /* MPP, MPIE, MIE: must not be touched */
+
+#define TASK_NUM 4
+
+int g_losIntLocked;
+unsigned long g_mstatus;
+LosTask g_losTask;
+
+static VOID (*g_hook)(VOID);
+static UINT32 g_hookRet;
+static LosTaskCB g_tasks[TASK_NUM];
+static unsigned long g_ctxMstatus[TASK_NUM]; /* mstatus in the saved task contexts */
+static uint32_t g_slices[TASK_NUM];
+static uint32_t g_fpSlices[TASK_NUM];
+static int g_run;
+static uint32_t g_rand = 1;
+
+UINT32 LOS_HookReg(LosHookType type, VOID (*hook)(VOID))
+{
+    CHECK(type == LOS_HOOK_TYPE_TASK_SWITCHEDIN);
+    if (g_hookRet == LOS_OK) {
+        g_hook = hook;
+    }
+    return g_hookRet;
+}
+
+static uint32_t Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+static void Start(void)
+{
+    for (int i = 0; i < TASK_NUM; i++) {
+        g_tasks[i].taskID = (UINT32)i;
+        g_ctxMstatus[i] = MSTATUS_OTHER | MSTATUS_FS_INIT;
+        g_slices[i] = 0;
+        g_fpSlices[i] = 0;
+        CHECK(FpuStatsReset((uint32_t)i) == 0);
+    }
+    g_run = 0;
+    g_mstatus = g_ctxMstatus[0];
+}
+
+/* the running task writes an FP register or not */
+static void Slice(int fp)
+{
+    if (fp) {
+        g_mstatus |= MSTATUS_FS_DIRTY;
+    }
+    g_fpSlices[g_run] += (uint32_t)(fp != 0);
+}
+
+static void Switch(int next, int fromIrq)
+{
+    g_slices[g_run]++;
+    g_losTask.runTask = &g_tasks[g_run];
+    g_losTask.newTask = &g_tasks[next];
+    if (fromIrq) {
+        g_ctxMstatus[g_run] = g_mstatus;
+        g_hook();
+    } else {
+        g_hook();
+        g_ctxMstatus[g_run] = g_mstatus;
+    }
+    CHECK((g_mstatus & ~(unsigned long)MSTATUS_FS) == MSTATUS_OTHER);
+    g_run = next;
+    g_mstatus = g_ctxMstatus[next];
+}
+
+static void Get(int taskId, FpuStats *stats)
+{
+    CHECK(FpuStatsGet((uint32_t)taskId, stats) == 0);
+    CHECK(g_losIntLocked == 0);
+}
+
+/* task 0 never uses the FPU, task 1 sometimes, task 2 always, task 3 once */
+static int UsesFp(int task, int n)
+{
+    switch (task) {
+        case 1:
+            return (Rand() % 3) == 0;
+        case 2:
+            return 1;
+        case 3:
+            return n == 5;
+        default:
+            return 0;
+    }
+}
+
+/* switches from tasks only: the counts are exact, FS of a switched out task is clean, never off */
+static void CheckTaskSwitches(void)
+{
+    FpuStats stats;
+
+    Start();
+    for (int n = 0; n < 2000; n++) {
+        Slice(UsesFp(g_run, n));
+        Switch((int)(Rand() % TASK_NUM), 0);
+    }
+    for (int i = 0; i < TASK_NUM; i++) {
+        Get(i, &stats);
+        CHECK(stats.slices == g_slices[i]);
+        CHECK(stats.fpuSlices == g_fpSlices[i]);
+        CHECK(stats.slices > 100);
+    }
+    Get(0, &stats);
+    CHECK(stats.fpuSlices == 0);
+    Get(3, &stats);
+    CHECK(stats.fpuSlices <= 1);
+    for (int i = 1; i < 3; i++) {
+        CHECK((g_ctxMstatus[i] & MSTATUS_FS) == MSTATUS_FS_CLEAN || i == g_run);
+    }
+    CHECK((g_ctxMstatus[0] & MSTATUS_FS) == MSTATUS_FS_INIT || g_run == 0);
+}
+
+/* switches from interrupts keep FS dirty: upper bounds, a task without FP writes stays at 0 */
+static void CheckIrqSwitches(void)
+{
+    FpuStats stats;
+
+    Start();
+    for (int n = 0; n < 2000; n++) {
+        Slice(UsesFp(g_run, n));
+        Switch((int)(Rand() % TASK_NUM), (int)(Rand() & 1));
+    }
+    for (int i = 0; i < TASK_NUM; i++) {
+        Get(i, &stats);
+        CHECK(stats.slices == g_slices[i]);
+        CHECK(stats.fpuSlices >= g_fpSlices[i]);
+        CHECK(stats.fpuSlices <= stats.slices);
+    }
+    Get(0, &stats);
+    CHECK(stats.fpuSlices == 0);
+
+    /* one FP write, then preempted 5 times: counted each time, until a switch from the task clears FS */
+    Start();
+    g_run = 1;
+    g_mstatus = g_ctxMstatus[1];
+    Slice(1);
+    for (int n = 0; n < 5; n++) {
+        Switch(0, 1);
+        Slice(0);
+        Switch(1, 0);
+        Slice(0);
+    }
+    Get(1, &stats);
+    CHECK(stats.slices == 5);
+    CHECK(stats.fpuSlices == 5);
+    Switch(0, 0);
+    Slice(0);
+    Switch(1, 0);
+    Slice(0);
+    Switch(0, 1);
+    Get(1, &stats);
+    CHECK(stats.slices == 7);
+    CHECK(stats.fpuSlices == 6);
+}
+
+static void CheckApi(void)
+{
+    FpuStats stats;
+
+    CHECK(FpuStatsGet(LOSCFG_BASE_CORE_TSK_LIMIT + 1, &stats) != 0);
+    CHECK(FpuStatsReset(LOSCFG_BASE_CORE_TSK_LIMIT + 1) != 0);
+
+    /* the last task id of the table */
+    g_tasks[0].taskID = LOSCFG_BASE_CORE_TSK_LIMIT;
+    g_losTask.runTask = &g_tasks[0];
+    g_mstatus = MSTATUS_FS_DIRTY;
+    CHECK(FpuStatsReset(LOSCFG_BASE_CORE_TSK_LIMIT) == 0);
+    g_hook();
+    Get(LOSCFG_BASE_CORE_TSK_LIMIT, &stats);
+    CHECK(stats.slices == 1 && stats.fpuSlices == 1);
+    CHECK(FpuStatsReset(LOSCFG_BASE_CORE_TSK_LIMIT) == 0);
+    Get(LOSCFG_BASE_CORE_TSK_LIMIT, &stats);
+    CHECK(stats.slices == 0 && stats.fpuSlices == 0);
+
+    /* a task id out of the table is not counted */
+    g_tasks[0].taskID = LOSCFG_BASE_CORE_TSK_LIMIT + 1;
+    g_mstatus = MSTATUS_FS_DIRTY;
+    g_hook();
+    CHECK(g_mstatus == MSTATUS_FS_DIRTY);
+    CHECK(g_losIntLocked == 0);
+}
+
+int main(void)
+{
+    g_hookRet = 1;
+    CHECK(FpuStatsInit() != 0);
+    CHECK(g_hook == NULL);
+    g_hookRet = LOS_OK;
+    CHECK(FpuStatsInit() == 0);
+    CHECK(g_hook != NULL);
+
+    CheckTaskSwitches();
+    CheckIrqSwitches();
+    CheckApi();
+
+    printf("fpu_stats_test: ok\n");
+    return 0;
+}
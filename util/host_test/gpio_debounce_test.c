@@ -0,0 +1,464 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of the debounce in hdf/gpio_telink.c. Bouncy button traces go through a GPIO model with per pin
+ * irq masks and edge detection, the OS timer fires on 1 ms ticks. With debounce every press is delivered once
+ * and glitches are suppressed, without it every bounce runs the HDF callback. The irq entries, callbacks and
+ * an estimate of the CPU time in the irq are compared.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "device_resource_if.h"
+#include "gpio/gpio_core.h"
+#include "osal.h"
+
+#include <B91/gpio.h>
+#include <B91/stimer.h>
+#include <B91/ext_driver/pin_mux.h>
+
+#include <b91_irq.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define PIN_INDEX    1 /* pinMap: GPIO_PA1 */
+#define PIN          GPIO_PA1
+#define DEBOUNCE_US  5000
+#define TICK_US      1000
+#define PRESSES      200
+#define GLITCHES     200
+#define TRACE_MAX    ((PRESSES + GLITCHES) * 64)
+#define TIMER_MAX    4
+
+/* CPU time assumptions for the estimate: the irq entry with the pin loop, and the HDF callback path */
+#define IRQ_NS      2000
+#define CALLBACK_NS 15000
+#define TIMEOUT_NS  3000
+
+extern struct HdfDriverEntry *g_hostTestEntry;
+extern struct GpioMethod g_GpioCntlrMethod;
+
+typedef struct {
+    uint64_t us;
+    unsigned char level;
+} Edge;
+
+typedef struct {
+    uint32_t ms;
+    OsalTimerFunc func;
+    uintptr_t arg;
+    uint64_t expireUs; /* 0: not running */
+} Timer;
+
+static Edge g_trace[TRACE_MAX];
+static int g_traceNum;
+static uint64_t g_us;
+static unsigned char g_level[0x600];
+static unsigned char g_irqMask[0x600];
+static HWI_PROC_FUNC g_irq;
+static Timer g_timer[TIMER_MAX];
+static int g_timerNum;
+static int g_timerFail;
+static struct GpioCntlr *g_cntlr;
+static uint32_t g_debounceUs;
+static uint32_t g_rand = 1;
+
+static uint32_t g_irqNum;
+static uint32_t g_callbackNum;
+static uint32_t g_timeoutNum;
+
+static uint32_t Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+/* GPIO model */
+_Bool gpio_get_level(gpio_pin_e pin)
+{
+    return g_level[pin];
+}
+
+void gpio_set_level(gpio_pin_e pin, unsigned char value)
+{
+    g_level[pin] = value;
+}
+
+void gpio_function_en(gpio_pin_e pin) {}
+void gpio_input_en(gpio_pin_e pin) {}
+void gpio_input_dis(gpio_pin_e pin) {}
+void gpio_output_en(gpio_pin_e pin) {}
+void gpio_output_dis(gpio_pin_e pin) {}
+
+_Bool gpio_is_input_en(gpio_pin_e pin)
+{
+    return 1;
+}
+
+_Bool gpio_is_output_en(gpio_pin_e pin)
+{
+    return 0;
+}
+
+void gpio_set_irq(gpio_pin_e pin, gpio_irq_trigger_type_e trigger_type)
+{
+    CHECK(trigger_type == INTR_FALLING_EDGE);
+    g_irqMask[pin] = 1;
+}
+
+void gpio_irq_en(gpio_pin_e pin)
+{
+    g_irqMask[pin] = 1;
+}
+
+void gpio_irq_dis(gpio_pin_e pin)
+{
+    g_irqMask[pin] = 0;
+}
+
+void gpio_clr_irq_status(unsigned int status)
+{
+    CHECK(status == FLD_GPIO_IRQ_CLR);
+}
+
+int pin_mux_claim(pin_mux_owner_e owner, const pin_mux_cfg_t *cfg, unsigned int num, unsigned char pad_mul_sel)
+{
+    return 0;
+}
+
+/* a falling edge of an unmasked pin enters the irq */
+static void SetLevel(gpio_pin_e pin, unsigned char level)
+{
+    unsigned char old = g_level[pin];
+
+    g_level[pin] = level;
+    if (old && !level && g_irqMask[pin]) {
+        g_irqNum++;
+        g_irq();
+    }
+}
+
+void B91IrqRegister(unsigned int irq, HWI_PROC_FUNC handler, unsigned int arg)
+{
+    CHECK(irq == IRQ25_GPIO);
+    g_irq = handler;
+}
+
+void plic_interrupt_enable(unsigned int irq) {}
+
+/* system timer and OS timers */
+unsigned int stimer_get_tick(void)
+{
+    return (unsigned int)(g_us * 16);
+}
+
+_Bool clock_time_exceed(unsigned int ref, unsigned int us)
+{
+    return (unsigned int)(stimer_get_tick() - ref) > us * 16;
+}
+
+void *OsalMemAlloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *OsalMemCalloc(size_t size)
+{
+    return calloc(1, size);
+}
+
+void OsalMemFree(void *mem)
+{
+    free(mem);
+}
+
+int32_t OsalTimerCreate(OsalTimer *timer, uint32_t interval, OsalTimerFunc func, uintptr_t arg)
+{
+    CHECK(g_timerNum < TIMER_MAX);
+    g_timer[g_timerNum] = (Timer){interval, func, arg, 0};
+    timer->realTimer = &g_timer[g_timerNum++];
+    return HDF_SUCCESS;
+}
+
+/* the timer fires on a tick, up to one tick earlier than the interval */
+int32_t OsalTimerStartOnce(OsalTimer *timer)
+{
+    Timer *t = timer->realTimer;
+
+    if (g_timerFail) {
+        g_timerFail--;
+        return HDF_FAILURE;
+    }
+    CHECK(!t->expireUs);
+    t->expireUs = (g_us / TICK_US + t->ms) * TICK_US;
+    return HDF_SUCCESS;
+}
+
+int32_t OsalTimerDelete(OsalTimer *timer)
+{
+    ((Timer *)timer->realTimer)->expireUs = 0;
+    return HDF_SUCCESS;
+}
+
+/* HDF */
+static int32_t GetUint8(const struct DeviceResourceNode *node, const char *attrName, uint8_t *value, uint8_t def)
+{
+    CHECK(!strcmp(attrName, "pinNum"));
+    *value = 2;
+    return HDF_SUCCESS;
+}
+
+static int32_t GetUint32ArrayElem(const struct DeviceResourceNode *node, const char *attrName, uint32_t index,
+                                  uint32_t *value, uint32_t def)
+{
+    if (!strcmp(attrName, "pinMap")) {
+        *value = index ? PIN_INDEX + 1 : PIN_INDEX;
+    } else {
+        CHECK(!strcmp(attrName, "debounceUs"));
+        *value = index ? 0 : g_debounceUs;
+    }
+    return HDF_SUCCESS;
+}
+
+static struct DeviceResourceIface g_dri = {GetUint8, GetUint32ArrayElem};
+
+struct DeviceResourceIface *DeviceResourceGetIfaceInstance(int type)
+{
+    return &g_dri;
+}
+
+const char *HdfDeviceGetServiceName(const struct HdfDeviceObject *deviceObject)
+{
+    return "gpio";
+}
+
+int32_t PlatformDeviceBind(struct PlatformDevice *device, struct HdfDeviceObject *hdfDevice)
+{
+    device->hdfDev = hdfDevice;
+    return HDF_SUCCESS;
+}
+
+int32_t GpioCntlrAdd(struct GpioCntlr *cntlr)
+{
+    g_cntlr = cntlr;
+    return HDF_SUCCESS;
+}
+
+void GpioCntlrRemove(struct GpioCntlr *cntlr)
+{
+    g_cntlr = NULL;
+}
+
+struct GpioCntlr *GpioCntlrFromHdfDev(const struct HdfDeviceObject *device)
+{
+    return g_cntlr;
+}
+
+void GpioCntlrIrqCallback(struct GpioCntlr *cntlr, uint16_t local)
+{
+    CHECK(cntlr == g_cntlr && local == 0);
+    g_callbackNum++;
+}
+
+/* bounces: the level toggles every 20 ~ 300 us for up to 2 ms, then settles */
+static void AddBounce(uint64_t *us, unsigned char level)
+{
+    int toggles = 2 * (int)(Rand() % 8);
+    unsigned char l = level;
+
+    for (int i = 0; i < toggles; i++) {
+        g_trace[g_traceNum++] = (Edge){*us, l};
+        *us += 20 + Rand() % 280;
+        l = !l;
+    }
+    g_trace[g_traceNum++] = (Edge){*us, level};
+}
+
+/* presses held 30 ~ 300 ms and glitches of 50 us ~ 2 ms, the line idles high */
+static int MakeTrace(void)
+{
+    uint64_t us = 10000;
+    int presses = 0;
+
+    g_traceNum = 0;
+    g_rand = 1;
+    for (int i = 0; i < PRESSES + GLITCHES; i++) {
+        if ((Rand() & 1) ? presses < PRESSES : i - presses >= GLITCHES) {
+            AddBounce(&us, 0);
+            us += 30000 + Rand() % 270000;
+            AddBounce(&us, 1);
+            presses++;
+        } else {
+            g_trace[g_traceNum++] = (Edge){us, 0};
+            us += 50 + Rand() % 1950;
+            g_trace[g_traceNum++] = (Edge){us, 1};
+        }
+        us += 20000 + Rand() % 200000;
+    }
+    CHECK(g_traceNum <= TRACE_MAX);
+
+    return presses;
+}
+
+/* replay the trace, running the timers in between, up to untilUs */
+static void Run(uint64_t untilUs)
+{
+    int e = 0;
+
+    for (;;) {
+        Timer *next = NULL;
+        for (int i = 0; i < g_timerNum; i++) {
+            if (g_timer[i].expireUs && (!next || g_timer[i].expireUs < next->expireUs)) {
+                next = &g_timer[i];
+            }
+        }
+
+        if (next && next->expireUs <= untilUs && (e == g_traceNum || next->expireUs <= g_trace[e].us)) {
+            g_us = next->expireUs;
+            next->expireUs = 0;
+            g_timeoutNum++;
+            next->func(next->arg);
+        } else if (e < g_traceNum && g_trace[e].us <= untilUs) {
+            g_us = g_trace[e].us;
+            SetLevel(PIN, g_trace[e].level);
+            e++;
+        } else {
+            break;
+        }
+    }
+}
+
+static void Start(uint32_t debounceUs)
+{
+    static struct HdfDeviceObject device = {(const struct DeviceResourceNode *)1};
+
+    g_debounceUs = debounceUs;
+    g_timerNum = 0;
+    g_us = 0;
+    g_level[PIN] = 1;
+    g_level[GPIO_PA2] = 1;
+    CHECK(g_hostTestEntry->Init(&device) == HDF_SUCCESS);
+    CHECK(g_cntlr->ops->setDir(g_cntlr, 0, GPIO_DIR_IN) == HDF_SUCCESS);
+    CHECK(g_cntlr->ops->setIrq(g_cntlr, 0, GPIO_IRQ_TRIGGER_FALLING) == HDF_SUCCESS);
+    CHECK(g_cntlr->ops->enableIrq(g_cntlr, 0) == HDF_SUCCESS);
+    g_irqNum = 0;
+    g_callbackNum = 0;
+    g_timeoutNum = 0;
+}
+
+static void Stop(void)
+{
+    static struct HdfDeviceObject device;
+
+    CHECK(g_cntlr->ops->disableIrq(g_cntlr, 0) == HDF_SUCCESS);
+    g_hostTestEntry->Release(&device);
+}
+
+static double CpuUs(void)
+{
+    return (g_irqNum * (double)IRQ_NS + g_callbackNum * (double)CALLBACK_NS + g_timeoutNum * (double)TIMEOUT_NS) /
+           1000;
+}
+
+static void TestTrace(void)
+{
+    int presses = MakeTrace();
+    uint32_t irqRaw;
+    uint32_t callbackRaw;
+    double cpuRaw;
+
+    Start(0);
+    Run(UINT64_MAX);
+    irqRaw = g_irqNum;
+    callbackRaw = g_callbackNum;
+    cpuRaw = CpuUs();
+    CHECK(callbackRaw == irqRaw);
+    CHECK(callbackRaw > (uint32_t)(presses + GLITCHES));
+    Stop();
+
+    Start(DEBOUNCE_US);
+    Run(UINT64_MAX);
+    printf("gpio_debounce_test: %d presses %d glitches, no debounce %u irqs %u callbacks %.0f us\n", presses,
+           GLITCHES, irqRaw, callbackRaw, cpuRaw);
+    printf("gpio_debounce_test: debounce %d us %u irqs %u callbacks %u timeouts %.0f us\n", DEBOUNCE_US, g_irqNum,
+           g_callbackNum, g_timeoutNum, CpuUs());
+    CHECK(g_callbackNum == (uint32_t)presses);
+    CHECK(g_irqNum < irqRaw / 2);
+    CHECK(!g_timer[0].expireUs);
+    CHECK(g_irqMask[PIN]);
+    Stop();
+}
+
+/* a press seen while the timer cannot start leaves the pin unmasked, the next press is delivered */
+static void TestTimerFail(void)
+{
+    Start(DEBOUNCE_US);
+    g_timerFail = 1;
+    g_us = 1000;
+    SetLevel(PIN, 0);
+    CHECK(g_irqMask[PIN] && g_callbackNum == 0);
+    g_us = 50000;
+    SetLevel(PIN, 1);
+    g_us = 100000;
+    SetLevel(PIN, 0);
+    CHECK(!g_irqMask[PIN]);
+
+    /* held: delivered once, re-sampled every debounce time */
+    g_traceNum = 0;
+    g_trace[g_traceNum++] = (Edge){140000, 1};
+    Run(UINT64_MAX);
+    CHECK(g_callbackNum == 1);
+    CHECK(g_irqMask[PIN]);
+
+    /* the timer cannot restart while held: the pin is unmasked, the held press is not delivered again */
+    g_us = 200000;
+    SetLevel(PIN, 0);
+    g_traceNum = 0;
+    Run(212000);
+    CHECK(g_callbackNum == 2);
+    CHECK(!g_irqMask[PIN]);
+    g_timerFail = 1;
+    Run(230000);
+    CHECK(g_irqMask[PIN]);
+    g_trace[g_traceNum++] = (Edge){260000, 1};
+    g_trace[g_traceNum++] = (Edge){300000, 0};
+    g_trace[g_traceNum++] = (Edge){400000, 1};
+    Run(UINT64_MAX);
+    CHECK(g_callbackNum == 3);
+    CHECK(g_irqMask[PIN]);
+    Stop();
+}
+
+int main(void)
+{
+    TestTrace();
+    TestTimerFail();
+    printf("gpio_debounce_test: ok\n");
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of gpio_init in b91_ble_sdk/drivers/B91/gpio_default.h: the batched analog transfers must leave the
+ * analog registers as the per register writes did, one byte per pin group, and keep the PC/PD pull enables.
+ * Built once with the default pin setting and once with the overrides passed by run.sh. The analog bus time is
+ * compared with the one byte analog_write_reg8 per register the init did before.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+/* compiler.h, gpio.h and sys.h are replaced by the definitions below, the register map is the real gpio_reg.h */
+#define COMPILER_H_
+#define DRIVERS_GPIO_H_
+#define SYS_H_
+
+#define _attribute_ram_code_sec_
+#define BIT(n) (1 << (n))
+
+#define REG_BASE      0x140300
+#define REG_SIZE      0x100
+#define REG_ADDR8(a)  (*(volatile uint8_t *)&g_reg[(a) - REG_BASE])
+#define REG_ADDR16(a) (*(volatile uint16_t *)&g_reg[(a) - REG_BASE])
+#define REG_ADDR32(a) (*(volatile uint32_t *)&g_reg[(a) - REG_BASE])
+
+enum {
+    AS_GPIO,
+    AS_MSPI,
+    AS_SWS,
+    AS_SWM,
+    AS_USB_DP,
+    AS_USB_DM,
+    AS_TDI,
+    AS_TDO,
+    AS_TMS,
+    AS_TCK,
+};
+
+enum {
+    GPIO_PIN_UP_DOWN_FLOAT = 0,
+    GPIO_PIN_PULLUP_1M = 1,
+    GPIO_PIN_PULLDOWN_100K = 2,
+    GPIO_PIN_PULLUP_10K = 3,
+};
+
+static _Alignas(4) uint8_t g_reg[REG_SIZE];
+static uint8_t g_ana[256];
+static int g_anaTransfers;
+static int g_anaBytes;
+
+/* analog bus time assumptions: irq off, address and start, wait for done, then the bytes */
+#define ANA_TRANSFER_NS 1000
+#define ANA_BYTE_NS     250
+
+static void analog_read_buff(unsigned char addr, unsigned char *buff, int len)
+{
+    CHECK(addr + len <= (int)sizeof(g_ana));
+    memcpy(buff, &g_ana[addr], len);
+    g_anaTransfers++;
+    g_anaBytes += len;
+}
+
+static void analog_write_buff(unsigned char addr, unsigned char *buff, int len)
+{
+    CHECK(addr + len <= (int)sizeof(g_ana));
+    memcpy(&g_ana[addr], buff, len);
+    g_anaTransfers++;
+    g_anaBytes += len;
+}
+
+#include "reg_include/gpio_reg.h"
+
+#include "gpio_default.h"
+
+#define PIN_ROW(port, field)                                                                                  \
+    {                                                                                                         \
+        port##0##field, port##1##field, port##2##field, port##3##field, port##4##field, port##5##field,     \
+            port##6##field, port##7##field                                                                    \
+    }
+#define PULL_ROW(port)                                                                                         \
+    {                                                                                                          \
+        PULL_WAKEUP_SRC_##port##0, PULL_WAKEUP_SRC_##port##1, PULL_WAKEUP_SRC_##port##2,                       \
+            PULL_WAKEUP_SRC_##port##3, PULL_WAKEUP_SRC_##port##4, PULL_WAKEUP_SRC_##port##5,                   \
+            PULL_WAKEUP_SRC_##port##6, PULL_WAKEUP_SRC_##port##7                                               \
+    }
+
+static const uint8_t g_pull[5][8] = { PULL_ROW(PA), PULL_ROW(PB), PULL_ROW(PC), PULL_ROW(PD), PULL_ROW(PE) };
+static const uint8_t g_pcIe[8] = PIN_ROW(PC, _INPUT_ENABLE);
+static const uint8_t g_pcDs[8] = PIN_ROW(PC, _DATA_STRENGTH);
+static const uint8_t g_pdIe[8] = PIN_ROW(PD, _INPUT_ENABLE);
+static const uint8_t g_pdDs[8] = PIN_ROW(PD, _DATA_STRENGTH);
+
+static uint8_t PinBits(const uint8_t *pins)
+{
+    uint8_t bits = 0;
+
+    for (int i = 0; i < 8; i++) {
+        bits |= (uint8_t)((pins[i] ? 1 : 0) << i);
+    }
+
+    return bits;
+}
+
+/* the analog registers as the per register writes left them */
+static void Reference(uint8_t *ana, int anaResInit)
+{
+    ana[areg_gpio_pc_ie] = PinBits(g_pcIe);
+    ana[areg_gpio_pc_ds] = PinBits(g_pcDs);
+    ana[areg_gpio_pd_ie] = PinBits(g_pdIe);
+    ana[areg_gpio_pd_ds] = PinBits(g_pdDs);
+
+    if (!anaResInit) {
+        return;
+    }
+    /* 0x0e ~ 0x17, 2 bits per pin, 4 pins per register */
+    for (int port = 0; port < 5; port++) {
+        for (int pin = 0; pin < 8; pin++) {
+            if (pin % 4 == 0) {
+                ana[0x0e + port * 2 + pin / 4] = 0;
+            }
+            ana[0x0e + port * 2 + pin / 4] |= (uint8_t)((g_pull[port][pin] & 3) << ((pin % 4) * 2));
+        }
+    }
+}
+
+static void Check(int anaResInit, uint8_t fill)
+{
+    uint8_t expect[sizeof(g_ana)];
+
+    memset(g_ana, fill, sizeof(g_ana));
+    memcpy(expect, g_ana, sizeof(g_ana));
+    Reference(expect, anaResInit);
+
+    g_anaTransfers = 0;
+    g_anaBytes = 0;
+    gpio_init(anaResInit);
+
+    for (uint32_t i = 0; i < sizeof(g_ana); i++) {
+        if (g_ana[i] != expect[i]) {
+            fprintf(stderr, "analog 0x%02x: 0x%02x, expected 0x%02x\n", i, g_ana[i], expect[i]);
+            exit(1);
+        }
+    }
+    /* PC/PD read and write, plus the pull block */
+    CHECK(g_anaTransfers == (anaResInit ? 3 : 2));
+}
+
+/* the per register init wrote PC/PD ie and ds and the 10 pull bytes one by one */
+static void BootTime(void)
+{
+    const int legacy = 4 + 10;
+    double legacyUs = legacy * (ANA_TRANSFER_NS + ANA_BYTE_NS) / 1000.0;
+    double us;
+
+    g_anaTransfers = 0;
+    g_anaBytes = 0;
+    gpio_init(1);
+    us = (g_anaTransfers * ANA_TRANSFER_NS + g_anaBytes * ANA_BYTE_NS) / 1000.0;
+    printf("gpio_default_test: %d analog transfers %d bytes %.1f us, per register %d transfers %.1f us\n",
+           g_anaTransfers, g_anaBytes, us, legacy, legacyUs);
+    CHECK(us < legacyUs);
+}
+
+int main(void)
+{
+    Check(0, 0x5A);
+    Check(1, 0xA5);
+    Check(1, 0x00);
+    BootTime();
+    printf("gpio_default_test: ok\n");
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host benchmark of the positional calls and the size/position cache of hal_file.c over hal_file_shim.c. Reads
+ * random 32 byte records of a 32 KB file as seek + read, as pread, and as the fstat + lseek + read the HAL made
+ * before the cache, and prints the file calls and the modelled littlefs flash reads per record. The counts are
+ * checked too: no fstat on a seek, lseek + read for a random record, no lseek when reading in order, and a size
+ * grown through another handle is seen.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <hal_file.h>
+#include <hal_file_ext.h>
+#include <utils_file.h>
+
+#include "hal_file_shim.h"
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define RECORD_SIZE 32
+#define RECORD_NUM  1024
+#define READ_NUM    4096
+#define FILE_NAME   "bench"
+
+typedef enum {
+    MODE_SEEK_READ,
+    MODE_PREAD,
+    MODE_SEQUENTIAL,
+    MODE_UNCACHED, /* HalFileSeek + HalFileRead before the cache */
+} Mode;
+
+typedef struct {
+    double calls;
+    double fstat;
+    double lseek;
+    double flashRead;
+    double ns;
+} Result;
+
+static unsigned int g_rand = 11;
+
+static unsigned int Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+static void FillRecord(char *rec, unsigned int index)
+{
+    for (int i = 0; i < RECORD_SIZE; i++) {
+        rec[i] = (char)(index * 7 + i);
+    }
+}
+
+static void CheckRecord(const char *rec, unsigned int index)
+{
+    char expect[RECORD_SIZE];
+
+    FillRecord(expect, index);
+    CHECK(memcmp(rec, expect, RECORD_SIZE) == 0);
+}
+
+static double NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void ReadRecord(Mode mode, int fd, int osFd, unsigned int index, char *rec)
+{
+    struct stat st;
+
+    switch (mode) {
+        case MODE_SEEK_READ:
+            CHECK(HalFileSeek(fd, index * RECORD_SIZE, SEEK_SET_FS) == (int)(index * RECORD_SIZE));
+            CHECK(HalFileRead(fd, rec, RECORD_SIZE) == RECORD_SIZE);
+            break;
+        case MODE_PREAD:
+            CHECK(HalFilePread(fd, rec, RECORD_SIZE, index * RECORD_SIZE) == RECORD_SIZE);
+            break;
+        case MODE_SEQUENTIAL:
+            CHECK(HalFileRead(fd, rec, RECORD_SIZE) == RECORD_SIZE);
+            break;
+        case MODE_UNCACHED:
+            CHECK(HostFstat(osFd, &st) == 0 && index * RECORD_SIZE <= st.st_size);
+            CHECK(HostLseek(osFd, index * RECORD_SIZE, SEEK_SET) == index * RECORD_SIZE);
+            CHECK(HostRead(osFd, rec, RECORD_SIZE) == RECORD_SIZE);
+            break;
+    }
+}
+
+static Result Run(Mode mode, int fd, int osFd)
+{
+    HostFileCount count;
+    Result result;
+    char rec[RECORD_SIZE];
+    double start;
+
+    if (mode == MODE_SEQUENTIAL) {
+        CHECK(HalFileSeek(fd, 0, SEEK_SET_FS) == 0);
+        CHECK(HalFileRead(fd, rec, RECORD_SIZE) == RECORD_SIZE);
+    }
+    HostFileCountReset();
+    start = NowNs();
+    for (unsigned int i = 0; i < READ_NUM; i++) {
+        unsigned int index = (mode == MODE_SEQUENTIAL) ? (i + 1) % RECORD_NUM : Rand() % RECORD_NUM;
+        if (mode == MODE_SEQUENTIAL && index == 0) {
+            CHECK(HalFileSeek(fd, 0, SEEK_SET_FS) == 0);
+        }
+        ReadRecord(mode, fd, osFd, index, rec);
+        CheckRecord(rec, index);
+    }
+    result.ns = (NowNs() - start) / READ_NUM;
+    HostFileCountGet(&count);
+    result.calls = (double)(count.read + count.write + count.lseek + count.fstat) / READ_NUM;
+    result.fstat = (double)count.fstat / READ_NUM;
+    result.lseek = (double)count.lseek / READ_NUM;
+    result.flashRead = (double)count.flashRead / READ_NUM;
+
+    return result;
+}
+
+static void Print(const char *name, const Result *result)
+{
+    printf("  %-22s %5.2f calls (%4.2f fstat, %4.2f lseek), %5.2f flash reads, %6.0f ns per record\n", name,
+           result->calls, result->fstat, result->lseek, result->flashRead, result->ns);
+}
+
+/* the cached size follows writes of another handle */
+static void CheckSizeCache(int fd)
+{
+    char rec[RECORD_SIZE];
+    int other = HalFileOpen(FILE_NAME, O_WRONLY_FS | O_APPEND_FS, 0);
+
+    CHECK(other > 0);
+    CHECK(HalFileSeek(fd, RECORD_NUM * RECORD_SIZE + 1, SEEK_SET_FS) == -1);
+    FillRecord(rec, RECORD_NUM);
+    CHECK(HalFileWrite(other, rec, RECORD_SIZE) == RECORD_SIZE);
+    CHECK(HalFileSeek(fd, 0, SEEK_END_FS) == (RECORD_NUM + 1) * RECORD_SIZE);
+    CHECK(HalFilePread(fd, rec, RECORD_SIZE, RECORD_NUM * RECORD_SIZE) == RECORD_SIZE);
+    CheckRecord(rec, RECORD_NUM);
+    CHECK(HalFileClose(other) == 0);
+}
+
+int main(void)
+{
+    char rec[RECORD_SIZE];
+    Result seekRead, pread, sequential, uncached;
+    int fd, osFd;
+
+    HostFileInit();
+    fd = HalFileOpen(FILE_NAME, O_CREAT_FS | O_RDWR_FS | O_TRUNC_FS, 0);
+    CHECK(fd > 0);
+    for (unsigned int i = 0; i < RECORD_NUM; i++) {
+        FillRecord(rec, i);
+        CHECK(HalFileWrite(fd, rec, RECORD_SIZE) == RECORD_SIZE);
+    }
+    osFd = HostOpen("/data/" FILE_NAME, O_RDONLY);
+    CHECK(osFd >= 0);
+
+    seekRead = Run(MODE_SEEK_READ, fd, osFd);
+    pread = Run(MODE_PREAD, fd, osFd);
+    sequential = Run(MODE_SEQUENTIAL, fd, osFd);
+    uncached = Run(MODE_UNCACHED, fd, osFd);
+
+    printf("hal_file_bench: %d random reads of %d byte records, %d KB file\n", READ_NUM, RECORD_SIZE,
+           RECORD_NUM * RECORD_SIZE / 1024);
+    Print("seek + read", &seekRead);
+    Print("pread", &pread);
+    Print("sequential read", &sequential);
+    Print("fstat + lseek + read", &uncached);
+
+    // a random record is lseek + read, less when it happens to follow the last one
+    CHECK(seekRead.fstat == 0 && seekRead.calls <= 2);
+    CHECK(pread.fstat == 0 && pread.calls <= 2);
+    CHECK(sequential.fstat == 0 && sequential.lseek * READ_NUM <= READ_NUM / RECORD_NUM);
+    CHECK(uncached.calls == 3);
+    CHECK(pread.flashRead < uncached.flashRead);
+
+    CheckSizeCache(fd);
+    CHECK(HalFileClose(fd) == 0);
+    CHECK(HostClose(osFd) == 0);
+    CHECK(HalFileDelete(FILE_NAME) == 0);
+    HostFileCleanup();
+    printf("hal_file_bench: ok\n");
+    return 0;
+}
@@ -0,0 +1,189 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * POSIX shim under hal_file.c for the host checks. The calls go to the host file system below a temporary directory
+ * and are counted. On the board the files live in littlefs (liteos_m/src/littlefs_hal.c, 512 byte cache, no littlefs
+ * sources in this tree), the flash reads are modelled after it: a metadata lookup on open and fstat, and one read for
+ * every cache line of file data that is not the line the file read last. lseek does not touch flash.
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hal_file_shim.h"
+
+#define DATA_PREFIX     "/data/"
+#define CACHE_LINE_SIZE 512
+#define MAX_HOST_FD     1024
+
+static char g_root[32];
+static HostFileCount g_count;
+static long g_cachedLine[MAX_HOST_FD];
+
+static void Count(unsigned long *counter, unsigned long n)
+{
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+static void SetCachedLine(int fd, long line)
+{
+    if (fd >= 0 && fd < MAX_HOST_FD) {
+        __atomic_store_n(&g_cachedLine[fd], line, __ATOMIC_RELAXED);
+    }
+}
+
+/* /data/name -> <root>/name, false for any other path */
+static int HostPath(const char *path, char *out)
+{
+    if (strncmp(path, DATA_PREFIX, strlen(DATA_PREFIX)) != 0) {
+        return 0;
+    }
+    return snprintf(out, PATH_MAX, "%s/%s", g_root, path + strlen(DATA_PREFIX)) < PATH_MAX;
+}
+
+void HostFileInit(void)
+{
+    snprintf(g_root, sizeof(g_root), "/tmp/hal_file_XXXXXX");
+    if (mkdtemp(g_root) == NULL) {
+        perror("mkdtemp");
+        exit(1);
+    }
+}
+
+void HostFileCleanup(void)
+{
+    char path[PATH_MAX];
+    struct dirent *ent;
+    DIR *dir = opendir(g_root);
+
+    while (dir != NULL && (ent = readdir(dir)) != NULL) {
+        if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+            snprintf(path, sizeof(path), "%s/%s", g_root, ent->d_name);
+            unlink(path);
+        }
+    }
+    if (dir != NULL) {
+        closedir(dir);
+    }
+    rmdir(g_root);
+}
+
+void HostFileCountGet(HostFileCount *count)
+{
+    count->open = __atomic_load_n(&g_count.open, __ATOMIC_RELAXED);
+    count->close = __atomic_load_n(&g_count.close, __ATOMIC_RELAXED);
+    count->read = __atomic_load_n(&g_count.read, __ATOMIC_RELAXED);
+    count->write = __atomic_load_n(&g_count.write, __ATOMIC_RELAXED);
+    count->lseek = __atomic_load_n(&g_count.lseek, __ATOMIC_RELAXED);
+    count->fstat = __atomic_load_n(&g_count.fstat, __ATOMIC_RELAXED);
+    count->flashRead = __atomic_load_n(&g_count.flashRead, __ATOMIC_RELAXED);
+}
+
+void HostFileCountReset(void)
+{
+    unsigned long *counter = (unsigned long *)&g_count;
+
+    for (unsigned int i = 0; i < sizeof(g_count) / sizeof(*counter); i++) {
+        __atomic_store_n(&counter[i], 0, __ATOMIC_RELAXED);
+    }
+}
+
+int HostOpen(const char *path, int flags, ...)
+{
+    char hostPath[PATH_MAX];
+    int fd;
+
+    Count(&g_count.open, 1);
+    Count(&g_count.flashRead, 1);
+    if (!HostPath(path, hostPath)) {
+        return -1;
+    }
+    fd = open(hostPath, flags, 0600);
+    SetCachedLine(fd, -1);
+
+    return fd;
+}
+
+int HostClose(int fd)
+{
+    Count(&g_count.close, 1);
+    return close(fd);
+}
+
+ssize_t HostRead(int fd, void *buf, size_t len)
+{
+    off_t pos = lseek(fd, 0, SEEK_CUR);
+    ssize_t ret;
+
+    Count(&g_count.read, 1);
+    ret = read(fd, buf, len);
+    if (ret > 0 && pos >= 0 && fd < MAX_HOST_FD) {
+        long first = pos / CACHE_LINE_SIZE;
+        long last = (pos + ret - 1) / CACHE_LINE_SIZE;
+        long lines = last - first + 1;
+
+        if (first == __atomic_load_n(&g_cachedLine[fd], __ATOMIC_RELAXED)) {
+            lines--;
+        }
+        Count(&g_count.flashRead, lines);
+        SetCachedLine(fd, last);
+    }
+
+    return ret;
+}
+
+ssize_t HostWrite(int fd, const void *buf, size_t len)
+{
+    Count(&g_count.write, 1);
+    SetCachedLine(fd, -1);
+    return write(fd, buf, len);
+}
+
+off_t HostLseek(int fd, off_t offset, int whence)
+{
+    Count(&g_count.lseek, 1);
+    return lseek(fd, offset, whence);
+}
+
+int HostFstat(int fd, struct stat *buf)
+{
+    Count(&g_count.fstat, 1);
+    Count(&g_count.flashRead, 1);
+    return fstat(fd, buf);
+}
+
+int HostUnlink(const char *path)
+{
+    char hostPath[PATH_MAX];
+
+    return HostPath(path, hostPath) ? unlink(hostPath) : -1;
+}
+
+int HostStat(const char *path, struct stat *buf)
+{
+    char hostPath[PATH_MAX];
+
+    Count(&g_count.flashRead, 1);
+    return HostPath(path, hostPath) ? stat(hostPath, buf) : -1;
+}
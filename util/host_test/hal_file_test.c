@@ -0,0 +1,269 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host stress test of the handle table of hal_file.c with pthreads over hal_file_shim.c, run.sh runs it under
+ * ASan/UBSan and under TSan. Threads open, write, read and close private files at the same time and must never share
+ * a slot; write records through one shared handle, which must all land whole, once and in the order of each thread;
+ * keep reading a handle that another thread closes, which must fail cleanly; and race for the last free slots.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hal_file.h>
+#include <hal_file_ext.h>
+#include <utils_file.h>
+
+#include "hal_file_shim.h"
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define THREAD_NUM     8
+#define ROUND_NUM      50
+#define RECORD_NUM     16  /* per private file */
+#define SHARED_NUM     200 /* records per thread through the shared handle */
+#define MAX_FD         32  /* MAX_OPEN_FILE_NUM of hal_file.c */
+#define SHARED_FILE    "shared"
+#define RECORD_MAGIC   0x5a5a0000u
+
+typedef struct {
+    unsigned int thread;
+    unsigned int seq;
+    unsigned int magic;
+    unsigned int check;
+} Record;
+
+static int g_slotOwner[MAX_FD + 1];
+static int g_sharedFd;
+static int g_closed;
+static int g_tableFd[THREAD_NUM][MAX_FD];
+static pthread_barrier_t g_barrier;
+
+static void MakeRecord(Record *rec, unsigned int thread, unsigned int seq)
+{
+    rec->thread = thread;
+    rec->seq = seq;
+    rec->magic = RECORD_MAGIC | thread;
+    rec->check = ~(thread * 131 + seq);
+}
+
+static int RecordValid(const Record *rec)
+{
+    return rec->thread < THREAD_NUM && rec->magic == (RECORD_MAGIC | rec->thread) &&
+           rec->check == ~(rec->thread * 131 + rec->seq);
+}
+
+static void RunThreads(void *(*fn)(void *))
+{
+    pthread_t tid[THREAD_NUM];
+
+    for (long i = 0; i < THREAD_NUM; i++) {
+        CHECK(pthread_create(&tid[i], NULL, fn, (void *)i) == 0);
+    }
+    for (int i = 0; i < THREAD_NUM; i++) {
+        CHECK(pthread_join(tid[i], NULL) == 0);
+    }
+}
+
+/* every thread on its own file: a slot is never handed to two threads, handles do not see each other's state */
+static void *PrivateFiles(void *arg)
+{
+    unsigned int self = (unsigned int)(long)arg;
+    char name[16];
+    Record rec;
+
+    snprintf(name, sizeof(name), "private%u", self);
+    for (unsigned int round = 0; round < ROUND_NUM; round++) {
+        int fd = HalFileOpen(name, O_CREAT_FS | O_RDWR_FS | O_TRUNC_FS, 0);
+        int owner = 0;
+
+        CHECK(fd > 0 && fd <= MAX_FD);
+        CHECK(__atomic_compare_exchange_n(&g_slotOwner[fd], &owner, self + 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+        for (unsigned int i = 0; i < RECORD_NUM; i++) {
+            MakeRecord(&rec, self, round * RECORD_NUM + i);
+            if (i & 1) {
+                CHECK(HalFilePwrite(fd, (const char *)&rec, sizeof(rec), i * sizeof(rec)) == sizeof(rec));
+                CHECK(HalFileSeek(fd, 0, SEEK_END_FS) == (int)((i + 1) * sizeof(rec)));
+            } else {
+                CHECK(HalFileWrite(fd, (const char *)&rec, sizeof(rec)) == sizeof(rec));
+            }
+        }
+        for (unsigned int i = 0; i < RECORD_NUM; i++) {
+            unsigned int at = (i * 7) % RECORD_NUM;
+            if (i & 1) {
+                CHECK(HalFilePread(fd, (char *)&rec, sizeof(rec), at * sizeof(rec)) == sizeof(rec));
+            } else {
+                CHECK(HalFileSeek(fd, at * sizeof(rec), SEEK_SET_FS) == (int)(at * sizeof(rec)));
+                CHECK(HalFileRead(fd, (char *)&rec, sizeof(rec)) == sizeof(rec));
+            }
+            CHECK(RecordValid(&rec) && rec.thread == self && rec.seq == round * RECORD_NUM + at);
+        }
+
+        __atomic_store_n(&g_slotOwner[fd], 0, __ATOMIC_RELEASE);
+        CHECK(HalFileClose(fd) == 0);
+    }
+
+    return NULL;
+}
+
+/* all threads write through one handle while reading it back positionally */
+static void *SharedHandle(void *arg)
+{
+    unsigned int self = (unsigned int)(long)arg;
+    unsigned int seed = self + 1;
+    Record rec;
+
+    for (unsigned int seq = 0; seq < SHARED_NUM; seq++) {
+        MakeRecord(&rec, self, seq);
+        CHECK(HalFileWrite(g_sharedFd, (const char *)&rec, sizeof(rec)) == sizeof(rec));
+
+        // every record below the end was written whole under the handle lock
+        seed = seed * 1103515245 + 12345;
+        unsigned int at = (seed >> 8) % (seq + 1);
+        CHECK(HalFilePread(g_sharedFd, (char *)&rec, sizeof(rec), at * sizeof(rec)) == sizeof(rec));
+        CHECK(RecordValid(&rec));
+    }
+
+    return NULL;
+}
+
+static void CheckSharedFile(void)
+{
+    unsigned int next[THREAD_NUM] = {0};
+    Record rec;
+    int fd = HalFileOpen(SHARED_FILE, O_RDONLY_FS, 0);
+
+    CHECK(fd > 0);
+    CHECK(HalFileSeek(fd, 0, SEEK_END_FS) == (int)(THREAD_NUM * SHARED_NUM * sizeof(rec)));
+    CHECK(HalFileSeek(fd, 0, SEEK_SET_FS) == 0);
+    for (unsigned int i = 0; i < THREAD_NUM * SHARED_NUM; i++) {
+        CHECK(HalFileRead(fd, (char *)&rec, sizeof(rec)) == sizeof(rec));
+        CHECK(RecordValid(&rec));
+        CHECK(rec.seq == next[rec.thread]++);
+    }
+    CHECK(HalFileRead(fd, (char *)&rec, sizeof(rec)) == 0);
+    CHECK(HalFileClose(fd) == 0);
+}
+
+/* readers of a handle closed under them get errors, never data of a freed slot */
+static void *ReadWhileClosed(void *arg)
+{
+    unsigned int self = (unsigned int)(long)arg;
+    unsigned int failed = 0;
+    Record rec;
+
+    if (self == 0) {
+        pthread_barrier_wait(&g_barrier);
+        CHECK(HalFileClose(g_sharedFd) == 0);
+        __atomic_store_n(&g_closed, 1, __ATOMIC_RELEASE);
+        CHECK(HalFileClose(g_sharedFd) == -1);
+        return NULL;
+    }
+
+    pthread_barrier_wait(&g_barrier);
+    for (unsigned int i = 0; failed < 100; i++) {
+        int closed = __atomic_load_n(&g_closed, __ATOMIC_ACQUIRE);
+        int ret = (i & 1) ? HalFilePread(g_sharedFd, (char *)&rec, sizeof(rec), (i % SHARED_NUM) * sizeof(rec))
+                          : HalFileRead(g_sharedFd, (char *)&rec, sizeof(rec));
+        if (ret == -1) {
+            failed++;
+        } else {
+            CHECK(!closed);
+            // the sequential reads stop at the end of the file
+            CHECK(ret == 0 || (ret == sizeof(rec) && RecordValid(&rec)));
+        }
+    }
+
+    return NULL;
+}
+
+/* threads race for the table, every slot goes to exactly one of them */
+static void *FillTable(void *arg)
+{
+    unsigned int self = (unsigned int)(long)arg;
+    char name[16];
+
+    snprintf(name, sizeof(name), "private%u", self);
+    for (int i = 0; i < MAX_FD; i++) {
+        g_tableFd[self][i] = HalFileOpen(name, O_RDONLY_FS, 0);
+        if (g_tableFd[self][i] > 0) {
+            int owner = 0;
+            CHECK(__atomic_compare_exchange_n(&g_slotOwner[g_tableFd[self][i]], &owner, self + 1, 0, __ATOMIC_ACQ_REL,
+                                              __ATOMIC_RELAXED));
+        }
+    }
+
+    return NULL;
+}
+
+static void CheckTable(void)
+{
+    int opened = 0;
+
+    for (int t = 0; t < THREAD_NUM; t++) {
+        for (int i = 0; i < MAX_FD; i++) {
+            if (g_tableFd[t][i] > 0) {
+                opened++;
+                CHECK(HalFileClose(g_tableFd[t][i]) == 0);
+                g_slotOwner[g_tableFd[t][i]] = 0;
+            } else {
+                CHECK(g_tableFd[t][i] == -1);
+            }
+        }
+    }
+    CHECK(opened == MAX_FD);
+}
+
+int main(void)
+{
+    char name[16];
+
+    HostFileInit();
+    RunThreads(PrivateFiles);
+
+    g_sharedFd = HalFileOpen(SHARED_FILE, O_CREAT_FS | O_RDWR_FS | O_TRUNC_FS, 0);
+    CHECK(g_sharedFd > 0);
+    RunThreads(SharedHandle);
+    CheckSharedFile();
+
+    CHECK(pthread_barrier_init(&g_barrier, NULL, THREAD_NUM) == 0);
+    RunThreads(ReadWhileClosed);
+    CHECK(pthread_barrier_destroy(&g_barrier) == 0);
+
+    RunThreads(FillTable);
+    CheckTable();
+
+    for (unsigned int i = 0; i < THREAD_NUM; i++) {
+        snprintf(name, sizeof(name), "private%u", i);
+        CHECK(HalFileDelete(name) == 0);
+    }
+    CHECK(HalFileDelete(SHARED_FILE) == 0);
+    HostFileCleanup();
+    printf("hal_file_test: ok\n");
+    return 0;
+}
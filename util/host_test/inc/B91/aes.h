@@ -0,0 +1,30 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_AES_H
+#define HOST_TEST_AES_H
+
+/* AES-128 in software, see aes_model.c, with the FIPS-197 byte order */
+
+int aes_encrypt(unsigned char *key, unsigned char *plaintext, unsigned char *result);
+int aes_decrypt(unsigned char *key, unsigned char *decrypttext, unsigned char *result);
+
+/* blocks processed since the start of the program */
+unsigned int aes_model_block_count(void);
+
+#endif /* HOST_TEST_AES_H */
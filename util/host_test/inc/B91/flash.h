@@ -0,0 +1,51 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_FLASH_H
+#define HOST_TEST_FLASH_H
+
+#include <stdint.h>
+
+/*
+ * RAM model of the first 1MB of the NOR flash, see flash_model.c.
+ * Programming can only clear bits, erase sets a whole 4KB sector to 0xFF.
+ */
+
+#define FLASH_MODEL_SIZE        0x100000
+#define FLASH_MODEL_SECTOR_SIZE 4096
+
+void flash_erase_sector(unsigned long addr);
+void flash_write_page(unsigned long addr, unsigned long len, unsigned char *buf);
+void flash_read_page(unsigned long addr, unsigned long len, unsigned char *buf);
+
+/* implemented by the tests that need it */
+int flash_read_mid_uid_with_check(unsigned int *flash_mid, unsigned char *flash_uid);
+
+/* erase the whole model and power it on */
+void flash_model_reset(void);
+
+/* cut the power after programming bytes more bytes, every later erase and program is dropped */
+void flash_model_power_cut(uint32_t bytes);
+
+/* power back on, returns non zero if the cut was hit since flash_model_power_cut */
+int flash_model_power_on(void);
+
+/* bytes read since the start of the program */
+uint32_t flash_model_read_bytes(void);
+
+#endif /* HOST_TEST_FLASH_H */
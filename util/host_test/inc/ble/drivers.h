@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_BLE_DRIVERS_H
+#define HOST_TEST_BLE_DRIVERS_H
+
+#include <stdint.h>
+#include <string.h>
+
+/* types and system timer of the B91 driver headers, the tick comes from the test */
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+
+enum {
+    SYSTEM_TIMER_TICK_1US = 16,
+    SYSTEM_TIMER_TICK_1MS = 16000,
+    SYSTEM_TIMER_TICK_1S = 16000000,
+};
+
+#define U32_MAX ((u32)0xffffffff)
+
+#define _attribute_data_retention_
+
+extern u32 g_hostTick;
+
+static inline u32 clock_time(void)
+{
+    return g_hostTick;
+}
+
+static inline u32 clock_time_exceed(u32 ref, u32 us)
+{
+    return (u32)(g_hostTick - ref) > us * SYSTEM_TIMER_TICK_1US;
+}
+
+#define reg_system_tick g_hostTick
+
+#ifndef BIT
+#define BIT(n) (1 << (n))
+#endif
+
+/* machine CSRs, only mstatus is used */
+#define NDS_MSTATUS 0x300
+
+extern u32 g_hostMstatus;
+
+#define clear_csr(csr, bits)                   \
+    ({                                         \
+        u32 __v = g_hostMstatus;               \
+        g_hostMstatus &= ~(u32)(bits);         \
+        __v;                                   \
+    })
+#define set_csr(csr, bits) (g_hostMstatus |= (u32)(bits))
+
+static inline u32 core_interrupt_disable(void)
+{
+    return clear_csr(NDS_MSTATUS, BIT(3));
+}
+
+static inline u32 core_restore_interrupt(u32 en)
+{
+    set_csr(NDS_MSTATUS, en & BIT(3));
+    return 0;
+}
+
+typedef enum {
+    UART0,
+    UART1,
+} uart_num_e;
+
+/* implemented by the test */
+void uart_send_byte(uart_num_e uart_num, unsigned char tx_data);
+
+/* pads and PWM as the vendor modules use them, implemented by the test */
+typedef unsigned int gpio_pin_e;
+typedef unsigned char pwm_id_e;
+
+void gpio_function_en(gpio_pin_e pin);
+void gpio_output_en(gpio_pin_e pin);
+void gpio_set_level(gpio_pin_e pin, unsigned char value);
+void pwm_set_pin(gpio_pin_e pin);
+void pwm_set_tmax(pwm_id_e id, unsigned short tmax);
+void pwm_set_tcmp(pwm_id_e id, unsigned short tcmp);
+void pwm_start(pwm_id_e id);
+
+#define PIN_MUX_FUNC_GPIO 0xff
+#define PIN_MUX_FUNC_KEEP 0xfe
+
+typedef enum {
+    PIN_MUX_OWNER_NONE = 0,
+    PIN_MUX_OWNER_GPIO = 3,
+    PIN_MUX_OWNER_PWM = 9,
+} pin_mux_owner_e;
+
+typedef struct {
+    gpio_pin_e pin;
+    unsigned char func;
+} pin_mux_cfg_t;
+
+int pin_mux_claim(pin_mux_owner_e owner, const pin_mux_cfg_t *cfg, unsigned int num, unsigned char pad_mul_sel);
+
+#endif /* HOST_TEST_BLE_DRIVERS_H */
@@ -0,0 +1,30 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_BLE_STACK_BLE_H
+#define HOST_TEST_BLE_STACK_BLE_H
+
+#include "drivers.h"
+
+/* application wakeup of the BLE stack pm, implemented by the test */
+typedef void (*pm_appWakeupLowPower_callback_t)(int);
+
+void bls_pm_setAppWakeupLowPower(u32 wakeup_tick, u8 enable);
+void bls_pm_registerAppWakeupLowPowerCb(pm_appWakeupLowPower_callback_t cb);
+
+#endif /* HOST_TEST_BLE_STACK_BLE_H */
@@ -0,0 +1,32 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_BLE_TL_COMMON_H
+#define HOST_TEST_BLE_TL_COMMON_H
+
+#include "drivers.h"
+
+/* vendor/common is on the include path of every test */
+#include "blt_soft_timer.h"
+
+/* custom pair table of vendor/common/custom_pair.h, implemented by the test */
+int user_tbl_slave_mac_search(u8 adr_type, u8 *adr);
+int user_tbl_slave_mac_add(u8 adr_type, u8 *adr);
+int user_tbl_slave_mac_free_num(void);
+
+#endif /* HOST_TEST_BLE_TL_COMMON_H */
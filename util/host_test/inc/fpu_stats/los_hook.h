@@ -0,0 +1,36 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_LOS_HOOK_H
+#define HOST_TEST_LOS_HOOK_H
+
+#include <stdint.h>
+
+typedef uint32_t UINT32;
+
+#define VOID void
+#define LOS_OK 0
+
+typedef enum {
+    LOS_HOOK_TYPE_TASK_SWITCHEDIN,
+} LosHookType;
+
+/* the test keeps the hook and calls it where the scheduler would */
+UINT32 LOS_HookReg(LosHookType type, VOID (*hook)(VOID));
+
+#endif /* HOST_TEST_LOS_HOOK_H */
@@ -0,0 +1,39 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_LOS_TASK_H
+#define HOST_TEST_LOS_TASK_H
+
+#include <stdint.h>
+
+typedef uint32_t UINT32;
+
+#define LOSCFG_BASE_CORE_TSK_LIMIT 7
+
+typedef struct {
+    UINT32 taskID;
+} LosTaskCB;
+
+typedef struct {
+    LosTaskCB *runTask;
+    LosTaskCB *newTask;
+} LosTask;
+
+extern LosTask g_losTask;
+
+#endif /* HOST_TEST_LOS_TASK_H */
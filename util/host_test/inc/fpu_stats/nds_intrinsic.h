@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_NDS_INTRINSIC_H
+#define HOST_TEST_NDS_INTRINSIC_H
+
+/* only mstatus is modelled, it is a variable of the test */
+
+#define NDS_MSTATUS 0x300
+
+extern unsigned long g_mstatus;
+
+static inline unsigned long __nds__csrr(int csr)
+{
+    (void)csr;
+    return g_mstatus;
+}
+
+static inline unsigned long __nds__csrrc(unsigned long val, int csr)
+{
+    unsigned long old = g_mstatus;
+
+    (void)csr;
+    g_mstatus &= ~val;
+    return old;
+}
+
+#endif /* HOST_TEST_NDS_INTRINSIC_H */
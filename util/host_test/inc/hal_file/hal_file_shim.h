@@ -0,0 +1,51 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_HAL_FILE_SHIM_H
+#define HOST_TEST_HAL_FILE_SHIM_H
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+/* call and modelled flash read counters of the file calls made by hal_file.c */
+typedef struct {
+    unsigned long open;
+    unsigned long close;
+    unsigned long read;
+    unsigned long write;
+    unsigned long lseek;
+    unsigned long fstat;
+    unsigned long flashRead;
+} HostFileCount;
+
+/* /data goes to a new temporary directory, removed again with its files by HostFileCleanup */
+void HostFileInit(void);
+void HostFileCleanup(void);
+void HostFileCountGet(HostFileCount *count);
+void HostFileCountReset(void);
+
+int HostOpen(const char *path, int flags, ...);
+int HostClose(int fd);
+ssize_t HostRead(int fd, void *buf, size_t len);
+ssize_t HostWrite(int fd, const void *buf, size_t len);
+off_t HostLseek(int fd, off_t offset, int whence);
+int HostFstat(int fd, struct stat *buf);
+int HostUnlink(const char *path);
+int HostStat(const char *path, struct stat *buf);
+
+#endif /* HOST_TEST_HAL_FILE_SHIM_H */
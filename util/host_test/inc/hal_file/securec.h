@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_SECUREC_H
+#define HOST_TEST_SECUREC_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the real securec.h brings in stdio.h, stdlib.h and string.h, plus the two bounded string functions hal_file.c uses */
+
+static inline int strcpy_s(char *dest, size_t destMax, const char *src)
+{
+    size_t len = strlen(src);
+
+    if (len >= destMax) {
+        return -1;
+    }
+    memcpy(dest, src, len + 1);
+    return 0;
+}
+
+static inline int strcat_s(char *dest, size_t destMax, const char *src)
+{
+    size_t len = strlen(dest);
+
+    return (len >= destMax) ? -1 : strcpy_s(dest + len, destMax - len, src);
+}
+
+#endif /* HOST_TEST_SECUREC_H */
@@ -0,0 +1,42 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_HAL_FILE_STUB_H
+#define HOST_TEST_HAL_FILE_STUB_H
+
+/*
+ * Forced in front of hal_file.c: the file calls go to hal_file_shim.c, which counts them and puts /data in a
+ * temporary directory. The system headers are included first so that only the calls of hal_file.c are renamed.
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hal_file_shim.h"
+
+#define open            HostOpen
+#define close           HostClose
+#define read            HostRead
+#define write           HostWrite
+#define lseek           HostLseek
+#define fstat           HostFstat
+#define unlink          HostUnlink
+#define stat(path, buf) HostStat(path, buf)
+
+#endif /* HOST_TEST_HAL_FILE_STUB_H */
@@ -0,0 +1,37 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_PIN_MUX_H
+#define HOST_TEST_PIN_MUX_H
+
+#include "../gpio.h"
+
+#define PIN_MUX_FUNC_KEEP 0xfe
+
+typedef enum {
+    PIN_MUX_OWNER_GPIO = 1,
+} pin_mux_owner_e;
+
+typedef struct {
+    gpio_pin_e pin;
+    unsigned char func;
+} pin_mux_cfg_t;
+
+int pin_mux_claim(pin_mux_owner_e owner, const pin_mux_cfg_t *cfg, unsigned int num, unsigned char pad_mul_sel);
+
+#endif /* HOST_TEST_PIN_MUX_H */
@@ -0,0 +1,63 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_GPIO_H
+#define HOST_TEST_GPIO_H
+
+/* the pins and calls gpio_telink.c uses, the levels, pin irq masks and edges come from the test's GPIO model */
+
+#define _attribute_ram_code_
+
+typedef enum {
+    GPIO_PA0 = 0x001, GPIO_PA1 = 0x002, GPIO_PA2 = 0x004, GPIO_PA3 = 0x008,
+    GPIO_PA4 = 0x010, GPIO_PA5 = 0x020, GPIO_PA6 = 0x040, GPIO_PA7 = 0x080,
+    GPIO_PB0 = 0x101, GPIO_PB1 = 0x102, GPIO_PB2 = 0x104, GPIO_PB3 = 0x108,
+    GPIO_PB4 = 0x110, GPIO_PB5 = 0x120, GPIO_PB6 = 0x140, GPIO_PB7 = 0x180,
+    GPIO_PC0 = 0x201, GPIO_PC1 = 0x202, GPIO_PC2 = 0x204, GPIO_PC3 = 0x208,
+    GPIO_PC4 = 0x210, GPIO_PC5 = 0x220, GPIO_PC6 = 0x240, GPIO_PC7 = 0x280,
+    GPIO_PD0 = 0x301, GPIO_PD1 = 0x302, GPIO_PD2 = 0x304, GPIO_PD3 = 0x308,
+    GPIO_PD4 = 0x310, GPIO_PD5 = 0x320, GPIO_PD6 = 0x340, GPIO_PD7 = 0x380,
+    GPIO_PE0 = 0x401, GPIO_PE1 = 0x402, GPIO_PE2 = 0x404, GPIO_PE3 = 0x408,
+    GPIO_PE4 = 0x410, GPIO_PE5 = 0x420, GPIO_PE6 = 0x440, GPIO_PE7 = 0x480,
+    GPIO_PF0 = 0x501, GPIO_PF1 = 0x502, GPIO_PF2 = 0x504, GPIO_PF3 = 0x508,
+} gpio_pin_e;
+
+typedef enum {
+    INTR_RISING_EDGE = 0,
+    INTR_FALLING_EDGE,
+    INTR_HIGH_LEVEL,
+    INTR_LOW_LEVEL,
+} gpio_irq_trigger_type_e;
+
+#define FLD_GPIO_IRQ_CLR 0x01
+
+_Bool gpio_get_level(gpio_pin_e pin);
+void gpio_set_level(gpio_pin_e pin, unsigned char value);
+void gpio_function_en(gpio_pin_e pin);
+void gpio_input_en(gpio_pin_e pin);
+void gpio_input_dis(gpio_pin_e pin);
+void gpio_output_en(gpio_pin_e pin);
+void gpio_output_dis(gpio_pin_e pin);
+_Bool gpio_is_input_en(gpio_pin_e pin);
+_Bool gpio_is_output_en(gpio_pin_e pin);
+void gpio_set_irq(gpio_pin_e pin, gpio_irq_trigger_type_e trigger_type);
+void gpio_irq_en(gpio_pin_e pin);
+void gpio_irq_dis(gpio_pin_e pin);
+void gpio_clr_irq_status(unsigned int status);
+
+#endif /* HOST_TEST_GPIO_H */
@@ -0,0 +1,29 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_B91_IRQ_H
+#define HOST_TEST_B91_IRQ_H
+
+#define IRQ25_GPIO 25
+
+typedef void (*HWI_PROC_FUNC)(void);
+
+void B91IrqRegister(unsigned int irq, HWI_PROC_FUNC handler, unsigned int arg);
+void plic_interrupt_enable(unsigned int irq);
+
+#endif /* HOST_TEST_B91_IRQ_H */
@@ -0,0 +1,36 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_DEVICE_RESOURCE_IF_H
+#define HOST_TEST_DEVICE_RESOURCE_IF_H
+
+#include <stdint.h>
+
+#define HDF_CONFIG_SOURCE 0
+
+struct DeviceResourceNode;
+
+struct DeviceResourceIface {
+    int32_t (*GetUint8)(const struct DeviceResourceNode *node, const char *attrName, uint8_t *value, uint8_t def);
+    int32_t (*GetUint32ArrayElem)(const struct DeviceResourceNode *node, const char *attrName, uint32_t index,
+                                  uint32_t *value, uint32_t def);
+};
+
+struct DeviceResourceIface *DeviceResourceGetIfaceInstance(int type);
+
+#endif /* HOST_TEST_DEVICE_RESOURCE_IF_H */
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_GPIO_CORE_H
+#define HOST_TEST_GPIO_CORE_H
+
+#include <stdint.h>
+
+#include "hdf_device_desc.h"
+
+#define GPIO_VAL_LOW  0
+#define GPIO_VAL_HIGH 1
+
+#define GPIO_DIR_IN  0
+#define GPIO_DIR_OUT 1
+#define GPIO_DIR_ERR 2
+
+#define GPIO_IRQ_TRIGGER_RISING  1
+#define GPIO_IRQ_TRIGGER_FALLING 2
+#define GPIO_IRQ_TRIGGER_HIGH    4
+#define GPIO_IRQ_TRIGGER_LOW     8
+
+struct PlatformDevice {
+    struct HdfDeviceObject *hdfDev;
+};
+
+struct GpioCntlr;
+
+struct GpioMethod {
+    int32_t (*request)(struct GpioCntlr *cntlr, uint16_t local);
+    int32_t (*release)(struct GpioCntlr *cntlr, uint16_t local);
+    int32_t (*write)(struct GpioCntlr *cntlr, uint16_t local, uint16_t val);
+    int32_t (*read)(struct GpioCntlr *cntlr, uint16_t local, uint16_t *val);
+    int32_t (*setDir)(struct GpioCntlr *cntlr, uint16_t local, uint16_t dir);
+    int32_t (*getDir)(struct GpioCntlr *cntlr, uint16_t local, uint16_t *dir);
+    int32_t (*toIrq)(struct GpioCntlr *cntlr, uint16_t local, uint16_t *irq);
+    int32_t (*setIrq)(struct GpioCntlr *cntlr, uint16_t local, uint16_t mode);
+    int32_t (*unsetIrq)(struct GpioCntlr *cntlr, uint16_t local);
+    int32_t (*enableIrq)(struct GpioCntlr *cntlr, uint16_t local);
+    int32_t (*disableIrq)(struct GpioCntlr *cntlr, uint16_t local);
+};
+
+struct GpioCntlr {
+    struct PlatformDevice device;
+    uint16_t count;
+    void *priv;
+    struct GpioMethod *ops;
+};
+
+int32_t PlatformDeviceBind(struct PlatformDevice *device, struct HdfDeviceObject *hdfDevice);
+int32_t GpioCntlrAdd(struct GpioCntlr *cntlr);
+void GpioCntlrRemove(struct GpioCntlr *cntlr);
+struct GpioCntlr *GpioCntlrFromHdfDev(const struct HdfDeviceObject *device);
+void GpioCntlrIrqCallback(struct GpioCntlr *cntlr, uint16_t local);
+
+#endif /* HOST_TEST_GPIO_CORE_H */
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_HDF_DEVICE_DESC_H
+#define HOST_TEST_HDF_DEVICE_DESC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HDF_SUCCESS              0
+#define HDF_FAILURE              (-1)
+#define HDF_ERR_NOT_SUPPORT      (-2)
+#define HDF_ERR_INVALID_PARAM    (-3)
+#define HDF_ERR_INVALID_OBJECT   (-4)
+#define HDF_ERR_MALLOC_FAIL      (-6)
+#define HDF_ERR_DEVICE_BUSY      (-10)
+#define HDF_ERR_BSP_PLT_API_ERR  (-101)
+
+#define HDF_LOGD(...) ((void)0)
+#define HDF_LOGE(...) ((void)0)
+
+struct DeviceResourceNode;
+
+struct HdfDeviceObject {
+    const struct DeviceResourceNode *property;
+};
+
+struct HdfDriverEntry {
+    int32_t moduleVersion;
+    const char *moduleName;
+    int32_t (*Bind)(struct HdfDeviceObject *deviceObject);
+    int32_t (*Init)(struct HdfDeviceObject *deviceObject);
+    void (*Release)(struct HdfDeviceObject *deviceObject);
+};
+
+#define HDF_INIT(module) struct HdfDriverEntry *g_hostTestEntry = &(module)
+
+const char *HdfDeviceGetServiceName(const struct HdfDeviceObject *deviceObject);
+
+#endif /* HOST_TEST_HDF_DEVICE_DESC_H */
@@ -0,0 +1,39 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_OSAL_H
+#define HOST_TEST_OSAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void (*OsalTimerFunc)(uintptr_t arg);
+
+typedef struct {
+    void *realTimer;
+} OsalTimer;
+
+void *OsalMemAlloc(size_t size);
+void *OsalMemCalloc(size_t size);
+void OsalMemFree(void *mem);
+
+int32_t OsalTimerCreate(OsalTimer *timer, uint32_t interval, OsalTimerFunc func, uintptr_t arg);
+int32_t OsalTimerStartOnce(OsalTimer *timer);
+int32_t OsalTimerDelete(OsalTimer *timer);
+
+#endif /* HOST_TEST_OSAL_H */
@@ -0,0 +1,40 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_LOS_INTERRUPT_H
+#define HOST_TEST_LOS_INTERRUPT_H
+
+#include <stdint.h>
+
+/* host tests are single threaded, the lock only has to be balanced */
+
+typedef uint32_t UINT32;
+
+extern int g_losIntLocked;
+
+static inline UINT32 LOS_IntLock(void)
+{
+    return (UINT32)g_losIntLocked++;
+}
+
+static inline void LOS_IntRestore(UINT32 intSave)
+{
+    g_losIntLocked = (int)intSave;
+}
+
+#endif /* HOST_TEST_LOS_INTERRUPT_H */
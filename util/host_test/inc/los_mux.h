@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_LOS_MUX_H
+#define HOST_TEST_LOS_MUX_H
+
+#include <stdint.h>
+
+/* host tests are single threaded, the mutex only has to succeed */
+
+#define LOS_OK           0
+#define LOS_WAIT_FOREVER 0xFFFFFFFF
+
+static inline uint32_t LOS_MuxCreate(uint32_t *muxHandle)
+{
+    *muxHandle = 0;
+    return LOS_OK;
+}
+
+static inline uint32_t LOS_MuxPend(uint32_t muxHandle, uint32_t timeout)
+{
+    (void)muxHandle;
+    (void)timeout;
+    return LOS_OK;
+}
+
+static inline uint32_t LOS_MuxPost(uint32_t muxHandle)
+{
+    (void)muxHandle;
+    return LOS_OK;
+}
+
+#endif /* HOST_TEST_LOS_MUX_H */
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_LPC_MONITOR_STUB_H
+#define HOST_TEST_LPC_MONITOR_STUB_H
+
+/*
+ * Forced in front of ext_driver/lpc_monitor.c: it takes the include guards of the headers lpc_monitor.c
+ * includes, the comparator, the delay and the wakeup registry come from the test.
+ */
+
+#define B91_B91_BLE_SDK_DRIVERS_B91_LPC_H
+#define B91_B91_BLE_SDK_DRIVERS_B91_PM_H
+#define STIMER_H_
+#define DRIVERS_B91_EXT_DRIVER_PM_WAKEUP_H_
+
+#define _attribute_data_retention_sec_
+
+#define PM_WAKEUP_COMPARATOR (1 << 6)
+
+typedef enum {
+    LPC_INPUT_PB1 = 1,
+    LPC_INPUT_PB2 = 2,
+    LPC_INPUT_PB3 = 3,
+    LPC_INPUT_PB4 = 4,
+    LPC_INPUT_PB5 = 5,
+    LPC_INPUT_PB6 = 6,
+    LPC_INPUT_PB7 = 7,
+} lpc_input_channel_e;
+
+typedef enum {
+    LPC_NORMAL = 0,
+    LPC_LOWPOWER,
+} lpc_mode_e;
+
+typedef enum {
+    LPC_REF_974MV = 1,
+    LPC_REF_923MV = 2,
+    LPC_REF_872MV = 3,
+    LPC_REF_820MV = 4,
+    LPC_REF_PB0 = 5,
+    LPC_REF_PB3 = 6,
+} lpc_reference_e;
+
+typedef enum {
+    LPC_SCALING_PER25 = 0,
+    LPC_SCALING_PER50 = 1,
+    LPC_SCALING_PER75 = 2,
+    LPC_SCALING_PER100 = 3,
+} lpc_scaling_e;
+
+typedef enum {
+    PM_WAKEUP_ID_KEYSCAN = 0,
+    PM_WAKEUP_ID_LPC,
+} pm_wakeup_id_e;
+
+typedef void (*pm_wakeup_cb_t)(unsigned int status, void *ctx);
+
+void lpc_power_down(void);
+void lpc_power_on(void);
+void lpc_set_input_chn(lpc_input_channel_e pin);
+void lpc_set_scaling_coeff(lpc_scaling_e divider);
+unsigned char lpc_get_result(void);
+void lpc_set_input_ref(lpc_mode_e mode, lpc_reference_e ref);
+void delay_us(unsigned int microsec);
+int pm_wakeup_claim(pm_wakeup_id_e id, unsigned int src, pm_wakeup_cb_t cb, void *ctx);
+void pm_wakeup_enable(pm_wakeup_id_e id, unsigned int src, int en);
+void pm_wakeup_release(pm_wakeup_id_e id);
+
+#endif /* HOST_TEST_LPC_MONITOR_STUB_H */
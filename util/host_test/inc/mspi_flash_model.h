@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_MSPI_FLASH_MODEL_H
+#define HOST_TEST_MSPI_FLASH_MODEL_H
+
+#include <stdint.h>
+
+/*
+ * A 1MB SPI NOR flash behind the MSPI, see mspi_flash_model.c. Time is virtual: every byte on the bus takes
+ * MSPI_MODEL_BYTE_NS, program and erase keep the flash busy for the times below.
+ */
+
+#define MSPI_MODEL_FLASH_SIZE   0x100000
+#define MSPI_MODEL_BYTE_NS      333
+#define MSPI_MODEL_PROGRAM_US   600
+#define MSPI_MODEL_SECTOR_US    45000
+#define MSPI_MODEL_32K_US       150000
+#define MSPI_MODEL_64K_US       250000
+#define MSPI_MODEL_CHIP_US      2000000
+#define MSPI_MODEL_STATUS_US    5000
+
+typedef struct {
+    uint32_t bytes;        /* bytes clocked on the bus */
+    uint32_t pollBytes;    /* of them status reads */
+    uint32_t commands;     /* CS low periods */
+    uint32_t programs;
+    uint32_t erases[4];    /* sector, 32K, 64K, chip */
+    uint32_t resets;       /* 0x66 0x99 sequences */
+    uint64_t irqOffNs;     /* total time with interrupts disabled */
+    uint64_t irqOffMaxNs;  /* longest time with interrupts disabled */
+} MspiModelStats;
+
+/* erase the flash, clear the stats and any fault, enable interrupts */
+void MspiModelReset(void);
+
+uint8_t *MspiModelMem(void);
+
+uint64_t MspiModelTimeNs(void);
+
+/* advance the virtual time, as if the CPU ran for that long */
+void MspiModelRun(uint64_t ns);
+
+MspiModelStats *MspiModelStatsGet(void);
+
+/* called each time interrupts get enabled, as if a pending interrupt or a task switch ran right then */
+void MspiModelIrqHookSet(void (*hook)(void));
+
+/* the next program or erase leaves the flash busy until it is reset (0x66 0x99) */
+void MspiModelStuckSet(int stuck);
+
+int MspiModelIrqEnabled(void);
+
+#endif /* HOST_TEST_MSPI_FLASH_MODEL_H */
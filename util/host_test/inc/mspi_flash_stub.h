@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_MSPI_FLASH_STUB_H
+#define HOST_TEST_MSPI_FLASH_STUB_H
+
+/*
+ * Forced in front of drivers/B91/flash.c: it takes the include guards of the headers flash.c includes besides
+ * flash.h, and mspi_flash_model.c stands in for the MSPI registers, the interrupt enable and the system timer.
+ */
+
+#define COMPILER_H_
+#define B91_B91_BLE_SDK_DRIVERS_B91_MSPI_H
+#define CORE_H
+#define INTERRUPT_H
+#define STIMER_H_
+#define SYS_H_
+#define TIMER_H_
+#define DRIVERS_B91_EXT_MISC_H_
+
+#define _attribute_ram_code_sec_
+#define _attribute_ram_code_sec_noinline_ __attribute__((noinline))
+#define _attribute_text_sec_
+#define _attribute_data_retention_sec_
+
+/* BTB control and nops */
+#define __asm__(insn)
+#define CLOCK_DLY_5_CYC
+#define CLOCK_DLY_10_CYC
+
+#define SUPPORT_PFT_ARCH       0
+#define SYSTEM_TIMER_TICK_1US  16
+
+typedef struct {
+    unsigned char preempt_en;
+    unsigned char threshold;
+} preempt_config_t;
+
+extern unsigned char g_plic_preempt_en;
+extern unsigned char g_mspiModelIrqThreshold;
+extern unsigned short g_mspiModelXipConfig;
+
+#define reg_irq_threshold   g_mspiModelIrqThreshold
+#define reg_mspi_xip_config g_mspiModelXipConfig
+
+void mspi_wait(void);
+void mspi_fm_rd_en(void);
+void mspi_fm_rd_dis(void);
+void mspi_high(void);
+void mspi_low(void);
+unsigned char mspi_get(void);
+void mspi_write(unsigned char c);
+unsigned char mspi_read(void);
+void mspi_stop_xip(void);
+
+unsigned int core_interrupt_disable(void);
+unsigned int core_restore_interrupt(unsigned int en);
+void plic_set_threshold(unsigned char threshold);
+unsigned int plic_enter_critical_sec(unsigned char preempt_en, unsigned char threshold);
+void plic_exit_critical_sec(unsigned char preempt_en, unsigned int r);
+
+unsigned int stimer_get_tick(void);
+void delay_us(unsigned int us);
+
+#endif /* HOST_TEST_MSPI_FLASH_STUB_H */
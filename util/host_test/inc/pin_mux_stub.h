@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_PIN_MUX_STUB_H
+#define HOST_TEST_PIN_MUX_STUB_H
+
+/*
+ * Forced in front of ext_driver/pin_mux.c and its test: gpio.h is replaced by the pad enum, the register map is the
+ * real gpio_reg.h on a RAM array of the test.
+ */
+
+#include <stdint.h>
+
+#include "bit.h"
+
+#define DRIVERS_GPIO_H_
+#define SYS_H_
+
+#define _attribute_data_retention_sec_
+
+#define PIN_MUX_REG_BASE 0x140300
+#define PIN_MUX_REG_SIZE 0x100
+
+extern uint8_t g_pinMuxReg[PIN_MUX_REG_SIZE];
+
+#define REG_ADDR8(a)  (*(volatile uint8_t *)&g_pinMuxReg[(a) - PIN_MUX_REG_BASE])
+#define REG_ADDR16(a) (*(volatile uint16_t *)&g_pinMuxReg[(a) - PIN_MUX_REG_BASE])
+#define REG_ADDR32(a) (*(volatile uint32_t *)&g_pinMuxReg[(a) - PIN_MUX_REG_BASE])
+
+typedef enum {
+    GPIO_PA0 = 0x001,
+    GPIO_PA1 = 0x002,
+    GPIO_PA2 = 0x004,
+    GPIO_PA3 = 0x008,
+    GPIO_PA4 = 0x010,
+    GPIO_PA5 = 0x020,
+    GPIO_PA6 = 0x040,
+    GPIO_PA7 = 0x080,
+    GPIO_PB0 = 0x101,
+    GPIO_PB1 = 0x102,
+    GPIO_PB2 = 0x104,
+    GPIO_PB3 = 0x108,
+    GPIO_PB4 = 0x110,
+    GPIO_PB5 = 0x120,
+    GPIO_PB6 = 0x140,
+    GPIO_PB7 = 0x180,
+    GPIO_PC0 = 0x201,
+    GPIO_PC1 = 0x202,
+    GPIO_PC2 = 0x204,
+    GPIO_PC3 = 0x208,
+    GPIO_PC4 = 0x210,
+    GPIO_PC5 = 0x220,
+    GPIO_PC6 = 0x240,
+    GPIO_PC7 = 0x280,
+    GPIO_PD0 = 0x301,
+    GPIO_PD1 = 0x302,
+    GPIO_PD2 = 0x304,
+    GPIO_PD3 = 0x308,
+    GPIO_PD4 = 0x310,
+    GPIO_PD5 = 0x320,
+    GPIO_PD6 = 0x340,
+    GPIO_PD7 = 0x380,
+    GPIO_PE0 = 0x401,
+    GPIO_PE1 = 0x402,
+    GPIO_PE2 = 0x404,
+    GPIO_PE3 = 0x408,
+    GPIO_PE4 = 0x410,
+    GPIO_PE5 = 0x420,
+    GPIO_PE6 = 0x440,
+    GPIO_PE7 = 0x480,
+    GPIO_PF0 = 0x501,
+    GPIO_PF1 = 0x502,
+    GPIO_PF2 = 0x504,
+    GPIO_PF3 = 0x508,
+    GPIO_PF4 = 0x510,
+    GPIO_PF5 = 0x520,
+    GPIO_PF6 = 0x540,
+    GPIO_PF7 = 0x580,
+} gpio_pin_e;
+
+#include "reg_include/gpio_reg.h"
+
+#endif /* HOST_TEST_PIN_MUX_STUB_H */
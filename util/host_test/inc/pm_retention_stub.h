@@ -0,0 +1,36 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_PM_RETENTION_STUB_H
+#define HOST_TEST_PM_RETENTION_STUB_H
+
+/*
+ * Forced in front of ext_driver/pm_retention.c: it takes the include guards of compiler.h and stimer.h, the system
+ * timer comes from the test.
+ */
+
+#define COMPILER_H_
+#define STIMER_H_
+
+#define BIT(n) (1 << (n))
+
+#define _attribute_data_retention_sec_
+
+unsigned int stimer_get_tick(void);
+
+#endif /* HOST_TEST_PM_RETENTION_STUB_H */
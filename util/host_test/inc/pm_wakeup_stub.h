@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_PM_WAKEUP_STUB_H
+#define HOST_TEST_PM_WAKEUP_STUB_H
+
+/*
+ * Forced in front of ext_driver/pm_wakeup.c and its test: it takes the include guards of the headers pm_wakeup.h
+ * includes, the pad wakeup setting, the wakeup status and cpu_sleep_wakeup come from the test.
+ */
+
+#define DRIVERS_GPIO_H_
+#define B91_B91_BLE_SDK_DRIVERS_B91_PM_H
+#define DRIVERS_B91_DRIVER_EXT_EXT_PM_H_
+
+#define _attribute_data_retention_sec_
+
+typedef unsigned int gpio_pin_e;
+
+typedef enum {
+    WAKEUP_LEVEL_LOW = 0,
+    WAKEUP_LEVEL_HIGH = 1,
+} pm_gpio_wakeup_level_e;
+
+typedef enum {
+    SUSPEND_MODE = 0x00,
+} SleepMode_TypeDef;
+
+typedef enum {
+    PM_WAKEUP_PAD = 1 << 3,
+    PM_WAKEUP_CORE = 1 << 4,
+    PM_WAKEUP_TIMER = 1 << 5,
+    PM_WAKEUP_COMPARATOR = 1 << 6,
+    PM_WAKEUP_MDEC = 1 << 7,
+} SleepWakeupSrc_TypeDef;
+
+typedef enum {
+    WAKEUP_STATUS_COMPARATOR = 1 << 0,
+    WAKEUP_STATUS_TIMER = 1 << 1,
+    WAKEUP_STATUS_CORE = 1 << 2,
+    WAKEUP_STATUS_PAD = 1 << 3,
+    WAKEUP_STATUS_MDEC = 1 << 4,
+} pm_wakeup_status_e;
+
+typedef int (*cpu_pm_handler_t)(SleepMode_TypeDef sleep_mode, SleepWakeupSrc_TypeDef wakeup_src,
+                                unsigned int wakeup_tick);
+
+extern cpu_pm_handler_t cpu_sleep_wakeup;
+
+unsigned int pm_get_wakeup_src(void);
+void pm_set_gpio_wakeup(gpio_pin_e pin, pm_gpio_wakeup_level_e pol, int en);
+
+#endif /* HOST_TEST_PM_WAKEUP_STUB_H */
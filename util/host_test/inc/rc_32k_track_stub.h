@@ -0,0 +1,56 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_RC_32K_TRACK_STUB_H
+#define HOST_TEST_RC_32K_TRACK_STUB_H
+
+/*
+ * Forced in front of ext_driver/rc_32k_track.c: it takes the include guards of the headers rc_32k_track.c
+ * includes, the 32k timer, the system timer and the sleep hook registry come from the test.
+ */
+
+#define CLOCK_H_
+#define CORE_H
+#define STIMER_H_
+#define DRIVERS_B91_EXT_DRIVER_PM_WAKEUP_H_
+
+#define _attribute_data_retention_sec_
+
+#define SYSTEM_TIMER_TICK_1US 16
+#define PM_WAKEUP_TIMER       (1 << 5)
+
+typedef enum {
+    CLK_32K_RC = 0,
+    CLK_32K_XTAL = 1,
+} clk_32k_type_e;
+
+typedef unsigned int SleepMode_TypeDef;
+typedef unsigned int SleepWakeupSrc_TypeDef;
+
+typedef unsigned int (*pm_wakeup_sleep_hook_t)(SleepMode_TypeDef sleep_mode, SleepWakeupSrc_TypeDef wakeup_src,
+                                               unsigned int wakeup_tick);
+
+extern clk_32k_type_e g_clk_32k_src;
+
+unsigned int clock_get_32k_tick(void);
+unsigned int stimer_get_tick(void);
+unsigned int core_interrupt_disable(void);
+unsigned int core_restore_interrupt(unsigned int en);
+int pm_wakeup_add_sleep_hook(pm_wakeup_sleep_hook_t hook);
+
+#endif /* HOST_TEST_RC_32K_TRACK_STUB_H */
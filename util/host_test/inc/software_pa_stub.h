@@ -0,0 +1,75 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TEST_SOFTWARE_PA_STUB_H
+#define HOST_TEST_SOFTWARE_PA_STUB_H
+
+/*
+ * Forced in front of ext_driver/software_pa.c: it takes the include guards of compiler.h, gpio.h and rf.h, which
+ * software_pa.c includes by relative path, and puts the GPIO registers in a RAM array.
+ */
+
+#define COMPILER_H_
+#define DRIVERS_GPIO_H_
+#define RF_H
+
+#define BIT(n) (1 << (n))
+
+#define _attribute_data_retention_
+#define _attribute_ram_code_
+
+#define GPIO_REG_BASE 0x140300
+#define GPIO_REG_SIZE 0x30
+
+extern unsigned char g_gpioReg[GPIO_REG_SIZE];
+
+#define REG_ADDR8(a)  (*(volatile unsigned char *)&g_gpioReg[(a) - GPIO_REG_BASE])
+#define REG_ADDR16(a) (*(volatile unsigned short *)&g_gpioReg[(a) - GPIO_REG_BASE])
+
+#define GPIO_PORT_PINS(port, group)                                                                           \
+    GPIO_##port##0 = (group) | BIT(0), GPIO_##port##1 = (group) | BIT(1), GPIO_##port##2 = (group) | BIT(2),   \
+    GPIO_##port##3 = (group) | BIT(3), GPIO_##port##4 = (group) | BIT(4), GPIO_##port##5 = (group) | BIT(5),   \
+    GPIO_##port##6 = (group) | BIT(6), GPIO_##port##7 = (group) | BIT(7)
+
+typedef enum {
+    GPIO_PORT_PINS(PA, 0x000),
+    GPIO_PORT_PINS(PB, 0x100),
+    GPIO_PORT_PINS(PC, 0x200),
+    GPIO_PORT_PINS(PD, 0x300),
+    GPIO_PORT_PINS(PE, 0x400),
+} gpio_pin_e;
+
+typedef enum {
+    AS_GPIO,
+} gpio_func_e;
+
+typedef enum {
+    RF_RFFE_TX_PB0 = GPIO_PB0,
+} rf_pa_tx_pin_e;
+
+typedef enum {
+    RF_RFFE_RX_PB1 = GPIO_PB1,
+} rf_lna_rx_pin_e;
+
+/* the per pin calls of rf_pa_init, implemented by the test as the gpio.h inline functions */
+void gpio_set_func(gpio_pin_e pin, gpio_func_e func);
+void gpio_set_output_en(gpio_pin_e pin, unsigned int value);
+void gpio_write(gpio_pin_e pin, unsigned int value);
+void rf_set_rffe_pin(rf_pa_tx_pin_e tx_pin, rf_lna_rx_pin_e rx_pin);
+
+#endif /* HOST_TEST_SOFTWARE_PA_STUB_H */
@@ -0,0 +1,325 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of the AES-XTS layer of liteos_m/src/littlefs_hal.c on the flash model and a software AES:
+ * the IEEE 1619 vector with zero keys and a reference data unit, round trips of 16 byte aligned programs and
+ * reads against a plain copy, erased ranges, the key record across remounts and on another flash, and the
+ * AES blocks per data unit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <B91/aes.h>
+#include <B91/flash.h>
+#include <B91/trng.h>
+#include <lfs.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+/* littlefs_hal.c layout */
+#define PHYS_ADDR  0x60000
+#define BLOCK_SIZE 4096
+#define UNIT_SIZE  256
+
+struct lfs_config *LittlefsConfigGet(void);
+
+int g_losIntLocked;
+
+static uint32_t g_rand = 1;
+static int g_trngZero;
+static int g_uidOk = 1;
+static uint8_t g_uid[16] = "host flash uid 0";
+static uint8_t g_plain[BLOCK_SIZE];
+static uint8_t g_buf[BLOCK_SIZE];
+
+static uint32_t Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+void trng_init(void)
+{
+}
+
+int trng_rand(void)
+{
+    return g_trngZero ? 0 : (int)(Rand() ^ (Rand() << 16));
+}
+
+int flash_read_mid_uid_with_check(unsigned int *flash_mid, unsigned char *flash_uid)
+{
+    *flash_mid = 0x146085;
+    (void)memcpy(flash_uid, g_uid, sizeof(g_uid));
+    return g_uidOk;
+}
+
+static struct lfs_config *Mount(void)
+{
+    struct lfs_config *cfg = LittlefsConfigGet();
+
+    CHECK(g_losIntLocked == 0);
+    return cfg;
+}
+
+static void Prog(struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, const uint8_t *buf, lfs_size_t size)
+{
+    CHECK(cfg->prog(cfg, block, off, buf, size) == LFS_ERR_OK);
+    CHECK(g_losIntLocked == 0);
+}
+
+static void Read(struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, uint8_t *buf, lfs_size_t size)
+{
+    CHECK(cfg->read(cfg, block, off, buf, size) == LFS_ERR_OK);
+    CHECK(g_losIntLocked == 0);
+}
+
+/* FIPS-197 appendix C.1, the model has to be AES before anything is built on it */
+static void TestAesModel(void)
+{
+    uint8_t key[16];
+    uint8_t plain[16];
+    uint8_t out[16];
+    static const uint8_t cipher[16] = { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+                                        0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+
+    for (int i = 0; i < 16; i++) {
+        key[i] = (uint8_t)i;
+        plain[i] = (uint8_t)(i * 0x11);
+    }
+    (void)aes_encrypt(key, plain, out);
+    CHECK(memcmp(out, cipher, sizeof(out)) == 0);
+    (void)aes_decrypt(key, out, out);
+    CHECK(memcmp(out, plain, sizeof(out)) == 0);
+}
+
+/* IEEE 1619 on two 64 bit halves, for whole data units the vectors are too short to cover */
+static void ReferenceXts(uint8_t *key, uint32_t unit, const uint8_t *in, uint8_t *out)
+{
+    uint8_t tweak[16] = {0};
+    uint8_t block[16];
+    uint64_t lo;
+    uint64_t hi;
+    uint64_t carry;
+
+    (void)memcpy(tweak, &unit, sizeof(unit));
+    (void)aes_encrypt(key, tweak, tweak);
+    for (uint32_t off = 0; off < UNIT_SIZE; off += 16) {
+        for (int i = 0; i < 16; i++) {
+            block[i] = in[off + i] ^ tweak[i];
+        }
+        (void)aes_encrypt(key, block, block);
+        for (int i = 0; i < 16; i++) {
+            out[off + i] = block[i] ^ tweak[i];
+        }
+        (void)memcpy(&lo, tweak, 8);
+        (void)memcpy(&hi, tweak + 8, 8);
+        carry = hi >> 63;
+        hi = (hi << 1) | (lo >> 63);
+        lo = (lo << 1) ^ (carry ? 0x87 : 0);
+        (void)memcpy(tweak, &lo, 8);
+        (void)memcpy(tweak + 8, &hi, 8);
+    }
+}
+
+/* IEEE 1619 XTS-AES-128 vector 1: both keys zero, data unit 0, 32 zero bytes */
+static void TestVector(void)
+{
+    static const uint8_t cipher[32] = { 0x91, 0x7c, 0xf6, 0x9e, 0xbd, 0x68, 0xb2, 0xec, 0x9b, 0x9f, 0xe9,
+                                        0xa3, 0xea, 0xdd, 0xa6, 0x92, 0xcd, 0x43, 0xd2, 0xf5, 0x95, 0x98,
+                                        0xed, 0x85, 0x8c, 0x02, 0xc2, 0x65, 0x2f, 0xbf, 0x92, 0x2e };
+    struct lfs_config *cfg;
+    uint8_t zero[32] = {0};
+    uint8_t key[16] = {0};
+
+    flash_model_reset();
+    g_trngZero = 1;
+    cfg = Mount();
+    g_trngZero = 0;
+    CHECK(cfg != NULL);
+    /* the key block is not handed to littlefs */
+    CHECK(cfg->block_count == 31);
+
+    Prog(cfg, 0, 0, zero, sizeof(zero));
+    flash_read_page(PHYS_ADDR, sizeof(g_buf), g_buf);
+    CHECK(memcmp(g_buf, cipher, sizeof(cipher)) == 0);
+    Read(cfg, 0, 0, g_buf, sizeof(zero));
+    CHECK(memcmp(g_buf, zero, sizeof(zero)) == 0);
+
+    /* a whole data unit further in, against the reference */
+    for (int i = 0; i < UNIT_SIZE; i++) {
+        g_plain[i] = (uint8_t)Rand();
+    }
+    Prog(cfg, 2, 3 * UNIT_SIZE, g_plain, UNIT_SIZE);
+    flash_read_page(PHYS_ADDR + 2 * BLOCK_SIZE + 3 * UNIT_SIZE, UNIT_SIZE, g_buf);
+    ReferenceXts(key, (2 * BLOCK_SIZE + 3 * UNIT_SIZE) / UNIT_SIZE, g_plain, &g_plain[UNIT_SIZE]);
+    CHECK(memcmp(g_buf, &g_plain[UNIT_SIZE], UNIT_SIZE) == 0);
+}
+
+/* programs of random 16 byte multiples one after the other like littlefs does, reads of random ranges */
+static uint32_t FillBlock(struct lfs_config *cfg, lfs_block_t block)
+{
+    uint32_t off = 0;
+    uint32_t len;
+
+    memset(g_plain, 0xFF, sizeof(g_plain));
+    while (off < BLOCK_SIZE - 1024) {
+        len = 16 * (1 + Rand() % 40);
+        for (uint32_t i = 0; i < len; i++) {
+            /* runs of 0xFF and repeated data must be encrypted too */
+            g_plain[off + i] = (Rand() % 4 == 0) ? 0xFF : (Rand() % 3 == 0) ? 0x55 : (uint8_t)Rand();
+        }
+        Prog(cfg, block, off, &g_plain[off], len);
+        off += len;
+    }
+
+    return off;
+}
+
+static void CheckBlock(struct lfs_config *cfg, lfs_block_t block)
+{
+    uint32_t off;
+    uint32_t len;
+
+    Read(cfg, block, 0, g_buf, BLOCK_SIZE);
+    CHECK(memcmp(g_buf, g_plain, BLOCK_SIZE) == 0);
+
+    for (int i = 0; i < 300; i++) {
+        off = 16 * (Rand() % (BLOCK_SIZE / 16));
+        len = 16 * (1 + Rand() % ((BLOCK_SIZE - off) / 16));
+        memset(g_buf, 0, sizeof(g_buf));
+        Read(cfg, block, off, g_buf, len);
+        CHECK(memcmp(g_buf, &g_plain[off], len) == 0);
+    }
+}
+
+static void TestRoundTrip(void)
+{
+    static const uint8_t same[16] = "same plaintext!";
+    uint8_t raw[2][16];
+    struct lfs_config *cfg;
+    uint32_t written;
+
+    flash_model_reset();
+    cfg = Mount();
+    CHECK(cfg != NULL);
+
+    written = FillBlock(cfg, 3);
+    CheckBlock(cfg, 3);
+
+    /* no written block is stored in plain, the tail stays erased */
+    flash_read_page(PHYS_ADDR + 3 * BLOCK_SIZE, BLOCK_SIZE, g_buf);
+    for (uint32_t off = 0; off < BLOCK_SIZE; off += 16) {
+        CHECK((off < written) == (memcmp(&g_buf[off], &g_plain[off], 16) != 0));
+    }
+
+    /* the same plaintext in two data units, and at two blocks of one unit, gives different ciphertext */
+    Prog(cfg, 5, 0, same, sizeof(same));
+    Prog(cfg, 5, UNIT_SIZE, same, sizeof(same));
+    Prog(cfg, 5, UNIT_SIZE + 16, same, sizeof(same));
+    flash_read_page(PHYS_ADDR + 5 * BLOCK_SIZE, 16, raw[0]);
+    flash_read_page(PHYS_ADDR + 5 * BLOCK_SIZE + UNIT_SIZE, 16, raw[1]);
+    CHECK(memcmp(raw[0], raw[1], 16) != 0);
+    flash_read_page(PHYS_ADDR + 5 * BLOCK_SIZE + UNIT_SIZE + 16, 16, raw[0]);
+    CHECK(memcmp(raw[0], raw[1], 16) != 0);
+
+    /* an erase reads back as erased */
+    CHECK(cfg->erase(cfg, 3) == LFS_ERR_OK);
+    Read(cfg, 3, 0, g_buf, BLOCK_SIZE);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        CHECK(g_buf[i] == 0xFF);
+    }
+}
+
+/* the keys are created once, a remount reads the data back, another flash UID or none does not mount */
+static void TestKeys(void)
+{
+    struct lfs_config *cfg;
+
+    flash_model_reset();
+    cfg = Mount();
+    CHECK(cfg != NULL);
+    FillBlock(cfg, 7);
+
+    cfg = Mount();
+    CHECK(cfg != NULL);
+    CheckBlock(cfg, 7);
+
+    g_uid[0] ^= 1;
+    CHECK(Mount() == NULL);
+    g_uid[0] ^= 1;
+
+    g_uidOk = 0;
+    CHECK(Mount() == NULL);
+    g_uidOk = 1;
+
+    cfg = Mount();
+    CHECK(cfg != NULL);
+    CheckBlock(cfg, 7);
+}
+
+/* one tweak and sixteen data blocks per 256 byte unit, the host time is only indicative */
+static void Benchmark(void)
+{
+    struct lfs_config *cfg;
+    unsigned int blocks;
+    struct timespec start;
+    struct timespec end;
+    double ms;
+
+    flash_model_reset();
+    cfg = Mount();
+    CHECK(cfg != NULL);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        g_plain[i] = (uint8_t)Rand();
+    }
+
+    blocks = aes_model_block_count();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    Prog(cfg, 1, 0, g_plain, BLOCK_SIZE);
+    Read(cfg, 1, 0, g_buf, BLOCK_SIZE);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    blocks = aes_model_block_count() - blocks;
+    CHECK(memcmp(g_buf, g_plain, BLOCK_SIZE) == 0);
+
+    ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    printf("littlefs_xts_test: 4096 byte program and read, %u AES blocks, %.2f ms on the host model\n", blocks, ms);
+    CHECK(blocks == 2 * (BLOCK_SIZE / UNIT_SIZE) * (1 + UNIT_SIZE / 16));
+}
+
+int main(void)
+{
+    TestAesModel();
+    TestVector();
+    TestRoundTrip();
+    TestKeys();
+    Benchmark();
+    printf("littlefs_xts_test: ok\n");
+
+    return 0;
+}
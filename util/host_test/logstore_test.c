@@ -0,0 +1,255 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of liteos_m/src/logstore.c on the flash model: line round trip, truncation of long lines,
+ * wrap around the sector ring, and power loss at every byte of a page program followed by a rescan.
+ * Also prints lines per second on the host and the pages and erases per MB of hilog sized lines.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <B91/flash.h>
+
+#include <logstore.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define LINE_BUF_SIZE 512
+#define BENCH_BYTES   (1024 * 1024)
+
+typedef struct {
+    uint32_t next;  /* next expected sequence number */
+    uint32_t lines; /* lines reported */
+    uint32_t bad;   /* lines whose text does not match their sequence number */
+} ReadState;
+
+/* the text of a line only depends on its sequence number, so a rescan that reuses numbers stays checkable */
+static uint32_t LineMake(uint32_t seq, char *buf)
+{
+    uint32_t len = 1 + (seq * 7) % 60;
+
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = (char)('a' + (seq + i) % 26);
+    }
+
+    return len;
+}
+
+static int ReadCheck(uint32_t seq, const char *line, uint32_t len, void *arg)
+{
+    ReadState *state = arg;
+    char expect[LINE_BUF_SIZE];
+    uint32_t expectLen = LineMake(seq, expect);
+
+    if ((seq != state->next) || (len != expectLen) || memcmp(line, expect, len)) {
+        state->bad++;
+    }
+    state->next = seq + 1;
+    state->lines++;
+
+    return 0;
+}
+
+static void Append(uint32_t count)
+{
+    char buf[LINE_BUF_SIZE];
+
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK(LogStoreAppend(buf, LineMake(LogStoreNextSeq(), buf)) == 0);
+    }
+}
+
+/* every stored line from the oldest one on is reported once, in order, with the right text */
+static void CheckStored(uint32_t expectNext)
+{
+    ReadState state = { LogStoreFirstSeq(), 0, 0 };
+
+    CHECK(LogStoreRead(0, ReadCheck, &state) == 0);
+    CHECK(state.bad == 0);
+    CHECK(state.next == expectNext);
+    CHECK(state.lines == expectNext - LogStoreFirstSeq());
+}
+
+static void TestRoundTrip(void)
+{
+    flash_model_reset();
+    CHECK(LogStoreInit() == 0);
+    CHECK(LogStoreFirstSeq() == 0);
+    CHECK(LogStoreNextSeq() == 0);
+
+    Append(100);
+    CHECK(LogStoreFlush() == 0);
+    CheckStored(100);
+
+    /* the same lines are found after a reboot */
+    CHECK(LogStoreInit() == 0);
+    CHECK(LogStoreNextSeq() == 100);
+    CheckStored(100);
+}
+
+static int ReadOne(uint32_t seq, const char *line, uint32_t len, void *arg)
+{
+    char *out = arg;
+
+    (void)seq;
+    memcpy(out, line, len);
+    out[len] = 0;
+
+    return 1;
+}
+
+static void TestLongLine(void)
+{
+    char line[300];
+    char out[LINE_BUF_SIZE];
+    LogStoreStats before;
+    LogStoreStats after;
+
+    for (uint32_t i = 0; i < sizeof(line); i++) {
+        line[i] = (char)('A' + i % 26);
+    }
+
+    flash_model_reset();
+    CHECK(LogStoreInit() == 0);
+    LogStoreGetStats(&before);
+
+    /* a line of exactly LOGSTORE_LINE_MAX fills a page on its own */
+    CHECK(LogStoreAppend(line, LOGSTORE_LINE_MAX) == 0);
+    CHECK(LogStoreAppend(line, sizeof(line)) == 0);
+    CHECK(LogStoreFlush() == 0);
+    LogStoreGetStats(&after);
+    CHECK(after.pages - before.pages == 2);
+    CHECK(after.lost - before.lost == 1);
+
+    CHECK(LogStoreRead(1, ReadOne, out) == 0);
+    CHECK(strlen(out) == LOGSTORE_LINE_MAX);
+    CHECK(memcmp(out, line, LOGSTORE_LINE_MAX) == 0);
+}
+
+static void TestWrap(void)
+{
+    LogStoreStats before;
+    LogStoreStats after;
+
+    flash_model_reset();
+    CHECK(LogStoreInit() == 0);
+    LogStoreGetStats(&before);
+
+    /* about 7 lines per page, three times around the ring */
+    Append(LOGSTORE_SECTOR_NUM * (LOGSTORE_SECTOR_SIZE / LOGSTORE_PAGE_SIZE) * 7 * 3);
+    CHECK(LogStoreFlush() == 0);
+    LogStoreGetStats(&after);
+    CHECK(after.erases - before.erases > 2 * LOGSTORE_SECTOR_NUM);
+    CHECK(LogStoreFirstSeq() != 0);
+    CheckStored(LogStoreNextSeq());
+
+    CHECK(LogStoreInit() == 0);
+    CheckStored(LogStoreNextSeq());
+}
+
+/* cut the power at every byte of one page program, the store must come back with every complete page */
+static void TestPowerLoss(void)
+{
+    uint32_t stored;
+
+    for (uint32_t cut = 0; cut <= LOGSTORE_PAGE_SIZE; cut++) {
+        flash_model_reset();
+        CHECK(LogStoreInit() == 0);
+        /* leave the head sector nearly full so some cuts also land right after a sector erase */
+        Append(7 * (LOGSTORE_SECTOR_SIZE / LOGSTORE_PAGE_SIZE) - 3 + cut % 9);
+        CHECK(LogStoreFlush() == 0);
+        stored = LogStoreNextSeq();
+
+        Append(40);
+        flash_model_power_cut(cut);
+        CHECK(LogStoreFlush() == 0);
+        (void)flash_model_power_on();
+
+        CHECK(LogStoreInit() == 0);
+        CHECK(LogStoreNextSeq() >= stored);
+        CheckStored(LogStoreNextSeq());
+
+        /* appending after the torn page continues the sequence */
+        Append(200);
+        CHECK(LogStoreFlush() == 0);
+        CheckStored(LogStoreNextSeq());
+        CHECK(LogStoreInit() == 0);
+        CheckStored(LogStoreNextSeq());
+    }
+}
+
+/* 1 MB of lines of 30 ~ 129 bytes, like "01-01 00:00:12.345 I 01500/hiview: ..." */
+static void Benchmark(void)
+{
+    char buf[LINE_BUF_SIZE];
+    LogStoreStats before;
+    LogStoreStats after;
+    struct timespec start;
+    struct timespec end;
+    uint32_t bytes = 0;
+    uint32_t lines = 0;
+    double sec;
+
+    flash_model_reset();
+    CHECK(LogStoreInit() == 0);
+    LogStoreGetStats(&before);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (bytes < BENCH_BYTES) {
+        uint32_t len = 30 + (lines * 37) % 100;
+        for (uint32_t i = 0; i < len; i++) {
+            buf[i] = (char)(' ' + (lines + i) % 90);
+        }
+        CHECK(LogStoreAppend(buf, len) == 0);
+        bytes += len;
+        lines++;
+    }
+    CHECK(LogStoreFlush() == 0);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    LogStoreGetStats(&after);
+
+    sec = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("logstore_test: %u lines, %.0f lines/s on the host, %u pages and %u erases per MB\n", lines, lines / sec,
+           after.pages - before.pages, after.erases - before.erases);
+
+    /* one erase per sector of chunks, a page holds about 2 lines of up to 129 bytes */
+    CHECK(after.lost == before.lost);
+    CHECK(after.erases - before.erases <=
+          (after.pages - before.pages) / (LOGSTORE_SECTOR_SIZE / LOGSTORE_PAGE_SIZE) + 1);
+}
+
+int main(void)
+{
+    TestRoundTrip();
+    TestLongLine();
+    TestWrap();
+    TestPowerLoss();
+    Benchmark();
+    printf("logstore_test: ok\n");
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of ext_driver/lpc_monitor.c on a model of the low power comparator: the output is high while the
+ * scaled input is below the reference, and it follows a reference or scaling change only after it has settled.
+ * A battery is cycled through the thresholds with load noise, the callbacks must follow the hysteresis and the
+ * comparator may only wake the chip at a falling crossing. The charge of the monitor is compared with waking up
+ * periodically to sample the SAR ADC.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <lpc_monitor.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define MODEL_SETTLE_US 15 /* output follows a reference or scaling change after this */
+#define LOW_MV          1700
+#define HIGH_MV         1900
+#define LOW_LEVEL_MV    1640
+#define HIGH_LEVEL_MV   1948
+#define STEP_US         1000000 /* timer wakeup of the application */
+#define STEPS           (48 * 3600)
+
+/* charge assumptions, measure them on the board before relying on the comparison */
+#define WAKE_NC     1200 /* wake from suspend, run and suspend again: 400 us at 3 mA */
+#define ADC_NC      600  /* SAR ADC power up, settling and 8 samples: 150 us at 4 mA */
+#define LPC_NA      1000 /* comparator in low power mode */
+
+static int g_vin[8]; /* mV per channel */
+static int g_chn;
+static int g_scaling = LPC_SCALING_PER100;
+static int g_ref = LPC_REF_974MV;
+static int g_power;
+static unsigned char g_out;
+static uint64_t g_timeUs;
+static uint64_t g_changeUs;
+static uint32_t g_reads;
+static int g_claimed;
+static int g_claimFail;
+static int g_wakeEn;
+static uint32_t g_rand = 1;
+
+static int g_cbNum;
+static int g_cbBelow = -1;
+
+static uint32_t Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+/* Vin * scaling < Vref */
+static unsigned char ModelOut(void)
+{
+    static const int refMv[] = {0, 974, 923, 872, 820};
+    static const int scalingPer[] = {25, 50, 75, 100};
+
+    if (!g_power) {
+        return 0;
+    }
+    return g_vin[g_chn] * scalingPer[g_scaling] < refMv[g_ref] * 100;
+}
+
+static void ModelChange(void)
+{
+    g_changeUs = g_timeUs;
+}
+
+void lpc_power_down(void)
+{
+    g_power = 0;
+}
+
+void lpc_power_on(void)
+{
+    g_power = 1;
+    ModelChange();
+}
+
+void lpc_set_input_chn(lpc_input_channel_e pin)
+{
+    g_chn = pin;
+    ModelChange();
+}
+
+void lpc_set_scaling_coeff(lpc_scaling_e divider)
+{
+    g_scaling = divider;
+    ModelChange();
+}
+
+void lpc_set_input_ref(lpc_mode_e mode, lpc_reference_e ref)
+{
+    CHECK(mode == LPC_LOWPOWER);
+    g_ref = ref;
+    ModelChange();
+}
+
+unsigned char lpc_get_result(void)
+{
+    g_reads++;
+    if (g_timeUs - g_changeUs >= MODEL_SETTLE_US) {
+        g_out = ModelOut();
+    }
+    return g_out;
+}
+
+void delay_us(unsigned int microsec)
+{
+    g_timeUs += microsec;
+}
+
+int pm_wakeup_claim(pm_wakeup_id_e id, unsigned int src, pm_wakeup_cb_t cb, void *ctx)
+{
+    CHECK(id == PM_WAKEUP_ID_LPC && src == PM_WAKEUP_COMPARATOR && !cb && !ctx);
+    if (g_claimFail || g_claimed) {
+        return -1;
+    }
+    g_claimed = 1;
+    return 0;
+}
+
+void pm_wakeup_enable(pm_wakeup_id_e id, unsigned int src, int en)
+{
+    CHECK(id == PM_WAKEUP_ID_LPC && src == PM_WAKEUP_COMPARATOR && g_claimed);
+    g_wakeEn = en;
+}
+
+void pm_wakeup_release(pm_wakeup_id_e id)
+{
+    CHECK(id == PM_WAKEUP_ID_LPC);
+    g_claimed = 0;
+    g_wakeEn = 0;
+}
+
+static void Cb(unsigned char below)
+{
+    g_cbNum++;
+    g_cbBelow = below;
+}
+
+/* bad thresholds and a taken comparator wakeup are refused */
+static void TestStart(void)
+{
+    CHECK(lpc_monitor_start(LPC_INPUT_PB1, 500, 900, Cb) == -1);
+    CHECK(lpc_monitor_start(LPC_INPUT_PB1, 1000, 900, Cb) == -1);
+    CHECK(lpc_monitor_start(LPC_INPUT_PB1, 1000, 4000, Cb) == -1);
+    CHECK(!g_claimed);
+
+    g_claimFail = 1;
+    CHECK(lpc_monitor_start(LPC_INPUT_PB1, LOW_MV, HIGH_MV, Cb) == -1);
+    g_claimFail = 0;
+}
+
+/* every input between the levels is bracketed by its neighbours in at most 5 settled comparisons (17 outcomes) */
+static void TestBracket(void)
+{
+    static const int level[] = {820,  872,  923,  974,  1093, 1162, 1230, 1298,
+                                1640, 1744, 1846, 1948, 3280, 3488, 3692, 3896};
+
+    for (int vin = 501; vin < 4200; vin += 7) {
+        unsigned short hi;
+        unsigned short lo;
+        int near = 0;
+        int expectLo = 0;
+        int expectHi = 0xffff;
+        uint32_t reads = g_reads;
+
+        for (int i = 0; i < 16; i++) {
+            near |= (vin - level[i] < 2) && (level[i] - vin < 2);
+            if (level[i] < vin) {
+                expectLo = level[i];
+            } else if (expectHi == 0xffff) {
+                expectHi = level[i];
+            }
+        }
+        if (near) {
+            continue; /* the table rounds the levels */
+        }
+
+        g_vin[LPC_INPUT_PB2] = vin;
+        lo = lpc_monitor_bracket(LPC_INPUT_PB2, &hi);
+        CHECK(lo == expectLo && hi == expectHi);
+        CHECK(g_reads - reads <= 5);
+    }
+}
+
+/*
+ * A battery cycled through the thresholds once an hour with load noise, the timer wakes up every second and
+ * the comparator when armed and the input is below its level. Returns the comparator wakeups.
+ */
+static int TestMonitor(void)
+{
+    int refBelow = 0;
+    int expectCb = 0;
+    int wakes = 0;
+    int falls = 0;
+
+    g_cbNum = 0;
+    g_vin[LPC_INPUT_PB1] = 2100;
+    CHECK(lpc_monitor_start(LPC_INPUT_PB1, LOW_MV, HIGH_MV, Cb) == 0);
+    CHECK(g_claimed && g_wakeEn);
+    CHECK(g_cbNum == 0);
+
+    for (int i = 0; i < STEPS; i++) {
+        int phase = i % 3600;
+        int level = (phase < 1800) ? 2100 - phase * 700 / 1800 : 1400 + (phase - 1800) * 700 / 1800;
+        int vin = level + (int)(Rand() % 81) - 40;
+
+        g_vin[LPC_INPUT_PB1] = vin;
+        g_timeUs += STEP_US;
+        if (g_wakeEn && ModelOut()) {
+            wakes++;
+        }
+        lpc_monitor_poll();
+
+        if (!refBelow && vin < LOW_LEVEL_MV) {
+            refBelow = 1;
+            expectCb++;
+            falls++;
+        } else if (refBelow && vin >= HIGH_LEVEL_MV) {
+            refBelow = 0;
+            expectCb++;
+        }
+        CHECK(g_cbNum == expectCb);
+        CHECK(!g_cbNum || g_cbBelow == refBelow);
+        /* armed side: the comparator claimed, waking only for the falling crossing */
+        CHECK(g_claimed && g_wakeEn == !refBelow);
+    }
+
+    CHECK(falls == STEPS / 3600);
+    CHECK(wakes == falls);
+
+    lpc_monitor_stop();
+    CHECK(!g_claimed && !g_power);
+
+    return wakes;
+}
+
+static void Energy(int wakes)
+{
+    double hours = STEPS / 3600.0;
+    double lpcNa = LPC_NA + (double)wakes * WAKE_NC / (STEPS * (STEP_US / 1e6));
+    static const int periodS[] = {1, 10, 60};
+
+    printf("lpc_monitor_test: comparator %.0f nA, %d wakeups in %.0f h\n", lpcNa, wakes, hours);
+    for (unsigned int i = 0; i < sizeof(periodS) / sizeof(periodS[0]); i++) {
+        printf("lpc_monitor_test: ADC every %d s %.0f nA\n", periodS[i], (double)(WAKE_NC + ADC_NC) / periodS[i]);
+    }
+    printf("lpc_monitor_test: break-even ADC period %.1f s\n", (double)(WAKE_NC + ADC_NC) / LPC_NA);
+}
+
+int main(void)
+{
+    int wakes;
+
+    TestStart();
+    TestBracket();
+    wakes = TestMonitor();
+    Energy(wakes);
+    printf("lpc_monitor_test: ok\n");
+
+    return 0;
+}
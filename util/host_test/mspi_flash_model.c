@@ -0,0 +1,392 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Model of the B91 MSPI with a SPI NOR flash behind it, for host builds of drivers/B91/flash.c with
+ * inc/mspi_flash_stub.h. Each byte written to the data register is clocked to the flash, which answers into the
+ * data register; CS high ends the command. Program and erase take effect at CS high and keep the flash busy,
+ * a busy flash only answers the status read and the reset sequence. Interrupt enable is a flag, the time spent
+ * with interrupts disabled is recorded.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mspi_flash_model.h>
+#include <mspi_flash_stub.h>
+
+#define STATUS_BUSY 0x01
+#define STATUS_WEL  0x02
+
+unsigned char g_plic_preempt_en;
+unsigned char g_mspiModelIrqThreshold;
+unsigned short g_mspiModelXipConfig;
+
+static uint8_t g_mem[MSPI_MODEL_FLASH_SIZE];
+static uint64_t g_nowNs;
+static MspiModelStats g_stats;
+
+/* bus */
+static int g_csLow;
+static int g_autoRead;
+static uint8_t g_dataReg;
+
+/* flash */
+static uint8_t g_cmd;
+static uint8_t g_lastCmd;
+static uint32_t g_byteNum; /* bytes of the current command, the opcode included */
+static uint32_t g_addr;
+static uint8_t g_page[256];
+static uint32_t g_pageLen;
+static int g_wel;
+static uint64_t g_busyUntilNs;
+static int g_stuck;
+static int g_stuckNext;
+
+/* interrupts */
+static int g_irqEnabled = 1;
+static uint64_t g_irqOffSinceNs;
+static void (*g_irqHook)(void);
+static int g_inIrqHook;
+
+static const uint8_t g_jedecId[3] = { 0x85, 0x60, 0x14 }; /* P25Q80U */
+static const uint8_t g_uid[16] = "mspi model uid!";
+
+static int FlashBusy(void)
+{
+    return g_stuck || (g_nowNs < g_busyUntilNs);
+}
+
+static void FlashStartBusy(uint32_t us)
+{
+    g_busyUntilNs = g_nowNs + (uint64_t)us * 1000;
+    g_wel = 0;
+    if (g_stuckNext) {
+        g_stuckNext = 0;
+        g_stuck = 1;
+    }
+}
+
+static void FlashErase(uint32_t addr, uint32_t size, int kind, uint32_t us)
+{
+    addr &= ~(size - 1) & (MSPI_MODEL_FLASH_SIZE - 1);
+    memset(&g_mem[addr], 0xFF, size);
+    g_stats.erases[kind]++;
+    FlashStartBusy(us);
+}
+
+/* the end of a command */
+static void FlashCommit(void)
+{
+    uint8_t cmd = g_cmd;
+    uint8_t lastCmd = g_lastCmd;
+
+    if (g_byteNum == 0) {
+        return;
+    }
+    g_lastCmd = cmd;
+
+    /* enable reset then reset, also on a busy flash */
+    if ((cmd == 0x99) && (lastCmd == 0x66)) {
+        g_stuck = 0;
+        g_stuckNext = 0;
+        g_busyUntilNs = 0;
+        g_wel = 0;
+        g_stats.resets++;
+        return;
+    }
+    if (FlashBusy()) {
+        return;
+    }
+
+    switch (cmd) {
+        case 0x06:
+            g_wel = 1;
+            break;
+        case 0x04:
+            g_wel = 0;
+            break;
+        case 0x02:
+            if (g_wel && (g_byteNum >= 4)) {
+                for (uint32_t i = 0; i < g_pageLen; i++) {
+                    uint32_t a = (g_addr & ~0xFFu) | ((g_addr + i) & 0xFF);
+                    g_mem[a & (MSPI_MODEL_FLASH_SIZE - 1)] &= g_page[i];
+                }
+                g_stats.programs++;
+                FlashStartBusy(MSPI_MODEL_PROGRAM_US);
+            }
+            break;
+        case 0x20:
+            if (g_wel && (g_byteNum >= 4)) {
+                FlashErase(g_addr, 0x1000, 0, MSPI_MODEL_SECTOR_US);
+            }
+            break;
+        case 0x52:
+            if (g_wel && (g_byteNum >= 4)) {
+                FlashErase(g_addr, 0x8000, 1, MSPI_MODEL_32K_US);
+            }
+            break;
+        case 0xD8:
+            if (g_wel && (g_byteNum >= 4)) {
+                FlashErase(g_addr, 0x10000, 2, MSPI_MODEL_64K_US);
+            }
+            break;
+        case 0x60:
+        case 0xC7:
+            if (g_wel) {
+                FlashErase(0, MSPI_MODEL_FLASH_SIZE, 3, MSPI_MODEL_CHIP_US);
+            }
+            break;
+        case 0x01:
+            if (g_wel) {
+                FlashStartBusy(MSPI_MODEL_STATUS_US);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* one byte on the bus, returns what the flash drives on the data line */
+static uint8_t FlashClock(uint8_t in)
+{
+    uint32_t n = g_byteNum++;
+    uint8_t out = 0xFF;
+
+    g_nowNs += MSPI_MODEL_BYTE_NS;
+    g_stats.bytes++;
+
+    if (n == 0) {
+        g_cmd = in;
+        g_addr = 0;
+        g_pageLen = 0;
+        return out;
+    }
+    if (FlashBusy() && (g_cmd != 0x05)) {
+        return out;
+    }
+
+    switch (g_cmd) {
+        case 0x05:
+            g_stats.pollBytes++;
+            out = (FlashBusy() ? STATUS_BUSY : 0) | (g_wel ? STATUS_WEL : 0);
+            break;
+        case 0x35:
+            out = 0;
+            break;
+        case 0x9F:
+            out = (n <= sizeof(g_jedecId)) ? g_jedecId[n - 1] : 0;
+            break;
+        case 0x03:
+        case 0x02:
+        case 0x20:
+        case 0x52:
+        case 0xD8:
+        case 0x4B:
+        case 0x5A:
+            if (n <= 3) {
+                g_addr = (g_addr << 8) | in;
+            } else if (g_cmd == 0x03) {
+                out = g_mem[g_addr++ & (MSPI_MODEL_FLASH_SIZE - 1)];
+            } else if (g_cmd == 0x02) {
+                g_page[g_pageLen++ % sizeof(g_page)] = in;
+                g_pageLen = (g_pageLen > sizeof(g_page)) ? sizeof(g_page) : g_pageLen;
+            } else if ((g_cmd == 0x4B) && (n >= 5)) {
+                out = g_uid[(n - 5) % sizeof(g_uid)];
+            }
+            break;
+        default:
+            break;
+    }
+
+    return out;
+}
+
+void mspi_wait(void)
+{
+}
+
+void mspi_fm_rd_en(void)
+{
+    g_autoRead = 1;
+}
+
+void mspi_fm_rd_dis(void)
+{
+    g_autoRead = 0;
+}
+
+void mspi_high(void)
+{
+    if (g_csLow) {
+        g_csLow = 0;
+        FlashCommit();
+    }
+}
+
+void mspi_low(void)
+{
+    if (!g_csLow) {
+        g_csLow = 1;
+        g_byteNum = 0;
+        g_stats.commands++;
+    }
+}
+
+unsigned char mspi_get(void)
+{
+    uint8_t data = g_dataReg;
+
+    if (g_autoRead && g_csLow) {
+        g_dataReg = FlashClock(0);
+    }
+
+    return data;
+}
+
+void mspi_write(unsigned char c)
+{
+    if (!g_csLow) {
+        fprintf(stderr, "mspi model: write 0x%02x with CS high\n", c);
+        abort();
+    }
+    g_dataReg = FlashClock(c);
+}
+
+unsigned char mspi_read(void)
+{
+    mspi_write(0);
+    return g_dataReg;
+}
+
+void mspi_stop_xip(void)
+{
+    mspi_high();
+}
+
+unsigned int core_interrupt_disable(void)
+{
+    if (!g_irqEnabled) {
+        return 0;
+    }
+    g_irqEnabled = 0;
+    g_irqOffSinceNs = g_nowNs;
+
+    return 0x888;
+}
+
+unsigned int core_restore_interrupt(unsigned int en)
+{
+    uint64_t off;
+
+    if (!en || g_irqEnabled) {
+        return 0;
+    }
+    g_irqEnabled = 1;
+    off = g_nowNs - g_irqOffSinceNs;
+    g_stats.irqOffNs += off;
+    g_stats.irqOffMaxNs = (off > g_stats.irqOffMaxNs) ? off : g_stats.irqOffMaxNs;
+
+    if (g_irqHook && !g_inIrqHook) {
+        g_inIrqHook = 1;
+        g_irqHook();
+        g_inIrqHook = 0;
+    }
+
+    return 0;
+}
+
+void plic_set_threshold(unsigned char threshold)
+{
+    g_mspiModelIrqThreshold = threshold;
+}
+
+unsigned int plic_enter_critical_sec(unsigned char preempt_en, unsigned char threshold)
+{
+    (void)preempt_en;
+    (void)threshold;
+    return core_interrupt_disable();
+}
+
+void plic_exit_critical_sec(unsigned char preempt_en, unsigned int r)
+{
+    (void)preempt_en;
+    (void)core_restore_interrupt(r);
+}
+
+unsigned int stimer_get_tick(void)
+{
+    return (unsigned int)(g_nowNs * SYSTEM_TIMER_TICK_1US / 1000);
+}
+
+void delay_us(unsigned int us)
+{
+    g_nowNs += (uint64_t)us * 1000;
+}
+
+void MspiModelReset(void)
+{
+    memset(g_mem, 0xFF, sizeof(g_mem));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_csLow = 0;
+    g_autoRead = 0;
+    g_lastCmd = 0;
+    g_wel = 0;
+    g_busyUntilNs = 0;
+    g_stuck = 0;
+    g_stuckNext = 0;
+    g_irqEnabled = 1;
+    g_irqHook = NULL;
+    g_plic_preempt_en = 0;
+}
+
+uint8_t *MspiModelMem(void)
+{
+    return g_mem;
+}
+
+uint64_t MspiModelTimeNs(void)
+{
+    return g_nowNs;
+}
+
+void MspiModelRun(uint64_t ns)
+{
+    g_nowNs += ns;
+}
+
+MspiModelStats *MspiModelStatsGet(void)
+{
+    return &g_stats;
+}
+
+void MspiModelIrqHookSet(void (*hook)(void))
+{
+    g_irqHook = hook;
+}
+
+void MspiModelStuckSet(int stuck)
+{
+    g_stuckNext = stuck;
+}
+
+int MspiModelIrqEnabled(void)
+{
+    return g_irqEnabled;
+}
@@ -0,0 +1,185 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of ext_driver/pin_mux.c on the real gpio_reg.h map over a RAM array: driver style claims set the
+ * function mux and GPIO enable of their ports, a claim with a pad of another owner or an invalid pad or function
+ * is refused as a whole with no register or owner change, and a release gives only the owner's pads back to GPIO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pin_mux.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define ARRAY_NUM(a) (sizeof(a) / sizeof((a)[0]))
+
+_Alignas(4) uint8_t g_pinMuxReg[PIN_MUX_REG_SIZE];
+
+static const gpio_pin_e g_allPins[] = {
+    GPIO_PA0, GPIO_PA1, GPIO_PA2, GPIO_PA3, GPIO_PA4, GPIO_PA5, GPIO_PA6, GPIO_PA7,
+    GPIO_PB0, GPIO_PB1, GPIO_PB2, GPIO_PB3, GPIO_PB4, GPIO_PB5, GPIO_PB6, GPIO_PB7,
+    GPIO_PC0, GPIO_PC1, GPIO_PC2, GPIO_PC3, GPIO_PC4, GPIO_PC5, GPIO_PC6, GPIO_PC7,
+    GPIO_PD0, GPIO_PD1, GPIO_PD2, GPIO_PD3, GPIO_PD4, GPIO_PD5, GPIO_PD6, GPIO_PD7,
+    GPIO_PE0, GPIO_PE1, GPIO_PE2, GPIO_PE3, GPIO_PE4, GPIO_PE5, GPIO_PE6, GPIO_PE7,
+    GPIO_PF0, GPIO_PF1, GPIO_PF2, GPIO_PF3, GPIO_PF4, GPIO_PF5, GPIO_PF6, GPIO_PF7,
+};
+
+/* function mux field of a pad, 2 bits per pad */
+static unsigned int Func(gpio_pin_e pin)
+{
+    static volatile uint16_t *const fs[] = {&reg_gpio_pa_fs, &reg_gpio_pb_fs, &reg_gpio_pc_fs,
+                                            &reg_gpio_pd_fs, &reg_gpio_pe_fs, &reg_gpio_pf_fs};
+
+    return (*fs[pin >> 8] >> (BIT_LOW_BIT(pin & 0xff) * 2)) & 3;
+}
+
+static int IsGpio(gpio_pin_e pin)
+{
+    return (reg_gpio_func(pin) & (pin & 0xff)) != 0;
+}
+
+/* registers and owners are left exactly as they were by a refused claim */
+static void CheckRefused(pin_mux_owner_e owner, const pin_mux_cfg_t *cfg, unsigned int num)
+{
+    uint8_t reg[PIN_MUX_REG_SIZE];
+    pin_mux_owner_e before[ARRAY_NUM(g_allPins)];
+
+    memcpy(reg, g_pinMuxReg, sizeof(reg));
+    for (unsigned int i = 0; i < ARRAY_NUM(g_allPins); i++) {
+        before[i] = pin_mux_get_owner(g_allPins[i]);
+    }
+
+    CHECK(pin_mux_claim(owner, cfg, num, 0x01) == -1);
+
+    CHECK(!memcmp(reg, g_pinMuxReg, sizeof(reg)));
+    for (unsigned int i = 0; i < ARRAY_NUM(g_allPins); i++) {
+        CHECK(pin_mux_get_owner(g_allPins[i]) == before[i]);
+    }
+}
+
+/* the init sequences of the drivers, in the order a board brings them up */
+static void TestClaim(void)
+{
+    static const pin_mux_cfg_t uart0[] = {{GPIO_PB2, 2}, {GPIO_PB3, 2}};
+    static const pin_mux_cfg_t i2c[] = {{GPIO_PC2, 1}, {GPIO_PC3, 1}};
+    static const pin_mux_cfg_t pwm[] = {{GPIO_PB4, 0}, {GPIO_PE1, 3}};
+    static const pin_mux_cfg_t gpio[] = {{GPIO_PB5, PIN_MUX_FUNC_GPIO}, {GPIO_PA0, PIN_MUX_FUNC_KEEP}};
+
+    memset(g_pinMuxReg, 0xff, sizeof(g_pinMuxReg));
+    reg_gpio_pad_mul_sel = 0;
+
+    for (int i = 0; i < 4; i++) {
+        CHECK(pin_mux_get_owner((gpio_pin_e)(0x500 | BIT(i))) == PIN_MUX_OWNER_MSPI);
+    }
+    CHECK(pin_mux_get_owner(GPIO_PA0 | GPIO_PA1) == PIN_MUX_OWNER_NONE);
+
+    CHECK(pin_mux_claim(PIN_MUX_OWNER_UART0, uart0, ARRAY_NUM(uart0), 0) == 0);
+    CHECK(pin_mux_claim(PIN_MUX_OWNER_I2C, i2c, ARRAY_NUM(i2c), 0x01) == 0);
+    CHECK(pin_mux_claim(PIN_MUX_OWNER_PWM, pwm, ARRAY_NUM(pwm), 0) == 0);
+    CHECK(pin_mux_claim(PIN_MUX_OWNER_GPIO, gpio, ARRAY_NUM(gpio), 0) == 0);
+
+    CHECK(Func(GPIO_PB2) == 2 && Func(GPIO_PB3) == 2 && !IsGpio(GPIO_PB2) && !IsGpio(GPIO_PB3));
+    CHECK(Func(GPIO_PC2) == 1 && Func(GPIO_PC3) == 1 && !IsGpio(GPIO_PC2));
+    CHECK(Func(GPIO_PB4) == 0 && Func(GPIO_PE1) == 3 && !IsGpio(GPIO_PB4) && !IsGpio(GPIO_PE1));
+    CHECK(IsGpio(GPIO_PB5) && IsGpio(GPIO_PA0));
+    CHECK(reg_gpio_pad_mul_sel == 0x01);
+    /* pads of the same ports not claimed are untouched */
+    CHECK(Func(GPIO_PB6) == 3 && IsGpio(GPIO_PB6) && Func(GPIO_PC0) == 3 && IsGpio(GPIO_PE0));
+
+    CHECK(pin_mux_get_owner(GPIO_PB3) == PIN_MUX_OWNER_UART0);
+    CHECK(pin_mux_get_owner(GPIO_PA0) == PIN_MUX_OWNER_GPIO);
+
+    /* the owner changes the function of its pad */
+    static const pin_mux_cfg_t uart0Gpio[] = {{GPIO_PB3, PIN_MUX_FUNC_GPIO}};
+    CHECK(pin_mux_claim(PIN_MUX_OWNER_UART0, uart0Gpio, 1, 0) == 0);
+    CHECK(IsGpio(GPIO_PB3) && Func(GPIO_PB3) == 2);
+    CHECK(pin_mux_claim(PIN_MUX_OWNER_UART0, uart0, ARRAY_NUM(uart0), 0) == 0);
+    CHECK(!IsGpio(GPIO_PB3));
+}
+
+/* a conflict or an invalid entry anywhere in a claim leaves everything as it was */
+static void TestAllOrNothing(void)
+{
+    /* the conflict is the last pad, the free ones before it are not taken */
+    static const pin_mux_cfg_t hspi[] = {{GPIO_PC4, 2}, {GPIO_PC5, 2}, {GPIO_PB3, 1}};
+    static const pin_mux_cfg_t flash[] = {{GPIO_PD0, 0}, {GPIO_PF2, PIN_MUX_FUNC_GPIO}};
+    static const pin_mux_cfg_t multi[] = {{GPIO_PC6, 1}, {GPIO_PC6 | GPIO_PC7, 1}};
+    static const pin_mux_cfg_t group[] = {{GPIO_PC6, 1}, {(gpio_pin_e)0x601, 1}};
+    static const pin_mux_cfg_t none[] = {{GPIO_PC6, 1}, {(gpio_pin_e)0x200, 1}};
+    static const pin_mux_cfg_t func[] = {{GPIO_PC6, 1}, {GPIO_PC7, 4}};
+    static const pin_mux_cfg_t ok[] = {{GPIO_PC6, 1}};
+    pin_mux_owner_e owner;
+
+    CheckRefused(PIN_MUX_OWNER_HSPI, hspi, ARRAY_NUM(hspi));
+    CHECK(pin_mux_get_conflict(&owner) == GPIO_PB3 && owner == PIN_MUX_OWNER_UART0);
+    CHECK(pin_mux_get_conflict(NULL) == GPIO_PB3);
+
+    CheckRefused(PIN_MUX_OWNER_USER0, flash, ARRAY_NUM(flash));
+    CHECK(pin_mux_get_conflict(&owner) == GPIO_PF2 && owner == PIN_MUX_OWNER_MSPI);
+
+    CheckRefused(PIN_MUX_OWNER_PSPI, multi, ARRAY_NUM(multi));
+    CheckRefused(PIN_MUX_OWNER_PSPI, group, ARRAY_NUM(group));
+    CheckRefused(PIN_MUX_OWNER_PSPI, none, ARRAY_NUM(none));
+    CheckRefused(PIN_MUX_OWNER_PSPI, func, ARRAY_NUM(func));
+    CheckRefused(PIN_MUX_OWNER_NONE, ok, ARRAY_NUM(ok));
+    CheckRefused(PIN_MUX_OWNER_MAX, ok, ARRAY_NUM(ok));
+
+    CHECK(pin_mux_claim(PIN_MUX_OWNER_PSPI, ok, ARRAY_NUM(ok), 0) == 0);
+    CHECK(Func(GPIO_PC6) == 1);
+}
+
+/* a release gives back only the owner's pads, as GPIO */
+static void TestRelease(void)
+{
+    static const pin_mux_cfg_t hspi[] = {{GPIO_PC4, 2}, {GPIO_PC5, 2}, {GPIO_PB3, 1}};
+
+    pin_mux_release(PIN_MUX_OWNER_UART0, GPIO_PB2 | GPIO_PB4);
+    CHECK(pin_mux_get_owner(GPIO_PB2) == PIN_MUX_OWNER_NONE && IsGpio(GPIO_PB2));
+    CHECK(pin_mux_get_owner(GPIO_PB3) == PIN_MUX_OWNER_UART0 && !IsGpio(GPIO_PB3));
+    CHECK(pin_mux_get_owner(GPIO_PB4) == PIN_MUX_OWNER_PWM && !IsGpio(GPIO_PB4));
+
+    pin_mux_release_all(PIN_MUX_OWNER_UART0);
+    CHECK(pin_mux_get_owner(GPIO_PB3) == PIN_MUX_OWNER_NONE && IsGpio(GPIO_PB3));
+    CHECK(pin_mux_claim(PIN_MUX_OWNER_HSPI, hspi, ARRAY_NUM(hspi), 0) == 0);
+    CHECK(Func(GPIO_PB3) == 1 && !IsGpio(GPIO_PB3));
+
+    pin_mux_release_all(PIN_MUX_OWNER_PWM);
+    CHECK(IsGpio(GPIO_PB4) && IsGpio(GPIO_PE1));
+    CHECK(pin_mux_get_owner(GPIO_PB3) == PIN_MUX_OWNER_HSPI && !IsGpio(GPIO_PB3));
+    CHECK(pin_mux_get_owner(GPIO_PF0) == PIN_MUX_OWNER_MSPI);
+}
+
+int main(void)
+{
+    TestClaim();
+    TestAllOrNothing();
+    TestRelease();
+    printf("pin_mux_test: ok\n");
+
+    return 0;
+}
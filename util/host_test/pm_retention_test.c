@@ -0,0 +1,224 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host simulation of deep retention sleep/wake cycles through ext_driver/pm_retention.c. A few drivers keep their
+ * state in a register bank that is lost in sleep and in a context blob that is kept, like retention SRAM. Every cycle
+ * changes the registers, saves, trashes the bank and restores: the bank must come back as it was, each driver only
+ * after the ones it depends on, and the restore time of every node must be accounted. Dependency loops and missing
+ * dependencies must fail but still restore every node.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pm_retention.h"
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define REG_PER_NODE 8
+#define CYCLE_NUM    20
+
+/* the nodes of the test, the restore cost of node id is id + 1 ticks */
+#define NODE_PINMUX   PM_RET_ID_GPIO
+#define NODE_UART     PM_RET_ID_UART0
+#define NODE_I2C      PM_RET_ID_I2C
+#define NODE_SENSOR   PM_RET_ID_USER0                    /* on the I2C bus */
+#define NODE_LOGGER   ((pm_ret_id_e)(PM_RET_ID_USER0 + 1)) /* prints to the UART */
+#define NODE_NUM_USED 5
+
+typedef struct {
+    unsigned int reg[REG_PER_NODE];
+} NodeCtx;
+
+static const pm_ret_id_e g_nodes[NODE_NUM_USED] = {NODE_PINMUX, NODE_UART, NODE_I2C, NODE_SENSOR, NODE_LOGGER};
+
+static unsigned int g_reg[PM_RET_ID_MAX][REG_PER_NODE]; /* digital registers, lost in sleep */
+static NodeCtx g_ctx[PM_RET_ID_MAX];                    /* retention SRAM */
+static unsigned char g_order[PM_RET_ID_MAX * 2];
+static int g_orderNum;
+static unsigned int g_tick;
+static unsigned int g_rand = 7;
+
+unsigned int stimer_get_tick(void)
+{
+    return g_tick;
+}
+
+static unsigned int Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+static int IdOfCtx(const void *ctx)
+{
+    return (const NodeCtx *)ctx - g_ctx;
+}
+
+static void Save(void *ctx)
+{
+    memcpy(((NodeCtx *)ctx)->reg, g_reg[IdOfCtx(ctx)], sizeof(g_reg[0]));
+}
+
+static void Restore(const void *ctx)
+{
+    int id = IdOfCtx(ctx);
+
+    CHECK(g_orderNum < (int)sizeof(g_order));
+    g_order[g_orderNum++] = id;
+    memcpy(g_reg[id], ((const NodeCtx *)ctx)->reg, sizeof(g_reg[0]));
+    g_tick += id + 1;
+}
+
+static void Register(pm_ret_id_e id, unsigned short depMask)
+{
+    pm_ret_node_t node = {Save, Restore, &g_ctx[id], depMask};
+
+    CHECK(pm_retention_register(id, &node) == 0);
+}
+
+static int Position(int id)
+{
+    for (int i = 0; i < g_orderNum; i++) {
+        if (g_order[i] == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* one sleep/wake cycle, returns what pm_retention_restore_all returned */
+static int SleepWake(void)
+{
+    unsigned int before[PM_RET_ID_MAX][REG_PER_NODE];
+    unsigned int start = g_tick;
+    int ret;
+
+    for (int i = 0; i < NODE_NUM_USED; i++) {
+        for (int r = 0; r < REG_PER_NODE; r++) {
+            g_reg[g_nodes[i]][r] = Rand();
+        }
+    }
+    memcpy(before, g_reg, sizeof(g_reg));
+    pm_retention_save_all();
+
+    for (int i = 0; i < PM_RET_ID_MAX; i++) {
+        for (int r = 0; r < REG_PER_NODE; r++) {
+            g_reg[i][r] = Rand();
+        }
+    }
+    g_orderNum = 0;
+    ret = pm_retention_restore_all();
+
+    CHECK(g_orderNum == NODE_NUM_USED);
+    for (int i = 0; i < NODE_NUM_USED; i++) {
+        int id = g_nodes[i];
+        CHECK(Position(id) >= 0);
+        CHECK(memcmp(g_reg[id], before[id], sizeof(g_reg[0])) == 0);
+        CHECK(pm_retention_get_restore_tick(id) == (unsigned int)id + 1);
+    }
+    CHECK(pm_retention_get_total_restore_tick() == g_tick - start);
+
+    return ret;
+}
+
+static void TestCycles(void)
+{
+    // registered in an order unrelated to the dependencies
+    Register(NODE_LOGGER, BIT(NODE_UART));
+    Register(NODE_SENSOR, BIT(NODE_I2C) | BIT(NODE_PINMUX));
+    Register(NODE_I2C, BIT(NODE_PINMUX));
+    Register(NODE_UART, BIT(NODE_PINMUX));
+    Register(NODE_PINMUX, 0);
+
+    for (int cycle = 0; cycle < CYCLE_NUM; cycle++) {
+        CHECK(SleepWake() == 0);
+        CHECK(Position(NODE_PINMUX) < Position(NODE_UART));
+        CHECK(Position(NODE_PINMUX) < Position(NODE_I2C));
+        CHECK(Position(NODE_I2C) < Position(NODE_SENSOR));
+        CHECK(Position(NODE_UART) < Position(NODE_LOGGER));
+    }
+}
+
+/* a node may depend on a node with a higher id */
+static void TestReverseDependency(void)
+{
+    Register(NODE_PINMUX, BIT(NODE_LOGGER));
+    Register(NODE_LOGGER, 0);
+
+    CHECK(SleepWake() == 0);
+    CHECK(Position(NODE_LOGGER) < Position(NODE_PINMUX));
+    CHECK(Position(NODE_PINMUX) < Position(NODE_UART));
+    CHECK(Position(NODE_PINMUX) < Position(NODE_I2C));
+    CHECK(Position(NODE_I2C) < Position(NODE_SENSOR));
+}
+
+/* a loop or a dependency nobody registered fails, every node is still restored once */
+static void TestBrokenDependency(void)
+{
+    Register(NODE_PINMUX, 0);
+    Register(NODE_UART, BIT(NODE_LOGGER));
+    Register(NODE_LOGGER, BIT(NODE_UART));
+    CHECK(SleepWake() == -1);
+    CHECK(Position(NODE_UART) < Position(NODE_LOGGER));
+
+    Register(NODE_UART, BIT(NODE_PINMUX));
+    Register(NODE_LOGGER, BIT(PM_RET_ID_UART1));
+    CHECK(SleepWake() == -1);
+    CHECK(Position(NODE_LOGGER) == NODE_NUM_USED - 1);
+
+    Register(NODE_LOGGER, BIT(NODE_UART));
+    CHECK(SleepWake() == 0);
+}
+
+/* an unregistered node is neither saved nor restored */
+static void TestUnregister(void)
+{
+    pm_ret_node_t node = {Save, 0, &g_ctx[0], 0};
+
+    CHECK(pm_retention_register(PM_RET_ID_MAX, &node) == -1);
+    CHECK(pm_retention_register(NODE_PINMUX, &node) == -1);
+
+    pm_retention_unregister(NODE_SENSOR);
+    memset(&g_ctx[NODE_SENSOR], 0, sizeof(g_ctx[0]));
+    pm_retention_save_all();
+    g_orderNum = 0;
+    CHECK(pm_retention_restore_all() == 0);
+    CHECK(g_orderNum == NODE_NUM_USED - 1 && Position(NODE_SENSOR) < 0);
+    CHECK(g_ctx[NODE_SENSOR].reg[0] == 0);
+    Register(NODE_SENSOR, BIT(NODE_I2C));
+}
+
+int main(void)
+{
+    TestCycles();
+    TestReverseDependency();
+    TestBrokenDependency();
+    TestUnregister();
+    CHECK(SleepWake() == 0);
+    printf("pm_retention_test: ok, %d sleep/wake cycles\n", CYCLE_NUM + 5);
+    return 0;
+}
@@ -0,0 +1,282 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of the ext_driver/pm_wakeup.c registry: claims and their exclusivity, pad pins with one owner each,
+ * sources which stay owned but do not wake, the dispatch of a wakeup status to the owners of the sources which
+ * woke the chip, and the cpu_sleep_wakeup hook with its sleep hooks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pm_wakeup.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define PIN(n) (0x100 | (1u << ((n) & 7)) | (((n) >> 3) << 9)) /* distinct pins in several groups */
+
+cpu_pm_handler_t cpu_sleep_wakeup;
+
+static unsigned int g_status;
+static int g_pinEn[0x1000];
+static int g_pinLevel[0x1000];
+static unsigned int g_sleepSrc;
+static unsigned int g_sleepTick;
+static int g_sleepNum;
+static unsigned int g_cbStatus[PM_WAKEUP_ID_MAX];
+static int g_cbNum[PM_WAKEUP_ID_MAX];
+static char g_hookOrder[8];
+static int g_hookNum;
+
+unsigned int pm_get_wakeup_src(void)
+{
+    return g_status;
+}
+
+void pm_set_gpio_wakeup(gpio_pin_e pin, pm_gpio_wakeup_level_e pol, int en)
+{
+    CHECK(pin < 0x1000);
+    g_pinEn[pin] = en;
+    g_pinLevel[pin] = pol;
+}
+
+static int SleepHandler(SleepMode_TypeDef sleep_mode, SleepWakeupSrc_TypeDef wakeup_src, unsigned int wakeup_tick)
+{
+    (void)sleep_mode;
+    g_sleepSrc = wakeup_src;
+    g_sleepTick = wakeup_tick;
+    g_sleepNum++;
+    return 0;
+}
+
+static void Cb(unsigned int status, void *ctx)
+{
+    int id = (int)(long)ctx;
+
+    g_cbStatus[id] = status;
+    g_cbNum[id]++;
+}
+
+static void ResetCb(void)
+{
+    for (int i = 0; i < PM_WAKEUP_ID_MAX; i++) {
+        g_cbNum[i] = 0;
+        g_cbStatus[i] = 0;
+    }
+}
+
+static unsigned int HookA(SleepMode_TypeDef sleep_mode, SleepWakeupSrc_TypeDef wakeup_src, unsigned int wakeup_tick)
+{
+    (void)sleep_mode;
+    (void)wakeup_src;
+    g_hookOrder[g_hookNum++] = 'a';
+    return wakeup_tick + 10;
+}
+
+static unsigned int HookB(SleepMode_TypeDef sleep_mode, SleepWakeupSrc_TypeDef wakeup_src, unsigned int wakeup_tick)
+{
+    (void)sleep_mode;
+    CHECK(wakeup_src & PM_WAKEUP_COMPARATOR); /* hooks see the claimed sources */
+    g_hookOrder[g_hookNum++] = 'b';
+    return wakeup_tick * 2;
+}
+
+/* the comparator and MDEC have one owner each, other sources are shared */
+static void TestClaim(void)
+{
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_MAX, PM_WAKEUP_TIMER, 0, 0) == -1);
+    CHECK(pm_wakeup_get_mask() == 0);
+
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, Cb, (void *)PM_WAKEUP_ID_LPC) == 0);
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_USER0, PM_WAKEUP_COMPARATOR | PM_WAKEUP_MDEC, 0, 0) == -1);
+    CHECK(pm_wakeup_get_mask() == PM_WAKEUP_COMPARATOR);
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_MDEC, PM_WAKEUP_MDEC, Cb, (void *)PM_WAKEUP_ID_MDEC) == 0);
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, Cb, (void *)PM_WAKEUP_ID_LPC) == 0);
+
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_USER0, PM_WAKEUP_TIMER, Cb, (void *)PM_WAKEUP_ID_USER0) == 0);
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_USER0 + 1, PM_WAKEUP_TIMER | PM_WAKEUP_CORE, Cb,
+                          (void *)(PM_WAKEUP_ID_USER0 + 1)) == 0);
+    CHECK(pm_wakeup_get_mask() ==
+          (PM_WAKEUP_COMPARATOR | PM_WAKEUP_MDEC | PM_WAKEUP_TIMER | PM_WAKEUP_CORE));
+
+    /* the comparator stays owned while it does not wake, a new claim makes it wake again */
+    pm_wakeup_enable(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, 0);
+    CHECK(!(pm_wakeup_get_mask() & PM_WAKEUP_COMPARATOR));
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_USER0, PM_WAKEUP_COMPARATOR, 0, 0) == -1);
+    pm_wakeup_enable(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, 1);
+    CHECK(pm_wakeup_get_mask() & PM_WAKEUP_COMPARATOR);
+    pm_wakeup_enable(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, 0);
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, Cb, (void *)PM_WAKEUP_ID_LPC) == 0);
+    CHECK(pm_wakeup_get_mask() & PM_WAKEUP_COMPARATOR);
+
+    /* disabling a source of another owner or one not claimed has no effect */
+    pm_wakeup_enable(PM_WAKEUP_ID_USER0, PM_WAKEUP_COMPARATOR, 0);
+    CHECK(pm_wakeup_get_mask() & PM_WAKEUP_COMPARATOR);
+
+    pm_wakeup_release(PM_WAKEUP_ID_LPC);
+    CHECK(!(pm_wakeup_get_mask() & PM_WAKEUP_COMPARATOR));
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_USER0, PM_WAKEUP_COMPARATOR, 0, 0) == 0);
+
+    for (int i = 0; i < PM_WAKEUP_ID_MAX; i++) {
+        pm_wakeup_release((pm_wakeup_id_e)i);
+    }
+    CHECK(pm_wakeup_get_mask() == 0);
+}
+
+/* a pad pin has one owner, the table is reused after a release */
+static void TestPin(void)
+{
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_MAX, PIN(0), WAKEUP_LEVEL_LOW) == -1);
+
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_KEYSCAN, 0, Cb, (void *)PM_WAKEUP_ID_KEYSCAN) == 0);
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_KEYSCAN, PIN(0), WAKEUP_LEVEL_LOW) == 0);
+    CHECK(g_pinEn[PIN(0)] && g_pinLevel[PIN(0)] == WAKEUP_LEVEL_LOW);
+    CHECK(pm_wakeup_get_mask() == PM_WAKEUP_PAD);
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_USER0, PIN(0), WAKEUP_LEVEL_HIGH) == -1);
+    CHECK(g_pinLevel[PIN(0)] == WAKEUP_LEVEL_LOW);
+
+    /* the owner may change the level, the pin keeps its entry */
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_KEYSCAN, PIN(0), WAKEUP_LEVEL_HIGH) == 0);
+    CHECK(g_pinLevel[PIN(0)] == WAKEUP_LEVEL_HIGH);
+    /* a later claim of other sources keeps the pad */
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_KEYSCAN, PM_WAKEUP_TIMER, Cb, (void *)PM_WAKEUP_ID_KEYSCAN) == 0);
+    CHECK(pm_wakeup_get_mask() == (PM_WAKEUP_PAD | PM_WAKEUP_TIMER));
+
+    for (int i = 1; i < PM_WAKEUP_PIN_MAX; i++) {
+        CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_USER0, PIN(i), WAKEUP_LEVEL_LOW) == 0);
+    }
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_USER0, PIN(PM_WAKEUP_PIN_MAX), WAKEUP_LEVEL_LOW) == -1);
+    CHECK(!g_pinEn[PIN(PM_WAKEUP_PIN_MAX)]);
+
+    pm_wakeup_release(PM_WAKEUP_ID_KEYSCAN);
+    CHECK(!g_pinEn[PIN(0)]);
+    CHECK(g_pinEn[PIN(1)]);
+    CHECK(pm_wakeup_get_mask() == PM_WAKEUP_PAD);
+    /* the released entry is reused, an owned pin is still found behind it */
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_USER0, PIN(1), WAKEUP_LEVEL_HIGH) == 0);
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_KEYSCAN, PIN(1), WAKEUP_LEVEL_LOW) == -1);
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_KEYSCAN, PIN(PM_WAKEUP_PIN_MAX), WAKEUP_LEVEL_LOW) == 0);
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_KEYSCAN, PIN(PM_WAKEUP_PIN_MAX + 1), WAKEUP_LEVEL_LOW) == -1);
+
+    pm_wakeup_release(PM_WAKEUP_ID_USER0);
+    pm_wakeup_release(PM_WAKEUP_ID_KEYSCAN);
+    for (int i = 0; i <= PM_WAKEUP_PIN_MAX; i++) {
+        CHECK(!g_pinEn[PIN(i)]);
+    }
+    CHECK(pm_wakeup_get_mask() == 0);
+}
+
+/* only the owners of a waking source are called, with the whole status */
+static void TestDispatch(void)
+{
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_KEYSCAN, 0, Cb, (void *)PM_WAKEUP_ID_KEYSCAN) == 0);
+    CHECK(pm_wakeup_claim_pin(PM_WAKEUP_ID_KEYSCAN, PIN(3), WAKEUP_LEVEL_LOW) == 0);
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, Cb, (void *)PM_WAKEUP_ID_LPC) == 0);
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_MDEC, PM_WAKEUP_MDEC, 0, 0) == 0);
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_USER0, PM_WAKEUP_TIMER | PM_WAKEUP_CORE, Cb,
+                          (void *)PM_WAKEUP_ID_USER0) == 0);
+
+    ResetCb();
+    pm_wakeup_dispatch(WAKEUP_STATUS_PAD | WAKEUP_STATUS_TIMER);
+    CHECK(g_cbNum[PM_WAKEUP_ID_KEYSCAN] == 1 && g_cbStatus[PM_WAKEUP_ID_KEYSCAN] ==
+                                                    (WAKEUP_STATUS_PAD | WAKEUP_STATUS_TIMER));
+    CHECK(g_cbNum[PM_WAKEUP_ID_USER0] == 1);
+    CHECK(g_cbNum[PM_WAKEUP_ID_LPC] == 0);
+
+    ResetCb();
+    pm_wakeup_dispatch(WAKEUP_STATUS_COMPARATOR | WAKEUP_STATUS_MDEC);
+    CHECK(g_cbNum[PM_WAKEUP_ID_LPC] == 1 && g_cbStatus[PM_WAKEUP_ID_LPC] ==
+                                                (WAKEUP_STATUS_COMPARATOR | WAKEUP_STATUS_MDEC));
+    CHECK(g_cbNum[PM_WAKEUP_ID_KEYSCAN] == 0 && g_cbNum[PM_WAKEUP_ID_USER0] == 0);
+
+    ResetCb();
+    pm_wakeup_dispatch(WAKEUP_STATUS_CORE);
+    CHECK(g_cbNum[PM_WAKEUP_ID_USER0] == 1);
+    CHECK(g_cbNum[PM_WAKEUP_ID_KEYSCAN] + g_cbNum[PM_WAKEUP_ID_LPC] == 0);
+
+    /* a source which does not wake is not dispatched either */
+    ResetCb();
+    pm_wakeup_enable(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, 0);
+    pm_wakeup_dispatch(WAKEUP_STATUS_COMPARATOR);
+    CHECK(g_cbNum[PM_WAKEUP_ID_LPC] == 0);
+
+    ResetCb();
+    pm_wakeup_release(PM_WAKEUP_ID_USER0);
+    pm_wakeup_dispatch(WAKEUP_STATUS_TIMER | WAKEUP_STATUS_CORE);
+    CHECK(g_cbNum[PM_WAKEUP_ID_USER0] == 0);
+
+    for (int i = 0; i < PM_WAKEUP_ID_MAX; i++) {
+        pm_wakeup_release((pm_wakeup_id_e)i);
+    }
+}
+
+/* cpu_sleep_wakeup adds the claimed sources, runs the hooks in order and dispatches after the sleep */
+static void TestSleep(void)
+{
+    cpu_sleep_wakeup = SleepHandler;
+    pm_wakeup_init();
+    CHECK(cpu_sleep_wakeup != SleepHandler);
+    pm_wakeup_init();
+    pm_wakeup_set_sleep_handler(cpu_sleep_wakeup);
+
+    CHECK(pm_wakeup_claim(PM_WAKEUP_ID_LPC, PM_WAKEUP_COMPARATOR, Cb, (void *)PM_WAKEUP_ID_LPC) == 0);
+    g_status = WAKEUP_STATUS_COMPARATOR;
+    ResetCb();
+    CHECK(cpu_sleep_wakeup(SUSPEND_MODE, PM_WAKEUP_TIMER, 1000) == 0);
+    CHECK(g_sleepNum == 1);
+    CHECK(g_sleepSrc == (PM_WAKEUP_TIMER | PM_WAKEUP_COMPARATOR));
+    CHECK(g_sleepTick == 1000);
+    CHECK(g_cbNum[PM_WAKEUP_ID_LPC] == 1 && g_cbStatus[PM_WAKEUP_ID_LPC] == WAKEUP_STATUS_COMPARATOR);
+
+    CHECK(pm_wakeup_add_sleep_hook(HookA) == 0);
+    CHECK(pm_wakeup_add_sleep_hook(HookB) == 0);
+    CHECK(pm_wakeup_add_sleep_hook(HookA) == 0);
+    for (int i = 2; i < PM_WAKEUP_HOOK_MAX; i++) {
+        CHECK(pm_wakeup_add_sleep_hook(i & 1 ? HookA : HookB) == 0);
+    }
+    g_hookNum = 0;
+    (void)cpu_sleep_wakeup(SUSPEND_MODE, PM_WAKEUP_TIMER, 1000);
+    CHECK(g_hookNum == 2 && g_hookOrder[0] == 'a' && g_hookOrder[1] == 'b');
+    CHECK(g_sleepTick == (1000 + 10) * 2);
+
+    /* a new handler, e.g. after the crystal is selected, keeps the hook */
+    pm_wakeup_set_sleep_handler(SleepHandler);
+    CHECK(cpu_sleep_wakeup != SleepHandler);
+    (void)cpu_sleep_wakeup(SUSPEND_MODE, PM_WAKEUP_TIMER, 1);
+    CHECK(g_sleepNum == 3);
+
+    pm_wakeup_release(PM_WAKEUP_ID_LPC);
+}
+
+int main(void)
+{
+    TestClaim();
+    TestPin();
+    TestDispatch();
+    TestSleep();
+    printf("pm_wakeup_test: ok\n");
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of ext_driver/rc_32k_track.c: the sleep hook never opens a window and only waits for a 32k edge to
+ * close one, then a simulation of a 1 s connection interval on an RC drifting with temperature. The early-wake
+ * window with the tracked guard band and sleep correction is compared with a fixed worst case guard band.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <rc_32k_track.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define RC_HZ           32768.0
+#define READ_32K_S      0.5e-6 /* one analog read of the 32k timer */
+#define INTERVAL_S      1.0
+#define ACTIVE_S        3e-3   /* awake per connection event before the sleep */
+#define EVENTS          7200
+#define FIXED_GUARD_PPM 500    /* what has to be assumed without tracking */
+#define RX_UA           5300   /* receiver on while waiting for the anchor */
+
+clk_32k_type_e g_clk_32k_src = CLK_32K_RC;
+
+static double g_time;  /* s */
+static double g_phase; /* 32k ticks */
+static double g_noisePpm;
+static uint32_t g_rand = 1;
+static pm_wakeup_sleep_hook_t g_hook;
+
+static uint32_t Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+/* calibrated at 0, a slow temperature swing, a drift, and some frequency noise per connection event */
+static double RcPpm(double t)
+{
+    return 180.0 * sin(2 * M_PI * t / 1800.0) + 60.0 * t / 3600.0 + g_noisePpm;
+}
+
+static void Advance(double s)
+{
+    g_phase += s * RC_HZ * (1.0 + RcPpm(g_time) * 1e-6);
+    g_time += s;
+}
+
+unsigned int clock_get_32k_tick(void)
+{
+    Advance(READ_32K_S);
+    return (unsigned int)floor(g_phase);
+}
+
+unsigned int stimer_get_tick(void)
+{
+    return (unsigned int)(uint64_t)(g_time * 16e6);
+}
+
+unsigned int core_interrupt_disable(void)
+{
+    return 1;
+}
+
+unsigned int core_restore_interrupt(unsigned int en)
+{
+    (void)en;
+    return 0;
+}
+
+int pm_wakeup_add_sleep_hook(pm_wakeup_sleep_hook_t hook)
+{
+    g_hook = hook;
+    return 0;
+}
+
+static unsigned int Hook(unsigned int wakeupTick)
+{
+    return g_hook(0, PM_WAKEUP_TIMER, wakeupTick);
+}
+
+/* the hook never opens a window, and a short window is dropped without waiting for an edge */
+static void TestHook(void)
+{
+    double t;
+
+    g_time = 0;
+    g_phase = 0;
+    rc_32k_track_init(1);
+    CHECK(g_hook != NULL);
+
+    t = g_time;
+    (void)Hook(stimer_get_tick() + 16000);
+    CHECK(g_time == t);
+
+    rc_32k_track_sample();
+    Advance(1e-3);
+    t = g_time;
+    (void)Hook(stimer_get_tick() + 16000);
+    CHECK(g_time == t);
+
+    /* the window was dropped, the next sample opens one instead of closing it */
+    Advance(5e-3);
+    t = g_time;
+    rc_32k_track_sample();
+    CHECK(g_time - t < 31e-6 + 2 * READ_32K_S);
+    Advance(ACTIVE_S);
+    t = g_time;
+    (void)Hook(stimer_get_tick() + 16000);
+    /* closing waits for one 32k edge */
+    CHECK(g_time > t);
+    CHECK(g_time - t < 31e-6 + 2 * READ_32K_S);
+    /* the first window is the reference */
+    CHECK(rc_32k_track_get_sample_cnt() == 0);
+
+    t = g_time;
+    (void)Hook(stimer_get_tick() + 16000);
+    CHECK(g_time == t);
+}
+
+typedef struct {
+    double windowS; /* sum of the early-wake windows */
+    uint32_t missed;
+    double maxErrPpm; /* estimate against the RC, after the first minute */
+} SimResult;
+
+static void Simulate(int tracked, SimResult *res)
+{
+    const double ticksPer32k = 16e6 / RC_HZ; /* what the pm driver converts with, calibrated at 0 */
+    double anchor;
+
+    g_time = 0;
+    g_phase = 0;
+    g_rand = 1;
+    g_noisePpm = 0;
+    rc_32k_track_init((unsigned char)tracked);
+    res->windowS = 0;
+    res->missed = 0;
+    res->maxErrPpm = 0;
+
+    anchor = 0;
+    for (int i = 0; i < EVENTS; i++) {
+        double guardS;
+        double sleepS;
+        unsigned int now;
+        unsigned int wakeupTick;
+        double n32k;
+
+        g_noisePpm = (double)(Rand() % 21) - 10.0;
+        if (tracked) {
+            rc_32k_track_sample();
+        }
+        Advance(ACTIVE_S);
+
+        anchor += INTERVAL_S;
+        sleepS = anchor - g_time;
+        guardS = tracked ? rc_32k_track_get_guard_us((unsigned int)(sleepS * 1e6)) * 1e-6
+                         : sleepS * FIXED_GUARD_PPM * 1e-6;
+        now = stimer_get_tick();
+        wakeupTick = now + (unsigned int)((sleepS - guardS) * 16e6);
+        if (tracked) {
+            wakeupTick = Hook(wakeupTick);
+        }
+
+        /* the sleep is counted in 32k ticks of the RC */
+        n32k = (double)(int)(wakeupTick - stimer_get_tick()) / ticksPer32k;
+        Advance(n32k / (RC_HZ * (1.0 + RcPpm(g_time) * 1e-6)));
+
+        if (g_time > anchor) {
+            res->missed++;
+        } else {
+            res->windowS += anchor - g_time;
+        }
+        g_time = anchor;
+
+        if (tracked && (g_time > 60)) {
+            double err = fabs(rc_32k_track_get_ppm() - RcPpm(g_time));
+            res->maxErrPpm = (err > res->maxErrPpm) ? err : res->maxErrPpm;
+        }
+    }
+}
+
+static void TestSimulation(void)
+{
+    SimResult fixed;
+    SimResult tracked;
+    double fixedUs;
+    double trackedUs;
+
+    Simulate(0, &fixed);
+    Simulate(1, &tracked);
+
+    fixedUs = fixed.windowS / EVENTS * 1e6;
+    trackedUs = tracked.windowS / EVENTS * 1e6;
+    printf("rc_32k_track_test: early-wake window %.0f us fixed %d ppm, %.0f us tracked (estimate within %.0f ppm)\n",
+           fixedUs, FIXED_GUARD_PPM, trackedUs, tracked.maxErrPpm);
+    printf("rc_32k_track_test: %.1f uA saved at %d uA receive current and a %.0f s interval\n",
+           (fixedUs - trackedUs) * 1e-6 * RX_UA / INTERVAL_S, RX_UA, INTERVAL_S);
+
+    CHECK(fixed.missed == 0);
+    CHECK(tracked.missed == 0);
+    CHECK(rc_32k_track_get_sample_cnt() == EVENTS - 1);
+    /* a 3 ms window read at 0.5 us is a sample within about 170 ppm, the reference window carries that offset */
+    CHECK(tracked.maxErrPpm < 200);
+    CHECK(trackedUs * 3 < fixedUs * 2);
+}
+
+int main(void)
+{
+    TestHook();
+    TestSimulation();
+    printf("rc_32k_track_test: ok\n");
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+#!/bin/sh
+# Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Build and run the host checks of board independent platform code with the host compiler.
+# They are not part of the GN build, run them after touching the sources they cover.
+#
+# usage: run.sh [test_name ...]     (CC and OUT can be set in the environment)
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+CC=${CC:-cc}
+OUT=${OUT:-$(mktemp -d)}
+CFLAGS="-std=gnu11 -g -O1 -Wall -Wextra -Wno-unused-parameter -fsanitize=address,undefined -fno-sanitize-recover"
+
+LITEOS_INC="$ROOT/b91/liteos_m/inc"
+LITEOS_SRC="$ROOT/b91/liteos_m/src"
+DRIVERS_INC="-I$ROOT/b91/b91_ble_sdk/drivers/B91 -I$ROOT/b91/b91_ble_sdk/common"
+VENDOR_SRC="$ROOT/b91/b91_ble_sdk/vendor/common"
+EXT_DRIVER_SRC="$ROOT/b91/b91_ble_sdk/drivers/B91/ext_driver"
+HAL_FILE_DIR="$ROOT/b91/adapter/hals/utils/file"
+HAL_FILE_INC="-I$HERE/inc/hal_file -I$HAL_FILE_DIR/include"
+HDF_SRC="$ROOT/b91/hdf"
+
+logstore_test() {
+    $CC $CFLAGS -I"$HERE/inc" -I"$LITEOS_INC" -o "$OUT/$1" "$HERE/logstore_test.c" "$HERE/flash_model.c" \
+        "$LITEOS_SRC/logstore.c"
+    "$OUT/$1"
+}
+
+tsstore_test() {
+    $CC $CFLAGS -I"$HERE/inc" -I"$LITEOS_INC" -o "$OUT/$1" "$HERE/tsstore_test.c" "$HERE/flash_model.c" \
+        "$LITEOS_SRC/tsstore.c"
+    "$OUT/$1"
+}
+
+# AES-XTS under the littlefs block device, on a software AES
+littlefs_xts_test() {
+    $CC $CFLAGS -I"$HERE/inc" -DLITTLEFS_ENCRYPT_ENABLE=1 -o "$OUT/$1" "$HERE/littlefs_xts_test.c" \
+        "$HERE/aes_model.c" "$HERE/flash_model.c" "$LITEOS_SRC/littlefs_hal.c"
+    "$OUT/$1"
+}
+
+# the flash driver on a model of the MSPI and the flash
+flash_driver_test() {
+    $CC $CFLAGS -I"$HERE/inc" -I"$ROOT/b91/b91_ble_sdk/common" -include "$HERE/inc/mspi_flash_stub.h" \
+        -c -o "$OUT/flash.o" "$ROOT/b91/b91_ble_sdk/drivers/B91/flash.c"
+    $CC $CFLAGS -I"$HERE/inc" -I"$ROOT/b91/b91_ble_sdk/drivers/B91" -I"$ROOT/b91/b91_ble_sdk/common" \
+        -include "$HERE/inc/mspi_flash_stub.h" -o "$OUT/$1" "$HERE/flash_driver_test.c" "$HERE/mspi_flash_model.c" \
+        "$OUT/flash.o"
+    "$OUT/$1"
+}
+
+# the 32k RC drift tracker on a drifting oscillator model
+rc_32k_track_test() {
+    $CC $CFLAGS -I"$HERE/inc" -I"$EXT_DRIVER_SRC" -include "$HERE/inc/rc_32k_track_stub.h" -o "$OUT/$1" \
+        "$HERE/rc_32k_track_test.c" "$EXT_DRIVER_SRC/rc_32k_track.c" -lm
+    "$OUT/$1"
+}
+
+# the comparator threshold monitor on a comparator model
+lpc_monitor_test() {
+    $CC $CFLAGS -I"$HERE/inc" -I"$EXT_DRIVER_SRC" -include "$HERE/inc/lpc_monitor_stub.h" -o "$OUT/$1" \
+        "$HERE/lpc_monitor_test.c" "$EXT_DRIVER_SRC/lpc_monitor.c"
+    "$OUT/$1"
+}
+
+# the wakeup source registry
+pm_wakeup_test() {
+    $CC $CFLAGS -I"$HERE/inc" -I"$EXT_DRIVER_SRC" -include "$HERE/inc/pm_wakeup_stub.h" -o "$OUT/$1" \
+        "$HERE/pm_wakeup_test.c" "$EXT_DRIVER_SRC/pm_wakeup.c"
+    "$OUT/$1"
+}
+
+# the HDF GPIO edge debounce on a GPIO model with bouncy button traces
+gpio_debounce_test() {
+    $CC $CFLAGS -I"$HERE/inc/hdf_gpio" -o "$OUT/$1" "$HERE/gpio_debounce_test.c" "$HDF_SRC/gpio_telink.c"
+    "$OUT/$1"
+}
+
+# the pad owner registry on the real GPIO register map
+pin_mux_test() {
+    $CC $CFLAGS $DRIVERS_INC -I"$EXT_DRIVER_SRC" -include "$HERE/inc/pin_mux_stub.h" -o "$OUT/$1" \
+        "$HERE/pin_mux_test.c" "$EXT_DRIVER_SRC/pin_mux.c"
+    "$OUT/$1"
+}
+
+# default pin setting, then some inputs, drive strengths and pulls in every analog group
+gpio_default_test() {
+    $CC $CFLAGS $DRIVERS_INC -o "$OUT/$1" "$HERE/gpio_default_test.c"
+    "$OUT/$1"
+    $CC $CFLAGS $DRIVERS_INC -DPC0_INPUT_ENABLE=0 -DPC3_INPUT_ENABLE=1 -DPC7_DATA_STRENGTH=1 \
+        -DPD0_INPUT_ENABLE=1 -DPD6_DATA_STRENGTH=0 -DPULL_WAKEUP_SRC_PA1=GPIO_PIN_PULLUP_10K \
+        -DPULL_WAKEUP_SRC_PC5=GPIO_PIN_PULLDOWN_100K -DPULL_WAKEUP_SRC_PE7=GPIO_PIN_PULLUP_1M \
+        -o "$OUT/$1_custom" "$HERE/gpio_default_test.c"
+    "$OUT/$1_custom"
+}
+
+# the per task FPU stats hook on a model of the scheduler, switches from tasks and from interrupts
+fpu_stats_test() {
+    $CC $CFLAGS -I"$HERE/inc/fpu_stats" -I"$HERE/inc" -I"$LITEOS_INC" -DFPU_STATS_ENABLE=1 -DLOSCFG_ARCH_FPU_ENABLE=1 \
+        -DLOSCFG_DEBUG_HOOK=1 -o "$OUT/$1" "$HERE/fpu_stats_test.c" "$LITEOS_SRC/fpu_stats.c"
+    "$OUT/$1"
+}
+
+# string_opt.c reads whole aligned words past the end of a string, so it is built without the sanitizer
+string_opt_test() {
+    $CC -std=gnu11 -g -O2 -Wall -Wextra -I"$ROOT/b91/b91_ble_sdk" -I"$ROOT/b91/b91_ble_sdk/common" \
+        -c -o "$OUT/string_opt.o" "$LITEOS_SRC/string_opt.c"
+    $CC $CFLAGS -o "$OUT/$1" "$HERE/string_opt_test.c" "$OUT/string_opt.o"
+    "$OUT/$1"
+}
+
+blm_conn_mgr_test() {
+    $CC $CFLAGS -I"$HERE/inc/ble" -I"$VENDOR_SRC" -DBLM_CONN_MANAGER_ENABLE=1 -DBLM_CONN_MGR_AUTO_BOND_EN=1 \
+        -o "$OUT/$1" "$HERE/blm_conn_mgr_test.c" "$VENDOR_SRC/blm_conn_manager.c"
+    "$OUT/$1"
+}
+
+# a small ring, so the dump both overflows and crosses the 27 bit tick wrap
+dbg_trace_test() {
+    $CC $CFLAGS -I"$HERE/inc/ble" -I"$VENDOR_SRC" -DBLT_DBG_TRACE_ENABLE=1 -DBLT_DBG_TRACE_BUF_NUM=256 \
+        -o "$OUT/$1" "$HERE/dbg_trace_test.c" "$VENDOR_SRC/blt_dbg_trace.c"
+    "$OUT/$1" "$OUT/dbg_trace.bin" "$OUT/dbg_trace.txt"
+    python3 "$HERE/dbg_trace2vcd_test.py" "$OUT/dbg_trace.bin" "$OUT/dbg_trace.txt" "$OUT"
+}
+
+blt_led_engine_test() {
+    $CC $CFLAGS -I"$HERE/inc/ble" -I"$VENDOR_SRC" -DBLT_LED_ENGINE_ENABLE=1 -DBLT_SOFTWARE_TIMER_ENABLE=1 \
+        -o "$OUT/$1" "$HERE/blt_led_engine_test.c" "$VENDOR_SRC/blt_led_engine.c" "$VENDOR_SRC/blt_soft_timer.c"
+    "$OUT/$1"
+}
+
+# same port, cross port both ways, and the highest port
+software_pa_test() {
+    for pins in "GPIO_PB2 GPIO_PB3" "GPIO_PB2 GPIO_PD5" "GPIO_PD5 GPIO_PA0" "GPIO_PE7 GPIO_PE0"; do
+        set -- $1 $pins
+        $CC $CFLAGS -include "$HERE/inc/software_pa_stub.h" -DPA_ENABLE=1 -DPA_TXEN_PIN=$2 -DPA_RXEN_PIN=$3 \
+            -I"$EXT_DRIVER_SRC" -I"$ROOT/b91/b91_ble_sdk/common" -o "$OUT/$1" "$HERE/software_pa_test.c" "$EXT_DRIVER_SRC/software_pa.c"
+        "$OUT/$1"
+    done
+}
+
+pm_retention_test() {
+    $CC $CFLAGS -include "$HERE/inc/pm_retention_stub.h" -I"$EXT_DRIVER_SRC" -I"$ROOT/b91/b91_ble_sdk/common" \
+        -o "$OUT/$1" "$HERE/pm_retention_test.c" "$EXT_DRIVER_SRC/pm_retention.c"
+    "$OUT/$1"
+}
+
+# file calls and modelled flash reads per record read, the littlefs backend is modelled by hal_file_shim.c
+hal_file_bench() {
+    $CC $CFLAGS $HAL_FILE_INC -include "$HERE/inc/hal_file_stub.h" -c -o "$OUT/hal_file.o" "$HAL_FILE_DIR/src/hal_file.c"
+    $CC $CFLAGS $HAL_FILE_INC -o "$OUT/$1" "$HERE/hal_file_bench.c" "$HERE/hal_file_shim.c" "$OUT/hal_file.o"
+    "$OUT/$1"
+}
+
+# threads on the handle table, under ASan/UBSan and under TSan
+hal_file_test() {
+    for san in address,undefined thread; do
+        flags=$(echo "$CFLAGS" | sed "s/-fsanitize=[^ ]*/-fsanitize=$san/")
+        $CC $flags $HAL_FILE_INC -include "$HERE/inc/hal_file_stub.h" -c -o "$OUT/hal_file_$san.o" "$HAL_FILE_DIR/src/hal_file.c"
+        $CC $flags $HAL_FILE_INC -pthread -o "$OUT/$1_$san" "$HERE/hal_file_test.c" "$HERE/hal_file_shim.c" "$OUT/hal_file_$san.o"
+        "$OUT/$1_$san"
+    done
+}
+
+# the image is made by the real packer and mapped from the file
+assetfs_test() {
+    $CC $CFLAGS -I"$HERE/inc" -I"$LITEOS_INC" -o "$OUT/$1" "$HERE/assetfs_test.c" "$LITEOS_SRC/assetfs.c"
+    rm -rf "$OUT/assets" && mkdir "$OUT/assets"
+    "$OUT/$1" gen "$OUT/assets"
+    python3 "$ROOT/util/assetfs_pack.py" "$OUT/assets" -o "$OUT/assets.bin"
+    "$OUT/$1" "$OUT/assets.bin"
+}
+
+TESTS=${*:-"logstore_test tsstore_test littlefs_xts_test flash_driver_test rc_32k_track_test lpc_monitor_test pm_wakeup_test gpio_debounce_test pin_mux_test gpio_default_test string_opt_test fpu_stats_test blm_conn_mgr_test dbg_trace_test software_pa_test blt_led_engine_test pm_retention_test hal_file_bench hal_file_test assetfs_test"}
+for t in $TESTS; do
+    $t $t
+done
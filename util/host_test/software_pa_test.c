@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of the precomputed PA switching in ext_driver/software_pa.c. run.sh builds it for a same port pin pair,
+ * two cross port pairs and a pair on the highest port. For every PA state, from random register contents, the
+ * writes of app_rf_pa_handler must give what the per pin gpio_* calls gave: both pins driven, every other bit of
+ * the ports untouched. Same port pairs switch with one write, cross port pairs with two, the pin being switched off
+ * first, so both pins are never on together.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "software_pa.h"
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define PORT(pin)    ((pin) >> 8)
+#define OEN_OFF(pin) (2 + PORT(pin) * 8) /* output enable, active low */
+#define OUT_OFF(pin) (3 + PORT(pin) * 8)
+
+extern pa_switch_t pa_switch[PA_TYPE_NUM];
+extern rf_pa_callback_t blc_rf_pa_cb;
+void app_rf_pa_handler(int type);
+
+unsigned char g_gpioReg[GPIO_REG_SIZE];
+static unsigned int g_rand = 3;
+
+void gpio_set_func(gpio_pin_e pin, gpio_func_e func)
+{
+    CHECK(func == AS_GPIO);
+}
+
+void gpio_set_output_en(gpio_pin_e pin, unsigned int value)
+{
+    if (value) {
+        g_gpioReg[OEN_OFF(pin)] &= ~(pin & 0xff);
+    } else {
+        g_gpioReg[OEN_OFF(pin)] |= pin & 0xff;
+    }
+}
+
+void gpio_write(gpio_pin_e pin, unsigned int value)
+{
+    if (value) {
+        g_gpioReg[OUT_OFF(pin)] |= pin & 0xff;
+    } else {
+        g_gpioReg[OUT_OFF(pin)] &= ~(pin & 0xff);
+    }
+}
+
+void rf_set_rffe_pin(rf_pa_tx_pin_e tx_pin, rf_lna_rx_pin_e rx_pin)
+{
+    CHECK(0);
+}
+
+static unsigned int Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+static void RandomRegs(void)
+{
+    for (unsigned int i = 0; i < sizeof(g_gpioReg); i++) {
+        g_gpioReg[i] = (unsigned char)Rand();
+    }
+}
+
+static int PinOff(const unsigned char *reg, gpio_pin_e pin)
+{
+    return (reg[OEN_OFF(pin)] & (pin & 0xff)) && !(reg[OUT_OFF(pin)] & (pin & 0xff));
+}
+
+/* the old handler: gpio_set_output_en and gpio_write on each pin, the pin being switched off first */
+static void Reference(int type)
+{
+    gpio_pin_e off = (type == PA_TYPE_TX_ON) ? PA_RXEN_PIN : PA_TXEN_PIN;
+    gpio_pin_e on = (type == PA_TYPE_TX_ON) ? PA_TXEN_PIN : PA_RXEN_PIN;
+
+    gpio_set_output_en(off, 0);
+    gpio_write(off, 0);
+    if (type == PA_TYPE_OFF) {
+        gpio_set_output_en(on, 0);
+        gpio_write(on, 0);
+    } else {
+        gpio_set_output_en(on, 1);
+        gpio_write(on, 1);
+    }
+}
+
+static void ApplyOp(unsigned char *reg, const pa_reg_op_t *op)
+{
+    unsigned int off = (unsigned int)((volatile unsigned char *)op->reg - g_gpioReg);
+    unsigned short v = (unsigned short)(reg[off] | (reg[off + 1] << 8));
+
+    CHECK(off + 1 < GPIO_REG_SIZE && (off & 7) == 2);
+    v = (v & ~op->clr) | op->set;
+    reg[off] = (unsigned char)v;
+    reg[off + 1] = (unsigned char)(v >> 8);
+}
+
+/* the precomputed writes one at a time, then the handler itself, against the old per pin calls */
+static void CheckType(int type, int handlerType)
+{
+    const pa_switch_t *sw = &pa_switch[type];
+    unsigned char start[GPIO_REG_SIZE];
+    unsigned char expect[GPIO_REG_SIZE];
+    unsigned char step[GPIO_REG_SIZE];
+
+    CHECK(sw->num == ((PORT(PA_TXEN_PIN) == PORT(PA_RXEN_PIN)) ? 1 : 2));
+
+    for (int round = 0; round < 100; round++) {
+        RandomRegs();
+        memcpy(start, g_gpioReg, sizeof(start));
+        Reference(type);
+        memcpy(expect, g_gpioReg, sizeof(expect));
+
+        /* the first write already switches off the pin that must be off */
+        memcpy(step, start, sizeof(step));
+        ApplyOp(step, &sw->op[0]);
+        if (type == PA_TYPE_TX_ON) {
+            CHECK(PinOff(step, PA_RXEN_PIN));
+        } else if (type == PA_TYPE_RX_ON) {
+            CHECK(PinOff(step, PA_TXEN_PIN));
+        }
+        if (sw->num > 1) {
+            ApplyOp(step, &sw->op[1]);
+        }
+        CHECK(memcmp(step, expect, sizeof(expect)) == 0);
+
+        memcpy(g_gpioReg, start, sizeof(start));
+        app_rf_pa_handler(handlerType);
+        CHECK(memcmp(g_gpioReg, expect, sizeof(expect)) == 0);
+    }
+}
+
+int main(void)
+{
+    RandomRegs();
+    rf_pa_init();
+    CHECK(blc_rf_pa_cb == app_rf_pa_handler);
+    CHECK(PinOff(g_gpioReg, PA_TXEN_PIN) && PinOff(g_gpioReg, PA_RXEN_PIN));
+
+    for (int type = 0; type < PA_TYPE_NUM; type++) {
+        CheckType(type, type);
+    }
+    CheckType(PA_TYPE_OFF, PA_TYPE_NUM); /* unknown types switch the PA off */
+
+    printf("software_pa_test: ok (TX pin 0x%03x, RX pin 0x%03x)\n", PA_TXEN_PIN, PA_RXEN_PIN);
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of liteos_m/src/string_opt.c against the host libc, for every destination and source alignment
+ * 0 ~ 7 and every size 0 ~ 99. The functions are called by their __wrap_ names, the link does not wrap here.
+ * The word loops may read up to 3 bytes past the end inside an aligned word, so string_opt.c is built without
+ * the sanitizer and the buffers keep a margin around the checked area.
+ * This is a correctness check only, host timings say nothing about the D25. There is no RV32 cycle benchmark,
+ * measure with the machine cycle counter (mcycle) on the board.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define ALIGN_MAX 8
+#define SIZE_LIMIT 100
+#define MARGIN    16
+#define BUF_SIZE  (MARGIN + ALIGN_MAX + SIZE_LIMIT + MARGIN)
+#define GUARD     0xEE
+
+void *__wrap_memcpy(void *restrict dst, const void *restrict src, size_t n);
+void *__wrap_memset(void *dst, int c, size_t n);
+int __wrap_memcmp(const void *a, const void *b, size_t n);
+size_t __wrap_strlen(const char *str);
+
+static _Alignas(8) uint8_t g_src[BUF_SIZE];
+static _Alignas(8) uint8_t g_dst[BUF_SIZE];
+static _Alignas(8) uint8_t g_expect[BUF_SIZE];
+
+static int Sign(int x)
+{
+    return (x > 0) - (x < 0);
+}
+
+static void FillSource(void)
+{
+    /* include 0x80 and 0x01, the bytes a broken zero byte test would take for 0 */
+    for (int i = 0; i < BUF_SIZE; i++) {
+        g_src[i] = (uint8_t)((i % 5 == 0) ? 0x80 : (i % 7 == 0) ? 0x01 : (i * 37 + 11));
+    }
+}
+
+static void TestMemcpy(void)
+{
+    FillSource();
+    for (int da = 0; da < ALIGN_MAX; da++) {
+        for (int sa = 0; sa < ALIGN_MAX; sa++) {
+            for (int n = 0; n < SIZE_LIMIT; n++) {
+                memset(g_dst, GUARD, sizeof(g_dst));
+                memset(g_expect, GUARD, sizeof(g_expect));
+                memcpy(&g_expect[MARGIN + da], &g_src[MARGIN + sa], n);
+                CHECK(__wrap_memcpy(&g_dst[MARGIN + da], &g_src[MARGIN + sa], n) == &g_dst[MARGIN + da]);
+                CHECK(memcmp(g_dst, g_expect, sizeof(g_dst)) == 0);
+            }
+        }
+    }
+}
+
+static void TestMemset(void)
+{
+    static const int values[] = { 0, 0x5A, 0xFF, 0x1A5, -1 };
+
+    for (uint32_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+        for (int da = 0; da < ALIGN_MAX; da++) {
+            for (int n = 0; n < SIZE_LIMIT; n++) {
+                memset(g_dst, GUARD, sizeof(g_dst));
+                memset(g_expect, GUARD, sizeof(g_expect));
+                memset(&g_expect[MARGIN + da], values[v], n);
+                CHECK(__wrap_memset(&g_dst[MARGIN + da], values[v], n) == &g_dst[MARGIN + da]);
+                CHECK(memcmp(g_dst, g_expect, sizeof(g_dst)) == 0);
+            }
+        }
+    }
+}
+
+/* equal ranges, then a difference at every position, with bytes that compare differently signed and unsigned */
+static void TestMemcmp(void)
+{
+    FillSource();
+    for (int da = 0; da < ALIGN_MAX; da++) {
+        for (int sa = 0; sa < ALIGN_MAX; sa++) {
+            for (int n = 0; n < SIZE_LIMIT; n++) {
+                uint8_t *a = &g_dst[MARGIN + da];
+                const uint8_t *b = &g_src[MARGIN + sa];
+
+                memcpy(a, b, n);
+                CHECK(__wrap_memcmp(a, b, n) == 0);
+                for (int i = 0; i < n; i++) {
+                    a[i] = (uint8_t)(b[i] ^ 0x81);
+                    CHECK(Sign(__wrap_memcmp(a, b, n)) == Sign(memcmp(a, b, n)));
+                    CHECK(Sign(__wrap_memcmp(b, a, n)) == Sign(memcmp(b, a, n)));
+                    a[i] = b[i];
+                }
+            }
+        }
+    }
+}
+
+static void TestStrlen(void)
+{
+    for (int sa = 0; sa < ALIGN_MAX; sa++) {
+        for (int n = 0; n < SIZE_LIMIT; n++) {
+            FillSource();
+            g_src[MARGIN + sa + n] = 0;
+            CHECK(__wrap_strlen((const char *)&g_src[MARGIN + sa]) == (size_t)n);
+        }
+    }
+}
+
+int main(void)
+{
+    TestMemcpy();
+    TestMemset();
+    TestMemcmp();
+    TestStrlen();
+    printf("string_opt_test: ok\n");
+
+    return 0;
+}
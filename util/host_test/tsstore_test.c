@@ -0,0 +1,350 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Host check of liteos_m/src/tsstore.c on the flash model: the encoded size of a periodic signal, queries
+ * against a plain array of the appended samples, extreme deltas, wrap around the sector ring and power loss.
+ * The benchmark prints the compression ratio and the query cost of three sensor-like signals; the query times
+ * are host times, only the flash bytes read carry over to the device.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <B91/flash.h>
+
+#include <tsstore.h>
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define SAMPLE_MAX 40000
+
+typedef struct {
+    uint32_t time;
+    int32_t value;
+} Sample;
+
+typedef struct {
+    Sample *buf;
+    uint32_t num;
+    uint32_t stopAfter; /* 0 to report everything */
+} QueryState;
+
+static TsStore g_ts;
+static Sample g_appended[SAMPLE_MAX];
+static uint32_t g_appendedNum;
+static Sample g_got[SAMPLE_MAX];
+static Sample g_expect[SAMPLE_MAX];
+static uint32_t g_rand = 1;
+
+static uint32_t Rand(void)
+{
+    g_rand = g_rand * 1103515245 + 12345;
+    return g_rand >> 8;
+}
+
+static void Append(uint32_t time, int32_t value)
+{
+    CHECK(TsStoreAppend(&g_ts, time, value) == 0);
+    CHECK(g_appendedNum < SAMPLE_MAX);
+    g_appended[g_appendedNum].time = time;
+    g_appended[g_appendedNum].value = value;
+    g_appendedNum++;
+}
+
+static int QueryCollect(uint32_t time, int32_t value, void *arg)
+{
+    QueryState *state = arg;
+
+    CHECK(state->num < SAMPLE_MAX);
+    state->buf[state->num].time = time;
+    state->buf[state->num].value = value;
+    state->num++;
+
+    return (state->stopAfter != 0) && (state->num == state->stopAfter);
+}
+
+static uint32_t Query(const TsStoreRange *range, uint32_t stopAfter)
+{
+    QueryState state = { g_got, 0, stopAfter };
+
+    CHECK(TsStoreQuery(&g_ts, range, QueryCollect, &state) == 0);
+
+    return state.num;
+}
+
+static uint32_t Expect(const TsStoreRange *range)
+{
+    uint32_t num = 0;
+
+    for (uint32_t i = 0; i < g_appendedNum; i++) {
+        const Sample *s = &g_appended[i];
+        if ((s->time >= range->timeBegin) && (s->time <= range->timeEnd) && (s->value >= range->valueLow) &&
+            (s->value <= range->valueHigh)) {
+            g_expect[num++] = *s;
+        }
+    }
+
+    return num;
+}
+
+/* without wrap the query returns exactly the matching samples, with wrap the newest of them */
+static void CheckQuery(const TsStoreRange *range, int wrapped)
+{
+    uint32_t got = Query(range, 0);
+    uint32_t expect = Expect(range);
+
+    if (wrapped) {
+        CHECK(got <= expect);
+        CHECK((got != 0) || (expect == 0) || (range->timeEnd != 0xFFFFFFFF));
+    } else {
+        CHECK(got == expect);
+    }
+    CHECK(memcmp(g_got, &g_expect[expect - got], got * sizeof(Sample)) == 0);
+}
+
+static void CheckRandomQueries(int wrapped)
+{
+    uint32_t timeMax = g_appended[g_appendedNum - 1].time;
+    TsStoreRange all = { 0, 0xFFFFFFFF, INT32_MIN, INT32_MAX };
+    TsStoreRange range;
+
+    CheckQuery(&all, wrapped);
+    for (int i = 0; i < 200; i++) {
+        range.timeBegin = Rand() % (timeMax + 1);
+        range.timeEnd = range.timeBegin + Rand() % (timeMax + 1);
+        range.valueLow = (int32_t)(Rand() % 2000) - 1000;
+        range.valueHigh = range.valueLow + (int32_t)(Rand() % 2000);
+        CheckQuery(&range, wrapped);
+    }
+}
+
+static void Reset(uint32_t sectorNum)
+{
+    flash_model_reset();
+    g_appendedNum = 0;
+    CHECK(TsStoreInit(&g_ts, TSSTORE_PHYS_ADDR, sectorNum) == 0);
+}
+
+/* a sample every 10 ticks changing by at most 1 takes 2 bytes */
+static void TestEncodingSize(void)
+{
+    int32_t value = 0;
+
+    Reset(TSSTORE_SECTOR_NUM);
+    for (uint32_t i = 0; i < 2000; i++) {
+        value += (int32_t)(Rand() % 3) - 1;
+        Append(1000 + i * 10, value);
+    }
+    CHECK(TsStoreFlush(&g_ts) == 0);
+    CHECK(g_ts.pages <= 2000 / ((TSSTORE_PAGE_SIZE - sizeof(TsStoreBlockHeader)) / 2) + 1);
+
+    CheckRandomQueries(0);
+    CHECK(TsStoreInit(&g_ts, TSSTORE_PHYS_ADDR, TSSTORE_SECTOR_NUM) == 0);
+    CheckRandomQueries(0);
+}
+
+/* jitter, repeated times, and deltas that need all 5 varint bytes */
+static void TestExtremeDeltas(void)
+{
+    static const int32_t values[] = { INT32_MIN, INT32_MAX, 0, -1, INT32_MIN, 1, INT32_MAX, INT32_MAX };
+    TsStoreRange all = { 0, 0xFFFFFFFF, INT32_MIN, INT32_MAX };
+    uint32_t time = 0;
+
+    Reset(TSSTORE_SECTOR_NUM);
+    for (uint32_t i = 0; i < 3000; i++) {
+        time += (i % 5 == 0) ? 0 : (i % 7 == 0) ? 0x7FFFFF : Rand() % 50;
+        Append(time, (i % 3 == 0) ? values[i % 8] : (int32_t)Rand() - 0x800000);
+    }
+    CHECK(TsStoreAppend(&g_ts, time - 1, 0) != 0);
+    CheckQuery(&all, 0);
+    CheckRandomQueries(0);
+
+    CHECK(TsStoreFlush(&g_ts) == 0);
+    CHECK(TsStoreInit(&g_ts, TSSTORE_PHYS_ADDR, TSSTORE_SECTOR_NUM) == 0);
+    CheckQuery(&all, 0);
+    /* the rescan restores the last time */
+    CHECK(TsStoreAppend(&g_ts, time - 1, 0) != 0);
+
+    /* the callback can stop a query */
+    CHECK(Query(&all, 17) == 17);
+    CHECK(memcmp(g_got, g_appended, 17 * sizeof(Sample)) == 0);
+}
+
+static void TestWrap(void)
+{
+    int32_t value = 0;
+
+    Reset(3);
+    for (uint32_t i = 0; i < 30000; i++) {
+        value += (int32_t)(Rand() % 21) - 10;
+        Append(i * 3 + Rand() % 3, value);
+    }
+    CHECK(g_ts.erases > 6);
+    CheckRandomQueries(1);
+
+    CHECK(TsStoreFlush(&g_ts) == 0);
+    CHECK(TsStoreInit(&g_ts, TSSTORE_PHYS_ADDR, 3) == 0);
+    CheckRandomQueries(1);
+}
+
+/* cut the power at every byte of one block program, the flushed blocks must survive the rescan */
+static void TestPowerLoss(void)
+{
+    TsStoreRange all = { 0, 0xFFFFFFFF, INT32_MIN, INT32_MAX };
+    uint32_t flushed;
+    uint32_t got;
+
+    for (uint32_t cut = 0; cut <= TSSTORE_PAGE_SIZE; cut++) {
+        Reset(2);
+        for (uint32_t i = 0; i < 100 * (cut % 4); i++) {
+            Append(i, (int32_t)(i * 3));
+        }
+        CHECK(TsStoreFlush(&g_ts) == 0);
+        flushed = g_appendedNum;
+
+        for (uint32_t i = 0; i < 50; i++) {
+            Append(1000 + i, (int32_t)i);
+        }
+        flash_model_power_cut(cut);
+        CHECK(TsStoreFlush(&g_ts) == 0);
+        (void)flash_model_power_on();
+
+        CHECK(TsStoreInit(&g_ts, TSSTORE_PHYS_ADDR, 2) == 0);
+        got = Query(&all, 0);
+        CHECK((got == flushed) || (got == g_appendedNum));
+        CHECK(memcmp(g_got, g_appended, got * sizeof(Sample)) == 0);
+
+        g_appendedNum = got;
+        for (uint32_t i = 0; i < 300; i++) {
+            Append(2000 + i, (int32_t)-i);
+        }
+        CHECK(TsStoreFlush(&g_ts) == 0);
+        CHECK(TsStoreInit(&g_ts, TSSTORE_PHYS_ADDR, 2) == 0);
+        CheckQuery(&all, 0);
+    }
+}
+
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* a temperature in 0.01 C every 60 s with jitter, a heart rate every 1 s, a 50 Hz accelerometer axis */
+static int32_t Signal(int kind, uint32_t i, uint32_t *time)
+{
+    static int32_t walk;
+
+    switch (kind) {
+        case 0:
+            *time += 58 + Rand() % 5;
+            walk += (int32_t)(Rand() % 7) - 3;
+            return 2200 + ((int32_t)(i % 1440) < 720 ? (int32_t)(i % 1440) : 1440 - (int32_t)(i % 1440)) + walk;
+        case 1:
+            *time += 1;
+            walk += (int32_t)(Rand() % 5) - 2;
+            walk = (walk < -30) ? -30 : (walk > 50) ? 50 : walk;
+            return 70 + walk;
+        default:
+            *time += 20;
+            return (int32_t)(Rand() % 1001) - 500 + ((i % 50 < 25) ? 2000 : -2000);
+    }
+}
+
+#define BENCH_SAMPLES 8000
+#define BENCH_QUERIES 200
+
+static void Benchmark(void)
+{
+    static const char *names[] = { "temperature", "heart rate", "accelerometer" };
+    TsStoreRange all = { 0, 0xFFFFFFFF, INT32_MIN, INT32_MAX };
+    TsStoreRange range;
+    uint32_t timeMax;
+    uint32_t time;
+    uint32_t bytes;
+    uint32_t narrowBytes;
+    uint64_t start;
+    uint64_t allNs;
+    uint64_t narrowNs;
+
+    for (int kind = 0; kind < 3; kind++) {
+        Reset(TSSTORE_SECTOR_NUM);
+        time = 0;
+        for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+            int32_t value = Signal(kind, i, &time);
+            Append(time, value);
+        }
+        CHECK(TsStoreFlush(&g_ts) == 0);
+        CheckQuery(&all, 0);
+        timeMax = time;
+
+        bytes = flash_model_read_bytes();
+        start = NowNs();
+        for (int i = 0; i < BENCH_QUERIES; i++) {
+            CHECK(Query(&all, 0) == BENCH_SAMPLES);
+        }
+        allNs = (NowNs() - start) / BENCH_QUERIES;
+        bytes = (flash_model_read_bytes() - bytes) / BENCH_QUERIES;
+
+        /* one hundredth of the time range, the block headers skip the rest */
+        narrowBytes = flash_model_read_bytes();
+        start = NowNs();
+        for (int i = 0; i < BENCH_QUERIES; i++) {
+            range.timeBegin = Rand() % (timeMax - timeMax / 100);
+            range.timeEnd = range.timeBegin + timeMax / 100;
+            range.valueLow = INT32_MIN;
+            range.valueHigh = INT32_MAX;
+            (void)Query(&range, 0);
+        }
+        narrowNs = (NowNs() - start) / BENCH_QUERIES;
+        narrowBytes = (flash_model_read_bytes() - narrowBytes) / BENCH_QUERIES;
+
+        printf("tsstore_test: %-13s %u samples in %u pages, %.2f bytes per sample, ratio %.1f : 1\n", names[kind],
+               (unsigned)BENCH_SAMPLES, (unsigned)g_ts.pages, g_ts.pages * (double)TSSTORE_PAGE_SIZE / BENCH_SAMPLES,
+               BENCH_SAMPLES * (double)sizeof(Sample) / (g_ts.pages * TSSTORE_PAGE_SIZE));
+        printf("tsstore_test: %-13s full query %u us, %u bytes read; 1%% query %u us, %u bytes read\n", names[kind],
+               (unsigned)(allNs / 1000), (unsigned)bytes, (unsigned)(narrowNs / 1000), (unsigned)narrowBytes);
+
+        /* a narrow query reads at most every header and the payload of the few blocks it overlaps */
+        CHECK(narrowBytes <= TSSTORE_SECTOR_NUM * (TSSTORE_SECTOR_SIZE / TSSTORE_PAGE_SIZE) *
+                                 sizeof(TsStoreBlockHeader) + 3 * TSSTORE_PAGE_SIZE);
+    }
+}
+
+int main(void)
+{
+    TestEncodingSize();
+    TestExtremeDeltas();
+    TestWrap();
+    TestPowerLoss();
+    Benchmark();
+    printf("tsstore_test: ok\n");
+
+    return 0;
+}